@@ -9,7 +9,11 @@ enum GLProgramAttributes {
 	ATTR_TEXCOORD = 8,
 	ATTR_TANGENT = 9,
 	ATTR_BITANGENT = 10,
-	ATTR_NORMAL = 11
+	ATTR_NORMAL = 11,
+
+	// The per-instance transform of the instancing program, a mat4 taking
+	// the four locations 12 to 15 (one per column)
+	ATTR_INSTANCE_TRANSFORM = 12
 };
 
 #endif /*GLPROGRAMATTRIBUTES_H_*/
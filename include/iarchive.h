@@ -35,6 +35,15 @@ public:
 	/// The stream may be read forwards until it is exhausted.
 	/// The stream remains valid for the lifetime of the file.
 	virtual InputStream& getInputStream() = 0;
+	/// \brief Returns the whole file data as a contiguous block of size() bytes,
+	/// if the file can provide it without copying (e.g. uncompressed files in
+	/// memory-mapped archives). Returns nullptr otherwise, clients need to fall
+	/// back to getInputStream() in that case.
+	/// The data is not null-terminated and remains valid for the lifetime of the file.
+	virtual const unsigned char* getData()
+	{
+		return nullptr;
+	}
 };
 typedef std::shared_ptr<ArchiveFile> ArchiveFilePtr;
 
@@ -31,6 +31,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "imodule.h"
 #include "math/Vector3.h"
+#include "string/InternedString.h"
 
 #include <vector>
 #include <list>
@@ -58,11 +59,10 @@ private:
      */
     typedef std::shared_ptr<std::string> StringPtr;
 
-    // Reference to the name string
-    StringPtr _typeRef;
-
-    // Reference to the name string
-    StringPtr _nameRef;
+    // The type and name strings are interned, there are only a few
+    // hundred distinct ones among all the entity class attributes
+    string::InternedString _type;
+    string::InternedString _name;
 
     // Reference to the attribute value string
     StringPtr _valueRef;
@@ -76,33 +76,28 @@ public:
      */
     const std::string& getType() const
     {
-        return *_typeRef;
-    }
-
-    const StringPtr& getTypeRef() const
-    {
-        return _typeRef;
+        return _type.str();
     }
 
-    void setType(const std::string& type)
+    const string::InternedString& getTypeRef() const
     {
-        _typeRef.reset(new std::string(type));
+        return _type;
     }
 
-    void setType(const StringPtr& typeRef)
+    void setType(const string::InternedString& type)
     {
-        _typeRef = typeRef;
+        _type = type;
     }
 
     /// The attribute key name, e.g. "model", "editor_displayFolder" etc
     const std::string& getName() const
     {
-        return *_nameRef;
+        return _name.str();
     }
 
-    const StringPtr& getNameRef() const
+    const string::InternedString& getNameRef() const
     {
-        return _nameRef;
+        return _name;
     }
 
     /**
@@ -170,8 +165,8 @@ public:
                          const std::string& name_,
                          const std::string& value_, 
                          const std::string& description_ = "")
-    : _typeRef(new std::string(type_)),
-      _nameRef(new std::string(name_)),
+    : _type(type_),
+      _name(name_),
       _valueRef(new std::string(value_)),
       _descRef(new std::string(description_)),
       inherited(false)
@@ -184,8 +179,8 @@ public:
      * copy the actual instance values.
      */
     EntityClassAttribute(const EntityClassAttribute& parentAttr, bool inherited_)
-    : _typeRef(parentAttr._typeRef),    // take type string,
-      _nameRef(parentAttr._nameRef),    // name string,
+    : _type(parentAttr._type),          // take type string,
+      _name(parentAttr._name),          // name string,
       _valueRef(parentAttr._valueRef),  // value string 
       _descRef(parentAttr._descRef),    // and description from the parent attribute
       inherited(inherited_)
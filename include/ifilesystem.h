@@ -146,6 +146,10 @@ public:
 	/// \brief Shuts down the filesystem.
 	virtual void shutdown() = 0;
 
+	// Sets the read-ahead buffer size (in bytes) of the files opened from pak files.
+	// This applies to the archives loaded by the next call to initialise().
+	virtual void setArchiveReadBufferSize(std::size_t size) = 0;
+
 	// greebo: Adds/removes observers to/from the VFS
 	virtual void addObserver(Observer& observer) = 0;
 	virtual void removeObserver(Observer& observer) = 0;
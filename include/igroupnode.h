@@ -1,6 +1,7 @@
 #pragma once
 
 #include "inode.h"
+#include "math/Vector3.h"
 
 namespace scene
 {
@@ -22,6 +23,12 @@ public:
 	 */
 	virtual void addOriginToChildren() = 0;
 	virtual void removeOriginFromChildren() = 0;
+
+	/** Returns the translation removeOriginFromChildren() would
+	 * apply to the child brushes, without touching them. This is used to
+	 * export the children relative to the origin while leaving the scene alone.
+	 */
+	virtual Vector3 getChildTranslationForExport() const = 0;
 };
 typedef std::shared_ptr<GroupNode> GroupNodePtr;
 
@@ -119,6 +119,19 @@ public:
 	// Patch export methods
 	virtual void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) = 0;
 	virtual void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) = 0;
+
+	/**
+	 * Optional: returns a new writer of the same kind, which is used to write
+	 * the entity with the given number (counted from the start of the map)
+	 * including its primitives to a separate stream, possibly on a worker thread.
+	 * The output needs to be the same as if this writer had written that entity
+	 * in sequence. The default implementation returns an empty pointer, in which
+	 * case all entities are written by this writer.
+	 */
+	virtual std::shared_ptr<IMapWriter> createEntityWriter(std::size_t entityNum) const
+	{
+		return std::shared_ptr<IMapWriter>();
+	}
 };
 typedef std::shared_ptr<IMapWriter> IMapWriterPtr;
 
@@ -214,6 +214,18 @@ public:
 		// Empty default implementation
 	}
 
+	/**
+	 * Returns true if initialiseModule() may be called on a worker thread,
+	 * while other modules are being initialised at the same time. Such a
+	 * module must not touch any UI or OpenGL state during initialisation and
+	 * must only use the modules listed in getDependencies(). Modules returning
+	 * false (the default) are initialised on the main thread.
+	 */
+	virtual bool isInitialisationThreadSafe() const
+	{
+		return false;
+	}
+
 	// Internally queried by the ModuleRegistry. To protect against leftover
 	// binaries containing outdated moudles from being loaded and registered
 	// the compatibility level is compared with the one in the ModuleRegistry.
@@ -57,6 +57,40 @@ typedef std::shared_ptr<IMapRootNode> IMapRootNodePtr;
 class Graph;
 typedef std::shared_ptr<Graph> GraphPtr;
 
+class ISPNode;
+class ISpacePartitionSystem;
+
+/**
+ * Handle stored on each node by the space partition system it is
+ * linked into. It allows an ISpacePartitionSystem to locate the node
+ * within its member arrays in constant time. The contents are owned and
+ * maintained by the space partition, nodes just provide the storage.
+ */
+struct SpacePartitionSlot
+{
+	// The space partition system this node is linked into (NULL if unlinked)
+	const ISpacePartitionSystem* owner;
+
+	// The partition node hosting this node
+	ISPNode* node;
+
+	// The position within the partition node's member array
+	std::size_t index;
+
+	SpacePartitionSlot() :
+		owner(nullptr),
+		node(nullptr),
+		index(0)
+	{}
+
+	void clear()
+	{
+		owner = nullptr;
+		node = nullptr;
+		index = 0;
+	}
+};
+
 class NodeVisitor
 {
 public:
@@ -244,6 +278,10 @@ public:
     
     // Called during recursive transform changed, but only by INodes themselves
     virtual void transformChangedLocal() = 0;
+
+	// Returns the storage used by the space partition system to keep track
+	// of where this node is linked. Not to be touched by anyone else.
+	virtual SpacePartitionSlot& getSpacePartitionSlot() = 0;
 };
 
 } // namespace scene
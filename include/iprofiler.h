@@ -0,0 +1,142 @@
+#pragma once
+
+#include "imodule.h"
+
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <ostream>
+
+const std::string MODULE_PROFILER("Profiler");
+
+namespace profile
+{
+
+/**
+ * The profiler collects named timing spans from all threads, like
+ * the initialisation of each module, the def loaders, the phases of map
+ * loading or the rendered frames. Spans can be nested, the ones opened
+ * while another one is running on the same thread are its children.
+ *
+ * The collected spans can be written in the Chrome trace-event format
+ * (to be opened in chrome://tracing or Perfetto) or summarised per name.
+ *
+ * Recording is enabled until all modules have been initialised, afterwards
+ * it can be switched on through the registry or the ProfilerToggle command.
+ *
+ * Use the ScopedSpan helper to record spans.
+ */
+class IProfiler :
+	public RegisterableModule
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	// Spans are only recorded while the profiler is enabled, this is safe
+	// to call from any thread and doesn't block
+	virtual bool isEnabled() const = 0;
+	virtual void setEnabled(bool enabled) = 0;
+
+	// Opens a span on the calling thread, returns the handle to close it with
+	virtual std::size_t beginSpan(const std::string& name, const std::string& category) = 0;
+
+	// Closes the span opened by beginSpan() on the same thread
+	virtual void endSpan(std::size_t handle) = 0;
+
+	// Records an already finished span, as if it had been run on the calling thread
+	virtual void recordSpan(const std::string& name, const std::string& category,
+		Clock::time_point start, Clock::time_point end) = 0;
+
+	// Removes all spans recorded so far
+	virtual void clear() = 0;
+
+	// Writes all spans as Chrome trace-event JSON
+	virtual void writeChromeTrace(std::ostream& stream) = 0;
+
+	// Writes a table with the count, total, average and maximum time
+	// of the spans, grouped by category and name
+	virtual void writeSummary(std::ostream& stream) = 0;
+};
+typedef std::shared_ptr<IProfiler> IProfilerPtr;
+
+// Returns the profiler or nullptr, if it is not available (yet).
+// The module is looked up once, it stays alive until the modules are unloaded at exit.
+inline IProfiler* findProfiler()
+{
+	static std::atomic<IProfiler*> _profiler(nullptr);
+
+	IProfiler* profiler = _profiler.load(std::memory_order_acquire);
+
+	if (profiler != nullptr)
+	{
+		return profiler;
+	}
+
+	static std::mutex _lock;
+	std::lock_guard<std::mutex> lock(_lock);
+
+	profiler = _profiler.load(std::memory_order_relaxed);
+
+	if (profiler == nullptr && module::GlobalModuleRegistry().moduleExists(MODULE_PROFILER))
+	{
+		profiler = static_cast<IProfiler*>(
+			module::GlobalModuleRegistry().getModule(MODULE_PROFILER).get());
+
+		_profiler.store(profiler, std::memory_order_release);
+	}
+
+	return profiler;
+}
+
+/**
+ * Records a span covering the lifetime of this object, provided the
+ * profiler module is available and enabled at construction time.
+ * Otherwise this does nothing, the name is not even converted.
+ */
+class ScopedSpan
+{
+private:
+	IProfiler* _profiler;
+	std::size_t _handle;
+
+public:
+	ScopedSpan(const char* name, const char* category = "default") :
+		_profiler(nullptr),
+		_handle(0)
+	{
+		begin(name, category);
+	}
+
+	ScopedSpan(const std::string& name, const char* category = "default") :
+		_profiler(nullptr),
+		_handle(0)
+	{
+		begin(name, category);
+	}
+
+	~ScopedSpan()
+	{
+		if (_profiler)
+		{
+			_profiler->endSpan(_handle);
+		}
+	}
+
+	ScopedSpan(const ScopedSpan& other) = delete;
+	ScopedSpan& operator=(const ScopedSpan& other) = delete;
+
+private:
+	template<typename Name>
+	void begin(const Name& name, const char* category)
+	{
+		IProfiler* profiler = findProfiler();
+
+		if (profiler && profiler->isEnabled())
+		{
+			_profiler = profiler;
+			_handle = _profiler->beginSpan(name, category);
+		}
+	}
+};
+
+}
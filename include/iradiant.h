@@ -7,8 +7,6 @@
 
 const std::string MODULE_RADIANT("Radiant");
 
-class ThreadManager;
-
 /**
  * \brief
  * Interface to the core application.
@@ -23,9 +21,6 @@ public:
 
     /// Signal emitted just before Radiant shuts down
     virtual sigc::signal<void> signal_radiantShutdown() const = 0;
-
-    /// Get the threading manager
-    virtual ThreadManager& getThreadManager() = 0;
 };
 
 inline IRadiant& GlobalRadiant()
@@ -2,6 +2,7 @@
 
 #include "imodule.h"
 #include <functional>
+#include <vector>
 
 #include "math/Vector3.h"
 
@@ -388,6 +389,10 @@ public:
  * No GL state changes should occur in render(), other than those specifically
  * allowed by the render flags.
  */
+class OpenGLRenderBatch;
+class OpenGLInstancedGeometry;
+class RenderStream;
+
 class OpenGLRenderable
 {
 public:
@@ -398,6 +403,147 @@ public:
      * Submit OpenGL render calls.
      */
     virtual void render(const RenderInfo& info) const = 0;
+
+    /**
+     * \brief
+     * Return the batch this renderable can be drawn with, or nullptr.
+     *
+     * Renderables returning the same batch, which are submitted in a row with
+     * the same transform and light, are handed to the batch to be drawn in one
+     * go instead of calling render() on each of them.
+     */
+    virtual const OpenGLRenderBatch* getRenderBatch() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * \brief
+     * Write the geometry to the given stream instead of rendering it.
+     *
+     * The backend collects the geometry of the renderables sharing a pass,
+     * render entity, transform and light and draws it in a few calls.
+     * Renderables not able to express themselves as plain vertex arrays
+     * return false (the default), render() is called for them instead.
+     */
+    virtual bool writeToStream(const RenderInfo& info, RenderStream& stream) const
+    {
+        return false;
+    }
+
+    /**
+     * \brief
+     * Return the geometry drawn by render() if it is shared with other
+     * renderables, like the surfaces of the copies of a model, or nullptr.
+     *
+     * The renderables of a pass returning the same geometry are drawn with
+     * a single instanced call, with their transforms passed per instance.
+     * Renderables changing their geometry per instance (animated or scaled
+     * models) must not share it with others.
+     */
+    virtual const OpenGLInstancedGeometry* getInstancedGeometry() const
+    {
+        return nullptr;
+    }
+};
+
+/**
+ * \brief
+ * Receiver of the geometry written by OpenGLRenderable::writeToStream().
+ */
+class RenderStream
+{
+public:
+    // The compact vertex format, used by passes submitting positions and
+    // colours only
+    struct Vertex
+    {
+        float vertex[3];
+        unsigned char colour[4];
+    };
+
+    // The full vertex format, for passes using texture coordinates or normals
+    struct FullVertex
+    {
+        float vertex[3];
+        unsigned char colour[4];
+        float texcoord[2];
+        float normal[3];
+        float tangent[3];
+        float bitangent[3];
+    };
+
+    virtual ~RenderStream() {}
+
+    /**
+     * \brief
+     * Return true if passes with the given render flags are submitting
+     * texture coordinates or normals. Their geometry needs to be written
+     * with addFullPrimitive(), addPrimitive() is for all other passes.
+     */
+    static bool needsFullVertices(const RenderInfo& info)
+    {
+        // Cube maps use the vertex position as texture coordinate
+        return !info.checkFlag(RENDER_TEXTURE_CUBEMAP) &&
+            (info.checkFlag(RENDER_BUMP) || info.checkFlag(RENDER_LIGHTING) ||
+             info.checkFlag(RENDER_TEXTURE_2D));
+    }
+
+    /**
+     * \brief
+     * Add a primitive of the given GL mode (GL_POLYGON, GL_LINES etc.) and
+     * return the given number of vertices to be filled in by the caller.
+     *
+     * \param useColours
+     * True if the vertex colours should be submitted, otherwise the current
+     * GL colour is used.
+     */
+    virtual Vertex* addPrimitive(unsigned int mode, std::size_t numVertices, bool useColours) = 0;
+
+    /**
+     * \brief
+     * Like addPrimitive(), returning vertices in the full format.
+     */
+    virtual FullVertex* addFullPrimitive(unsigned int mode, std::size_t numVertices, bool useColours) = 0;
+};
+
+/**
+ * \brief
+ * Draws a number of renderables at once, usually because they keep their
+ * geometry in the same buffer objects. See OpenGLRenderable::getRenderBatch().
+ */
+class OpenGLRenderBatch
+{
+public:
+    virtual ~OpenGLRenderBatch() {}
+
+    /**
+     * \brief
+     * Submit the OpenGL render calls for all the given renderables, each of
+     * which returned this batch from getRenderBatch().
+     */
+    virtual void renderBatch(const RenderInfo& info,
+                             const std::vector<const OpenGLRenderable*>& renderables) const = 0;
+};
+
+/**
+ * \brief
+ * Geometry which can be drawn many times with a single call, once for each
+ * renderable sharing it. See OpenGLRenderable::getInstancedGeometry().
+ */
+class OpenGLInstancedGeometry
+{
+public:
+    virtual ~OpenGLInstancedGeometry() {}
+
+    /**
+     * \brief
+     * Submit the geometry with a single call drawing the given number of
+     * instances. The arrays are set up as in OpenGLRenderable::render(), the
+     * backend has taken care of the per-instance transforms. This is only
+     * called for passes without GL programs.
+     */
+    virtual void renderInstances(const RenderInfo& info, std::size_t numInstances) const = 0;
 };
 
 class Matrix4;
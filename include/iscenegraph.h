@@ -26,6 +26,24 @@ namespace scene
 class ISpacePartitionSystem;
 typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
 
+/**
+ * Remembers which scene nodes have been found in a certain view volume.
+ * A cache is created by the scenegraph and kept by a view across redraws,
+ * the scenegraph keeps it up to date while nodes are inserted, removed or
+ * change their bounds. The set is rebuilt from scratch as soon as the
+ * matrices of the view volume change. Nodes are only tested against the
+ * view volume, occluded nodes are not removed from the set.
+ */
+class IVisibleSetCache
+{
+public:
+	virtual ~IVisibleSetCache() {}
+
+	// Discards the cached set, the next traversal will rebuild it
+	virtual void invalidate() = 0;
+};
+typedef std::shared_ptr<IVisibleSetCache> IVisibleSetCachePtr;
+
 /**
 * A scene-graph - a Directed Acyclic Graph (DAG).
 *
@@ -112,6 +130,15 @@ public:
 	// Same as above, but culls any hidden nodes
 	virtual void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) = 0;
 
+	// Creates a new visible set cache attached to this scenegraph
+	virtual IVisibleSetCachePtr createVisibleSetCache() = 0;
+
+	// Same as foreachVisibleNodeInVolume(), but re-uses the nodes collected in the given
+	// cache as long as the volume's matrices don't change. Only changed nodes are re-evaluated.
+	// The cache must have been created by this scenegraph.
+	virtual void foreachVisibleNodeInVolume(const VolumeTest& volume, IVisibleSetCache& cache,
+		const INode::VisitorFunc& functor) = 0;
+
 	// Returns the associated spacepartition
 	virtual ISpacePartitionSystemPtr getSpacePartition() = 0;
 };
@@ -1,7 +1,6 @@
 #ifndef _ISPACE_PARTITION_H_
 #define _ISPACE_PARTITION_H_
 
-#include <list>
 #include <vector>
 #include "imodule.h"
 
@@ -44,7 +43,7 @@ public:
 	typedef std::vector<ISPNodePtr> NodeList;
 
 	// The members
-	typedef std::list<INodePtr> MemberList;
+	typedef std::vector<INodePtr> MemberList;
 
 	// Get the parent node (can be NULL for the root node)
 	virtual ISPNodePtr getParent() const = 0;
@@ -90,6 +89,10 @@ public:
 
 	// Returns the root node of this SP tree (the largest one, encompassing everything)
 	virtual ISPNodePtr getRoot() const = 0;
+
+	// Returns the SP node the given scene node is linked to, or an empty pointer
+	// if the scene node is not linked into this tree
+	virtual ISPNodePtr getLinkedNode(const scene::INodePtr& sceneNode) const = 0;
 };
 typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
 
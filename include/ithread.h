@@ -1,22 +1,170 @@
 #pragma once
 
+#include "imodule.h"
+
 #include <functional>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <algorithm>
+
+const std::string MODULE_THREADMANAGER("ThreadManager");
 
 /**
  * \brief
  * Interface to the threading manager.
  *
- * The ThreadManager wraps a thread pool which is owned and managed by the
- * main Radiant application.
+ * The ThreadManager owns a process-wide pool of worker threads, one per core.
+ * Submitted tasks are queued and picked up by the next idle worker, idle
+ * workers steal from the queues of the busy ones. Tasks can submit further
+ * tasks, these are preferably executed by the same worker.
+ *
+ * A task must not block waiting for the result of a task which is queued
+ * behind it, as all workers might end up waiting. Use parallelForEach() for
+ * nested work, the calling thread keeps processing items until all are done.
+ *
+ * When the pool is shut down, the running tasks are finished and the queued
+ * ones are dropped without being run.
  */
-class ThreadManager
+class ThreadManager :
+	public RegisterableModule
 {
 public:
+	// Tasks posted from outside the pool are picked in the order of their
+	// priority, tasks posted by a running task go to its worker's own queue.
+	enum class Priority
+	{
+		High,
+		Normal,
+		Low,
+	};
 
-    /// Execute the given function in a separate thread
+	// Queues the given function for execution, returns immediately.
+	// If the pool has not been started yet, the function is executed right away,
+	// once it is shutting down the function is dropped.
+	virtual void post(std::function<void()> task, Priority priority = Priority::Normal) = 0;
+
+	// Returns the number of worker threads (0 if the pool is not running)
+	virtual std::size_t getNumWorkers() const = 0;
+
+	/// Execute the given function in a separate thread
 	/// Returns the thread id, which can be used to query the state
 	virtual std::size_t execute(std::function<void()> func) = 0;
 
 	// Returns true if the given thread is still running
 	virtual bool threadIsRunning(std::size_t threadId) = 0;
+
+	// Queues the given function, the returned future delivers its result
+	// (or rethrows the exception it has thrown). If the function is dropped
+	// on shutdown, the future throws a std::future_error (broken_promise).
+	template<typename Func>
+	auto submit(Func func, Priority priority = Priority::Normal) -> std::future<decltype(func())>
+	{
+		typedef decltype(func()) ReturnType;
+
+		auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::move(func));
+		std::future<ReturnType> result = task->get_future();
+
+		post([task]() { (*task)(); }, priority);
+
+		return result;
+	}
+
+	// Invokes the given function for the indices 0..count-1, spread over
+	// the workers. The calling thread is processing items too and returns
+	// when all of them are done. The first exception thrown by the function
+	// is passed on to the caller.
+	void parallelForEach(std::size_t count, const std::function<void(std::size_t)>& func,
+		Priority priority = Priority::Normal)
+	{
+		if (count == 0) return;
+
+		// Helpers might be started after all items are done, so they
+		// must not refer to anything on this stack
+		struct State
+		{
+			std::function<void(std::size_t)> func;
+			std::size_t count;
+			std::atomic<std::size_t> nextItem;
+			std::size_t itemsDone;
+			std::exception_ptr exception;
+			std::mutex lock;
+			std::condition_variable finished;
+		};
+
+		auto state = std::make_shared<State>();
+		state->func = func;
+		state->count = count;
+		state->nextItem = 0;
+		state->itemsDone = 0;
+
+		auto worker = [state]()
+		{
+			std::size_t itemsDone = 0;
+
+			for (std::size_t i = state->nextItem++; i < state->count; i = state->nextItem++)
+			{
+				try
+				{
+					state->func(i);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(state->lock);
+
+					if (!state->exception)
+					{
+						state->exception = std::current_exception();
+					}
+				}
+
+				++itemsDone;
+			}
+
+			if (itemsDone > 0)
+			{
+				std::lock_guard<std::mutex> lock(state->lock);
+
+				state->itemsDone += itemsDone;
+
+				if (state->itemsDone == state->count)
+				{
+					state->finished.notify_all();
+				}
+			}
+		};
+
+		std::size_t numHelpers = std::min(getNumWorkers(), count - 1);
+
+		for (std::size_t i = 0; i < numHelpers; ++i)
+		{
+			post(worker, priority);
+		}
+
+		worker();
+
+		// Wait for the items still being processed by the helpers
+		std::unique_lock<std::mutex> lock(state->lock);
+		state->finished.wait(lock, [&]() { return state->itemsDone == state->count; });
+
+		if (state->exception)
+		{
+			std::rethrow_exception(state->exception);
+		}
+	}
 };
+typedef std::shared_ptr<ThreadManager> ThreadManagerPtr;
+
+inline ThreadManager& GlobalThreadManager()
+{
+	// Cache the reference locally
+	static ThreadManager& _threadManager(
+		*std::static_pointer_cast<ThreadManager>(
+			module::GlobalModuleRegistry().getModule(MODULE_THREADMANAGER)
+		)
+	);
+	return _threadManager;
+}
@@ -0,0 +1,38 @@
+/// ============================================================================
+/// Vertex program used to draw many instances of a model in one call.
+/// The object transform of each instance is passed as per-instance attribute,
+/// everything else matches the fixed-function pipeline of the editor preview,
+/// including the default light of the camera view (GL_LIGHT0, directional,
+/// GL_COLOR_MATERIAL on ambient and diffuse). There's no fragment program,
+/// texturing is left to the fixed-function pipeline.
+/// ============================================================================
+
+#version 120
+
+attribute mat4		attr_InstanceTransform;
+
+uniform bool		u_lighting;
+
+void	main()
+{
+	// transform vertex position into world space, then into clip-space
+	gl_Position = gl_ModelViewProjectionMatrix * (attr_InstanceTransform * gl_Vertex);
+
+	// transform texcoords
+	gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+
+	if (u_lighting)
+	{
+		vec3 normal = normalize(gl_NormalMatrix * (mat3(attr_InstanceTransform) * gl_Normal));
+		vec3 lightDir = normalize(gl_LightSource[0].position.xyz);
+
+		vec4 light = gl_LightModel.ambient + gl_LightSource[0].ambient
+			+ max(dot(normal, lightDir), 0.0) * gl_LightSource[0].diffuse;
+
+		gl_FrontColor = vec4(clamp(gl_Color.rgb * light.rgb, 0.0, 1.0), gl_Color.a);
+	}
+	else
+	{
+		gl_FrontColor = gl_Color;
+	}
+}
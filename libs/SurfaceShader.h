@@ -6,6 +6,7 @@
 #include "util/Noncopyable.h"
 #include "irender.h"
 #include "shaderlib.h"
+#include "string/InternedString.h"
 
 /**
  * Encapsulates a GL ShaderPtr and keeps track whether this
@@ -18,8 +19,9 @@ class SurfaceShader :
 	public Shader::Observer
 {
 private:
-    // greebo: The name of the material
-    std::string _materialName;
+    // The name of the material, interned since
+    // the same few names are used by most of the faces
+    string::InternedString _materialName;
 
     RenderSystemPtr _renderSystem;
 
@@ -79,7 +81,7 @@ public:
     */
     const std::string& getMaterialName() const
     {
-        return _materialName;
+        return _materialName.str();
     }
 
     /**
@@ -88,12 +90,14 @@ public:
     */
     void setMaterialName(const std::string& name)
     {
+        string::InternedString newName(name);
+
         // return, if the shader is the same as the currently used
-        if (shader_equal(_materialName, name)) return;
+        if (_materialName.equalsNoCase(newName)) return;
 
         releaseShader();
 
-        _materialName = name;
+        _materialName = newName;
 
         captureShader();
     }
@@ -1,13 +1,21 @@
 #pragma once
 
+#include "ithread.h"
+#include "iprofiler.h"
+
 #include <future>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <memory>
 
 namespace util
 {
 
 /**
  * Helper class used to asynchronically parse/load def files in a separate thread.
+ * The loader is queued in the ThreadManager's worker pool, if its result is
+ * requested before a worker got to it, it is run by the requesting thread.
  *
  * The worker thread itself is ensured to be called in a thread-safe 
  * way (to prevent the worker from being invoked twice). Subsequent calls to 
@@ -24,14 +32,57 @@ class ThreadedDefLoader
 
     LoadFunction _loadFunc;
 
+    // Name of the profiling span recorded for each run
+    std::string _name;
+
+    // The load function is run exactly once, by whoever gets to it first:
+    // the pool worker or a thread waiting for the result
+    class LoadTask
+    {
+        std::packaged_task<ReturnType()> _task;
+        std::atomic_flag _claimed;
+        std::string _name;
+
+    public:
+        LoadTask(const LoadFunction& loadFunc, const std::string& name) :
+            _task(loadFunc),
+            _name(name)
+        {
+            _claimed.clear();
+        }
+
+        std::future<ReturnType> getFuture()
+        {
+            return _task.get_future();
+        }
+
+        void tryRun()
+        {
+            if (!_claimed.test_and_set())
+            {
+                profile::ScopedSpan span(_name, "loader");
+                _task();
+            }
+        }
+
+        // Prevents the task from being run, returns false if it has been claimed already
+        bool cancel()
+        {
+            return !_claimed.test_and_set();
+        }
+    };
+    typedef std::shared_ptr<LoadTask> LoadTaskPtr;
+
+    LoadTaskPtr _task;
     std::shared_future<ReturnType> _result;
     std::mutex _mutex;
 
     bool _loadingStarted;
 
 public:
-    ThreadedDefLoader(const LoadFunction& loadFunc) :
+    ThreadedDefLoader(const LoadFunction& loadFunc, const std::string& name = "ThreadedDefLoader") :
         _loadFunc(loadFunc),
+        _name(name),
         _loadingStarted(false)
     {}
 
@@ -46,6 +97,8 @@ public:
     // cannot be started a second time unless reset() is called.
     void start()
     {
+        std::lock_guard<std::mutex> lock(_mutex);
+
         ensureLoaderStarted();
     }
 
@@ -62,41 +115,60 @@ public:
     ReturnType get()
     {
         // Make sure we already started the loader
-        ensureLoaderStarted();
+        LoadTaskPtr task;
+        std::shared_future<ReturnType> result;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            ensureLoaderStarted();
+
+            task = _task;
+            result = _result;
+        }
+
+        // Don't wait for a worker to pick it up
+        task->tryRun();
 
         // Wait for the result or return if it's already done.
-        return _result.get();
+        return result.get();
     }
 
     // Resets the state of the loader to the state it had after construction.
-    // If a background thread has been started, this will block and wait for it to finish.
+    // A loader still waiting in the queue is cancelled, if it is already
+    // running this will block and wait for it to finish.
     void reset()
     {
         std::lock_guard<std::mutex> lock(_mutex);
 
-        // Wait for any running thread to finish
         if (_loadingStarted)
         {
             _loadingStarted = false;
 
-            if (_result.valid())
+            // Wait for a running loader to finish
+            if (!_task->cancel())
             {
-                _result.get();
+                _result.wait();
             }
 
+            _task.reset();
             _result = std::shared_future<ReturnType>();
         }
     }
 
 private:
+    // Must be called with the mutex locked
     void ensureLoaderStarted()
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-
         if (!_loadingStarted)
         {
             _loadingStarted = true;
-            _result = std::async(std::launch::async, _loadFunc);
+
+            _task = std::make_shared<LoadTask>(_loadFunc, _name);
+            _result = _task->getFuture().share();
+
+            LoadTaskPtr task = _task;
+            GlobalThreadManager().post([task]() { task->tryRun(); });
         }
     }
 };
@@ -324,6 +324,34 @@ public:
   {
     aabb_draw_wire(m_aabb);
   }
+
+  bool writeToStream(const RenderInfo& info, RenderStream& stream) const
+  {
+    // There are no texture coordinates or normals to stream
+    if (RenderStream::needsFullVertices(info)) return false;
+
+    static const unsigned int indices[24] = {
+      0, 1, 1, 2, 2, 3, 3, 0,
+      4, 5, 5, 6, 6, 7, 7, 4,
+      0, 4, 1, 5, 2, 6, 3, 7,
+    };
+
+    Vector3 points[8];
+    m_aabb.getCorners(points);
+
+    RenderStream::Vertex* vertex = stream.addPrimitive(GL_LINES, 24, false);
+
+    for (std::size_t i = 0; i < 24; ++i, ++vertex)
+    {
+      const Vector3& point = points[indices[i]];
+
+      vertex->vertex[0] = static_cast<float>(point.x());
+      vertex->vertex[1] = static_cast<float>(point.y());
+      vertex->vertex[2] = static_cast<float>(point.z());
+    }
+
+    return true;
+  }
 };
 
 /**
@@ -323,6 +323,9 @@ public:
 // A 2-element vector stored in double-precision floating-point.
 typedef BasicVector2<double> Vector2;
 
+// A 2-element vector stored in single-precision floating-point.
+typedef BasicVector2<float> Vector2f;
+
 // Stream insertion operator for a BasicVector2
 template<typename T>
 std::ostream& operator<<(std::ostream& st, BasicVector2<T> vec) {
@@ -60,6 +60,16 @@ public:
             _v[i] = array[i];
     }
 
+    /// Construct a BasicVector3 from one with a different element type, e.g. a
+    /// Vector3f for rendering out of a Vector3.
+    template<typename OtherElement>
+    explicit BasicVector3(const BasicVector3<OtherElement>& other)
+    {
+        _v[0] = static_cast<Element>(other.x());
+        _v[1] = static_cast<Element>(other.y());
+        _v[2] = static_cast<Element>(other.z());
+    }
+
     /**
      * Named constructor, returning a vector on the unit sphere for the given spherical coordinates.
      */
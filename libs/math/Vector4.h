@@ -44,6 +44,15 @@ public:
         _v[3] = w_;
     }
 
+    // Construct a BasicVector4 from one with a different element type
+    template<typename OtherElement>
+    explicit BasicVector4(const BasicVector4<OtherElement>& other) {
+        _v[0] = static_cast<Element>(other.x());
+        _v[1] = static_cast<Element>(other.y());
+        _v[2] = static_cast<Element>(other.z());
+        _v[3] = static_cast<Element>(other.w());
+    }
+
     // Construct a BasicVector4 out of a Vector3 plus a fourth argument
     BasicVector4(const BasicVector3<Element>& other, Element w_) {
         _v[0] = other.x();
@@ -43,6 +43,7 @@ namespace fs = boost::filesystem;
 
 #endif
 
+#include <cstdint>
 #include "string/predicate.h"
 
 namespace os
@@ -93,4 +94,22 @@ namespace os
 		return fs::change_extension(input, newExt).string();
 #endif
 	}
+
+	// Returns the last write time of the given file as number of clock ticks
+	// (which are only meaningful when compared to each other), or 0 on failure
+	inline std::int64_t getFileModificationTime(const std::string& path)
+	{
+		try
+		{
+#ifdef DR_USE_STD_FILESYSTEM
+			return static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count());
+#else
+			return static_cast<std::int64_t>(fs::last_write_time(path));
+#endif
+		}
+		catch (fs::filesystem_error&)
+		{
+			return 0;
+		}
+	}
 }
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <ios>
 #include <string>
+#include <string_view>
+#include <cstring>
 #include "string/tokeniser.h"
 
 namespace parser
@@ -612,4 +614,350 @@ public:
 	}
 };
 
+/**
+ * Specialisation of DefTokeniser working on a contiguous block of characters,
+ * like a file loaded into memory or the contents of a ScopedArchiveBuffer.
+ * Tokens are returned as std::string_view pointing right into that block, 
+ * which therefore needs to stay alive as long as the tokeniser is used.
+ *
+ * Tokenisation rules are the same as the ones of the DefTokeniserFunc. 
+ * Quoted tokens containing escape sequences or being continued by
+ * a backslash can't be represented by a view into the source, these are
+ * assembled in an internal buffer instead.
+ */
+template<>
+class BasicDefTokeniser<std::string_view> :
+	public DefTokeniser
+{
+private:
+    const char* _cur;
+    const char* _end;
+
+    const char* _delims;
+    const char* _keptDelims;
+
+    // The token to be returned next
+    std::string_view _token;
+    bool _hasToken;
+
+    // Storage for the tokens which had to be assembled. The returned view must
+    // remain valid while the next token is read, hence the two of them.
+    std::string _buffers[2];
+    std::size_t _currentBuffer;
+
+public:
+    /**
+     * Construct a DefTokeniser working on the given characters, and optionally
+     * a list of separators.
+     *
+     * @param str
+     * The characters to tokenise, these are not copied.
+     *
+     * @param delims
+     * The list of characters to use as delimiters.
+     *
+     * @param keptDelims
+     * String of characters to treat as delimiters but return as tokens in their
+     * own right.
+     */
+    BasicDefTokeniser(std::string_view str,
+                      const char* delims = WHITESPACE,
+                      const char* keptDelims = "{}()") :
+        _cur(str.data()),
+        _end(str.data() + str.size()),
+        _delims(delims),
+        _keptDelims(keptDelims),
+        _hasToken(false),
+        _currentBuffer(0)
+    {
+        advance();
+    }
+
+    bool hasMoreTokens() const override
+    {
+        return _hasToken;
+    }
+
+    /**
+     * Returns the next token, consuming it. The view remains valid until
+     * the next call to nextTokenView() or nextToken().
+     */
+    std::string_view nextTokenView()
+    {
+        if (!_hasToken)
+        {
+            throw ParseException("DefTokeniser: no more tokens");
+        }
+
+        std::string_view token = _token;
+        advance();
+
+        return token;
+    }
+
+    std::string nextToken() override
+    {
+        return std::string(nextTokenView());
+    }
+
+    std::string peek() const override
+    {
+        if (!_hasToken)
+        {
+            throw ParseException("DefTokeniser: no more tokens");
+        }
+
+        return std::string(_token);
+    }
+
+    // Compares the token in place, without copying it
+    void assertNextToken(const std::string& val) override
+    {
+        std::string_view tok = nextTokenView();
+
+        if (tok != val)
+        {
+            throw ParseException("DefTokeniser: Assertion failed: Required \""
+                                 + val + "\", found \"" + std::string(tok) + "\"");
+        }
+    }
+
+    void skipTokens(unsigned int n) override
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            nextTokenView();
+        }
+    }
+
+private:
+    bool isDelim(char c) const
+    {
+        return c != 0 && std::strchr(_delims, c) != nullptr;
+    }
+
+    bool isKeptDelim(char c) const
+    {
+        return c != 0 && std::strchr(_keptDelims, c) != nullptr;
+    }
+
+    // Moves on to the next token, updating _token and _hasToken
+    void advance()
+    {
+        _hasToken = false;
+
+        const char* tokenStart = nullptr;
+
+        while (_cur != _end)
+        {
+            char c = *_cur;
+
+            if (c == '/' && _end - _cur > 1 && (_cur[1] == '/' || _cur[1] == '*'))
+            {
+                skipComment();
+
+                // A comment ends the current token
+                if (tokenStart != nullptr)
+                {
+                    return;
+                }
+
+                continue;
+            }
+
+            if (tokenStart == nullptr)
+            {
+                if (isDelim(c))
+                {
+                    ++_cur;
+                    continue;
+                }
+
+                if (isKeptDelim(c))
+                {
+                    setToken(_cur, 1);
+                    ++_cur;
+                    return;
+                }
+
+                if (c == '"')
+                {
+                    ++_cur;
+                    readQuotedToken();
+                    return;
+                }
+
+                tokenStart = _cur;
+            }
+            else if (isDelim(c) || isKeptDelim(c) || c == '"')
+            {
+                // Don't consume the delimiter or the quote
+                return;
+            }
+
+            // A slash not starting a comment is only dropped if it's the last character
+            if (c == '/' && _end - _cur == 1)
+            {
+                ++_cur;
+                return;
+            }
+
+            ++_cur;
+            setToken(tokenStart, _cur - tokenStart);
+        }
+    }
+
+    void setToken(const char* start, std::size_t length)
+    {
+        _token = std::string_view(start, length);
+        _hasToken = true;
+    }
+
+    // Advances past the comment starting at the current position
+    void skipComment()
+    {
+        if (_cur[1] == '/')
+        {
+            // Comment lasts until the end of the line, inclusive
+            for (_cur += 2; _cur != _end; )
+            {
+                char c = *_cur++;
+
+                if (c == '\r' || c == '\n') break;
+            }
+        }
+        else
+        {
+            // Delimited comment, search for the closing sequence
+            for (_cur += 2; _cur != _end; ++_cur)
+            {
+                if (*_cur == '*' && _end - _cur > 1 && _cur[1] == '/')
+                {
+                    _cur += 2;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Reads the quoted token, the current position is right after the opening quote
+    void readQuotedToken()
+    {
+        const char* start = _cur;
+
+        // Fast path: no escapes and no continuation
+        while (_cur != _end && *_cur != '"' && *_cur != '\\')
+        {
+            ++_cur;
+        }
+
+        if (_cur == _end)
+        {
+            // Unterminated quote, return whatever we got
+            if (_cur != start) setToken(start, _cur - start);
+            return;
+        }
+
+        if (*_cur == '"' && !isContinued(_cur + 1))
+        {
+            std::size_t length = _cur - start;
+
+            ++_cur;
+            skipDelims();
+
+            // An empty quoted string at the end of the input doesn't count as token
+            if (length > 0 || _cur != _end)
+            {
+                setToken(start, length);
+            }
+
+            return;
+        }
+
+        // The token needs to be assembled
+        _currentBuffer ^= 1;
+        std::string& buffer = _buffers[_currentBuffer];
+        buffer.assign(start, _cur);
+
+        while (_cur != _end)
+        {
+            char c = *_cur++;
+
+            if (c == '"')
+            {
+                // Closing quote, check for a backslash indicating a continued string
+                skipDelims();
+
+                if (_cur == _end)
+                {
+                    break;
+                }
+
+                if (*_cur != '\\')
+                {
+                    _token = buffer;
+                    _hasToken = true;
+                    return;
+                }
+
+                ++_cur;
+                skipDelims();
+
+                if (_cur == _end)
+                {
+                    break;
+                }
+
+                if (*_cur != '"')
+                {
+                    throw ParseException("Could not find opening double quote after backslash.");
+                }
+
+                ++_cur;
+            }
+            else if (c == '\\')
+            {
+                if (_cur != _end)
+                {
+                    char escaped = *_cur++;
+
+                    switch (escaped)
+                    {
+                    case 'n': buffer += '\n'; break;
+                    case 't': buffer += '\t'; break;
+                    case '"': buffer += '"'; break;
+                    default: 
+                        buffer += '\\';
+                        buffer += escaped;
+                    }
+                }
+            }
+            else
+            {
+                buffer += c;
+            }
+        }
+
+        // End of input reached, the token is only valid if it's not empty
+        if (!buffer.empty())
+        {
+            _token = buffer;
+            _hasToken = true;
+        }
+    }
+
+    // Returns true if the given position is followed by a backslash, after any delimiters
+    bool isContinued(const char* pos) const
+    {
+        while (pos != _end && isDelim(*pos)) ++pos;
+
+        return pos != _end && *pos == '\\';
+    }
+
+    void skipDelims()
+    {
+        while (_cur != _end && isDelim(*_cur)) ++_cur;
+    }
+};
+
 } // namespace parser
@@ -188,6 +188,24 @@ inline void pointvertex_gl_array(const VertexCb* array)
 	glVertexPointer(3, GL_DOUBLE, sizeof(VertexCb), &array->vertex);
 }
 
+/// \brief Writes the given coloured vertices as one primitive to the stream.
+inline void pointvertex_write_to_stream(RenderStream& stream, GLenum mode, bool useColours,
+	const VertexCb* array, std::size_t count)
+{
+	RenderStream::Vertex* vertex = stream.addPrimitive(mode, count, useColours);
+
+	for (const VertexCb* i = array; i != array + count; ++i, ++vertex)
+	{
+		vertex->vertex[0] = static_cast<float>(i->vertex.x());
+		vertex->vertex[1] = static_cast<float>(i->vertex.y());
+		vertex->vertex[2] = static_cast<float>(i->vertex.z());
+		vertex->colour[0] = i->colour.r;
+		vertex->colour[1] = i->colour.g;
+		vertex->colour[2] = i->colour.b;
+		vertex->colour[3] = i->colour.a;
+	}
+}
+
 /// A renderable collection of coloured vertices
 class RenderablePointVector :
 	public OpenGLRenderable
@@ -229,6 +247,20 @@ public:
 		}
 	}
 
+	bool writeToStream(const RenderInfo& info, RenderStream& stream) const
+	{
+		// There are no texture coordinates or normals to stream
+		if (RenderStream::needsFullVertices(info)) return false;
+
+		if (_vector.empty()) return true;
+
+		bool enablePointColours = info.checkFlag(RENDER_VERTEX_COLOUR) ||
+			(info.checkFlag(RENDER_POINT_COLOUR) && _mode == GL_POINTS);
+
+		pointvertex_write_to_stream(stream, _mode, enablePointColours, &_vector.front(), _vector.size());
+		return true;
+	}
+
 	// Convenience method to set the colour of the whole array
 	void setColour(const Colour4b& colour)
 	{
@@ -311,6 +343,20 @@ public:
 			glDisableClientState(GL_COLOR_ARRAY);
 		}
 	}
+
+	bool writeToStream(const RenderInfo& info, RenderStream& stream) const
+	{
+		// There are no texture coordinates or normals to stream
+		if (RenderStream::needsFullVertices(info)) return false;
+
+		if (m_vertices.empty()) return true;
+
+		bool enableColours = info.checkFlag(RENDER_VERTEX_COLOUR)
+			|| (info.checkFlag(RENDER_POINT_COLOUR) && _mode == GL_POINTS);
+
+		pointvertex_write_to_stream(stream, _mode, enableColours, m_vertices.data(), m_vertices.size());
+		return true;
+	}
 };
 
 /// Renderable wrapper for a set of vertices and indices stored in other arrays
@@ -126,6 +126,10 @@ public:
             offsetof(ArbitraryMeshVertex, bitangent)
         );
     }
+
+    // The colour is double-precision, it can't be submitted as byte colour
+    static bool hasColour() { return false; }
+    static const void* COLOUR_OFFSET() { return 0; }
 };
 
 }
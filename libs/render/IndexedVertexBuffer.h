@@ -1,8 +1,13 @@
 #pragma once
 
 #include <GL/glew.h>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
 
 #include "GLProgramAttributes.h"
+#include "VBO.h"
+#include "VertexTraits.h"
 
 namespace render
 {
@@ -15,6 +20,10 @@ namespace render
  * indices into the vertex buffer which are rendered with glDrawElements. It
  * functions much like \a VertexBuffer except for indexed geometry rather than
  * raw vertex geometry.
+ *
+ * The vertices are submitted as GL_FLOAT, so Vertex_T must be a single
+ * precision type like Vector3f or MeshVertexf. The double-precision source
+ * vertices are converted once, when they are added to the buffer.
  */
 template<typename Vertex_T>
 class IndexedVertexBuffer
@@ -73,11 +82,23 @@ public:
      *
      * Unlike with VertexBuffer, adding vertices to an IndexedVertexBuffer does
      * not create a batch. It just adds vertices to the common vertex pool.
+     * The iterators may refer to any type Vertex_T can be constructed from.
      */
     template<typename Iter_T>
     void addVertices(Iter_T begin, Iter_T end)
     {
-        std::copy(begin, end, std::back_inserter(_vertices));
+        _vertices.reserve(_vertices.size() + std::distance(begin, end));
+
+        for (Iter_T i = begin; i != end; ++i)
+        {
+            _vertices.emplace_back(*i);
+        }
+    }
+
+    /// Add a single vertex to the common vertex pool
+    void addVertex(const Vertex_T& vertex)
+    {
+        _vertices.push_back(vertex);
     }
 
     /// Add a batch of indices
@@ -128,8 +149,18 @@ public:
      * rendering. If false, only regular normal vectors will be submitted. In
      * all cases the pointers will only be set if carried by the particular
      * vertex type.
+     *
+     * \param renderColour
+     * True if the vertex colours should be submitted, the colour array is
+     * enabled for the duration of this call.
+     *
+     * \param numInstances
+     * The number of instances drawn by each call, more than one requires
+     * ARB_draw_instanced. The per-instance data is up to the caller.
      */
-    void renderAllBatches(GLenum primitiveType, bool renderBump = false) const
+    void renderAllBatches(GLenum primitiveType, bool renderBump = false,
+                          bool renderColour = false,
+                          std::size_t numInstances = 1) const
     {
         if (_vertexVBO == 0 || _indexVBO == 0)
         {
@@ -141,7 +172,7 @@ public:
 
         // Vertex pointer includes whole vertex buffer
         const GLsizei STRIDE = sizeof(Vertex_T);
-        glVertexPointer(3, GL_DOUBLE, STRIDE, Traits::VERTEX_OFFSET());
+        glVertexPointer(3, GL_FLOAT, STRIDE, Traits::VERTEX_OFFSET());
 
         // Set other pointers as necessary
         if (Traits::hasTexCoord())
@@ -149,13 +180,13 @@ public:
             if (renderBump)
             {
                 glVertexAttribPointer(
-                    ATTR_TEXCOORD, 2, GL_DOUBLE, GL_FALSE,
+                    ATTR_TEXCOORD, 2, GL_FLOAT, GL_FALSE,
                     STRIDE, Traits::TEXCOORD_OFFSET()
                 );
             }
             else
             {
-                glTexCoordPointer(2, GL_DOUBLE, STRIDE,
+                glTexCoordPointer(2, GL_FLOAT, STRIDE,
                                   Traits::TEXCOORD_OFFSET());
             }
         }
@@ -164,34 +195,56 @@ public:
             if (renderBump)
             {
                 glVertexAttribPointer(
-                    ATTR_NORMAL, 3, GL_DOUBLE, GL_FALSE,
+                    ATTR_NORMAL, 3, GL_FLOAT, GL_FALSE,
                     STRIDE, Traits::NORMAL_OFFSET()
                 );
             }
             else
             {
-                glNormalPointer(GL_DOUBLE, STRIDE, Traits::NORMAL_OFFSET());
+                glNormalPointer(GL_FLOAT, STRIDE, Traits::NORMAL_OFFSET());
             }
         }
         if (Traits::hasTangents() && renderBump)
         {
-            glVertexAttribPointer(ATTR_TANGENT, 3, GL_DOUBLE, GL_FALSE,
+            glVertexAttribPointer(ATTR_TANGENT, 3, GL_FLOAT, GL_FALSE,
                                   STRIDE, Traits::TANGENT_OFFSET());
-            glVertexAttribPointer(ATTR_BITANGENT, 3, GL_DOUBLE, GL_FALSE,
+            glVertexAttribPointer(ATTR_BITANGENT, 3, GL_FLOAT, GL_FALSE,
                                   STRIDE, Traits::BITANGENT_OFFSET());
         }
 
+        const bool useColours = renderColour && Traits::hasColour();
+
+        if (useColours)
+        {
+            glEnableClientState(GL_COLOR_ARRAY);
+            glColorPointer(4, GL_UNSIGNED_BYTE, STRIDE, Traits::COLOUR_OFFSET());
+        }
+
         // Render each batch of indices
         for (typename std::vector<Batch>::const_iterator i = _batches.begin();
              i != _batches.end();
              ++i)
         {
-            glDrawElements(
-                primitiveType, GLint(i->size), RenderIndexTypeID,
-                reinterpret_cast<const GLvoid*>(
-                    i->start * sizeof(Indices::value_type)
-                )
+            const GLvoid* offset = reinterpret_cast<const GLvoid*>(
+                i->start * sizeof(Indices::value_type)
             );
+
+            if (numInstances == 1)
+            {
+                glDrawElements(primitiveType, GLint(i->size),
+                               RenderIndexTypeID, offset);
+            }
+            else
+            {
+                glDrawElementsInstancedARB(primitiveType, GLint(i->size),
+                                           RenderIndexTypeID, offset,
+                                           GLsizei(numInstances));
+            }
+        }
+
+        if (useColours)
+        {
+            glDisableClientState(GL_COLOR_ARRAY);
         }
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "irender.h"
+#include "IndexedVertexBuffer.h"
+#include "MeshVertexf.h"
+
+namespace render
+{
+
+/**
+ * The vertex buffer of a model surface (Pico models, MD5 meshes),
+ * holding its triangles. The copies of a model share the buffers of their
+ * surfaces, which allows the backend to draw all of them at once.
+ */
+class MeshVertexBuffer :
+    public IndexedVertexBuffer<MeshVertexf>,
+    public OpenGLInstancedGeometry
+{
+public:
+    /**
+     * Draw the triangles with the arrays required by the given render flags.
+     * The vertex colours are only submitted if renderColour is true.
+     */
+    void render(const RenderInfo& info, bool renderColour,
+                std::size_t numInstances = 1) const
+    {
+        bool renderBump = info.checkFlag(RENDER_BUMP);
+
+        if (!renderBump)
+        {
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+
+        renderAllBatches(GL_TRIANGLES, renderBump, renderColour, numInstances);
+
+        if (!renderBump)
+        {
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+    }
+
+    // OpenGLInstancedGeometry implementation
+    void renderInstances(const RenderInfo& info, std::size_t numInstances) const override
+    {
+        render(info, false, numInstances);
+    }
+};
+
+}
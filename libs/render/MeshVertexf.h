@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+
+#include "math/Vector2.h"
+#include "math/Vector3.h"
+#include "ArbitraryMeshVertex.h"
+#include "Colour4b.h"
+#include "VertexTraits.h"
+
+/**
+ * The single-precision counterpart of ArbitraryMeshVertex, this is
+ * what ends up in the vertex buffers. The geometry is built and edited in
+ * double precision, and converted to this format once, when it's handed
+ * over to a buffer. Half the size of an ArbitraryMeshVertex, and the driver
+ * doesn't have to convert GL_DOUBLE data when drawing.
+ */
+class MeshVertexf
+{
+public:
+	Vector3f	vertex;
+	Vector2f	texcoord;
+	Vector3f	normal;
+	Vector3f	tangent;
+	Vector3f	bitangent;
+
+	// Vertex colour
+	Colour4b	colour;
+
+	/// Default constructor, white colour
+	MeshVertexf() :
+		colour(255, 255, 255, 255)
+	{}
+
+	/// Conversion from the double-precision vertex
+	explicit MeshVertexf(const ArbitraryMeshVertex& other) :
+		vertex(other.vertex),
+		texcoord(other.texcoord),
+		normal(other.normal),
+		tangent(other.tangent),
+		bitangent(other.bitangent),
+		colour(toByte(other.colour.x()), toByte(other.colour.y()), toByte(other.colour.z()), 255)
+	{}
+
+private:
+	static unsigned char toByte(double value)
+	{
+		return value <= 0 ? 0 : value >= 1 ? 255 : static_cast<unsigned char>(value * 255 + 0.5);
+	}
+};
+
+namespace render
+{
+
+/// VertexTraits specialisation for MeshVertexf
+template<> class VertexTraits<MeshVertexf>
+{
+public:
+    static const void* VERTEX_OFFSET()
+    {
+        return reinterpret_cast<const void*>(
+            offsetof(MeshVertexf, vertex)
+        );
+    }
+
+    static bool hasNormal() { return true; }
+    static const void* NORMAL_OFFSET()
+    {
+        return reinterpret_cast<const void*>(
+            offsetof(MeshVertexf, normal)
+        );
+    }
+
+    static bool hasTexCoord() { return true; }
+    static const void* TEXCOORD_OFFSET()
+    {
+        return reinterpret_cast<const void*>(
+            offsetof(MeshVertexf, texcoord)
+        );
+    }
+
+    static bool hasTangents() { return true; }
+    static const void* TANGENT_OFFSET()
+    {
+        return reinterpret_cast<const void*>(
+            offsetof(MeshVertexf, tangent)
+        );
+    }
+    static const void* BITANGENT_OFFSET()
+    {
+        return reinterpret_cast<const void*>(
+            offsetof(MeshVertexf, bitangent)
+        );
+    }
+
+    static bool hasColour() { return true; }
+    static const void* COLOUR_OFFSET()
+    {
+        return reinterpret_cast<const void*>(
+            offsetof(MeshVertexf, colour)
+        );
+    }
+};
+
+}
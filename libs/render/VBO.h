@@ -49,6 +49,9 @@ void replaceVBOData(GLenum target, GLuint vboID, const Array_T& data)
 {
     glBindBuffer(target, vboID);
     glBufferSubData(target, 0, detail::byteSize(data), &data.front());
+
+    // Client-side arrays must not be mistaken for offsets into this buffer
+    glBindBuffer(target, 0);
 }
 
 /// Delete a VBO and set its identifier to 0
@@ -80,7 +83,7 @@ void replaceVBODataIfPossible(GLenum target, GLuint& vboID,
         if (newData.size() <= existingData.size())
         {
             // Replace VBO data
-            replaceVBOData(GL_ARRAY_BUFFER, vboID, newData);
+            replaceVBOData(target, vboID, newData);
         }
         else
         {
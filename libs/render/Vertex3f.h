@@ -74,6 +74,32 @@ public:
     static bool hasTangents() { return false; }
     static const void* TANGENT_OFFSET() { return 0; }
     static const void* BITANGENT_OFFSET() { return 0; }
+
+    static bool hasColour() { return false; }
+    static const void* COLOUR_OFFSET() { return 0; }
+};
+
+/// VertexTraits for Vector3f, the single-precision position-only vertex
+template<> class VertexTraits<Vector3f>
+{
+public:
+    static const void* VERTEX_OFFSET()
+    {
+        return 0;
+    }
+
+    static bool hasNormal() { return false; }
+    static const void* NORMAL_OFFSET() { return 0; }
+
+    static bool hasTexCoord() { return false; }
+    static const void* TEXCOORD_OFFSET() { return 0; }
+
+    static bool hasTangents() { return false; }
+    static const void* TANGENT_OFFSET() { return 0; }
+    static const void* BITANGENT_OFFSET() { return 0; }
+
+    static bool hasColour() { return false; }
+    static const void* COLOUR_OFFSET() { return 0; }
 };
 
 }
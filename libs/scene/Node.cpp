@@ -22,20 +22,47 @@ namespace
         public scene::NodeVisitor
     {
         AABB& _aabb;
+        std::size_t _count;
     public:
         AABBAccumulateWalker(AABB& aabb) :
-            _aabb(aabb)
+            _aabb(aabb),
+            _count(0)
         {}
 
+        std::size_t getCount() const {
+            return _count;
+        }
+
         virtual bool pre(const INodePtr& node) {
             _aabb.includeAABB(node->worldAABB());
+            ++_count;
             // Don't traverse the children
             return false;
         }
     };
 
+    // Returns true if the inner bounds are reaching the boundary of the outer bounds,
+    // i.e. the outer bounds might shrink if the inner bounds were removed
+    inline bool touchesBoundary(const AABB& inner, const AABB& outer)
+    {
+        const double EPSILON = 0.001;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            if (inner.origin[i] - inner.extents[i] <= outer.origin[i] - outer.extents[i] + EPSILON ||
+                inner.origin[i] + inner.extents[i] >= outer.origin[i] + outer.extents[i] - EPSILON)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
 } // namespace
 
+Node::BoundsStatistics Node::_boundsStatistics;
+
 Node::Node() :
 	_state(eVisible),
 	_isRoot(false),
@@ -86,6 +113,16 @@ unsigned long Node::getNewId() {
 	return ++_maxNodeId;
 }
 
+const Node::BoundsStatistics& Node::getBoundsStatistics()
+{
+	return _boundsStatistics;
+}
+
+void Node::resetBoundsStatistics()
+{
+	_boundsStatistics = BoundsStatistics();
+}
+
 void Node::setSceneGraph(const GraphPtr& sceneGraph)
 {
 	_sceneGraph = sceneGraph;
@@ -241,8 +278,9 @@ void Node::onChildAdded(const INodePtr& child)
 	// Pass down the RenderSystem to or children
 	child->setRenderSystem(_renderSystem.lock());
 
-	// greebo: The bounds most probably change when child nodes are added
-	boundsChanged();
+	// The bounds most probably change when child nodes are added,
+	// the new child didn't contribute anything so far
+	onChildBoundsChanged(child, AABB(), true);
 
 	if (!_instantiated) return;
 
@@ -260,7 +298,21 @@ void Node::onChildRemoved(const INodePtr& child)
 	// Don't change the parent node of the new child on erase
 
 	// greebo: The bounds are likely to change when child nodes are removed
-	boundsChanged();
+	if (!_childBoundsChanged && _changedChildren.erase(child) == 0)
+	{
+		// The child is not pending, so its current bounds are the ones which
+		// went into _childBounds. Check if they defined the extents.
+		const Node* childNode = dynamic_cast<const Node*>(child.get());
+
+		if (childNode == nullptr || childNode->_boundsChanged ||
+			(childNode->_bounds.isValid() && touchesBoundary(childNode->_bounds, _childBounds)))
+		{
+			_childBoundsChanged = true;
+			_changedChildren.clear();
+		}
+	}
+
+	invalidateBounds();
 
 	if (!_instantiated) return;
 
@@ -384,18 +436,69 @@ void Node::evaluateChildBounds() const {
 		// greebo: traverse the children of this node
 		traverseChildren(accumulator);
 
+		_boundsStatistics.fullEvaluations++;
+		_boundsStatistics.childrenTraversed += accumulator.getCount();
+
+		// Any notifications sent during evaluation are obsolete now
+		_changedChildren.clear();
+
+		_childBoundsMutex = false;
+		_childBoundsChanged = false;
+	}
+	else if (!_changedChildren.empty()) {
+		ASSERT_MESSAGE(!_childBoundsMutex, "re-entering bounds evaluation");
+		_childBoundsMutex = true;
+
+		// None of these children defined the extents before they changed,
+		// so it's enough to extend the existing bounds by their new ones.
+		// Evaluating their bounds can trigger further notifications, so
+		// work on a copy of the set.
+		std::unordered_set<INodePtr> changedChildren;
+		changedChildren.swap(_changedChildren);
+
+		for (const INodePtr& child : changedChildren)
+		{
+			_childBounds.includeAABB(child->worldAABB());
+		}
+
+		_boundsStatistics.incrementalUpdates++;
+		_boundsStatistics.childrenMerged += changedChildren.size();
+
+		_changedChildren.clear();
+
 		_childBoundsMutex = false;
 		_childBoundsChanged = false;
 	}
 }
 
 void Node::boundsChanged() {
-	_boundsChanged = true;
+	// Without further information all children need to be considered
 	_childBoundsChanged = true;
+	_changedChildren.clear();
+
+	invalidateBounds();
+}
+
+void Node::invalidateBounds() const
+{
+	// Remember the bounds the parent has been using so far, if we're up to date
+	bool previousBoundsKnown = !_boundsChanged;
+
+	_boundsChanged = true;
 
 	INodePtr parent = _parent.lock();
 	if (parent != NULL) {
-		parent->boundsChanged();
+		const Node* parentNode = dynamic_cast<const Node*>(parent.get());
+
+		if (parentNode != nullptr)
+		{
+			parentNode->onChildBoundsChanged(const_cast<Node*>(this)->shared_from_this(),
+				_bounds, previousBoundsKnown);
+		}
+		else
+		{
+			parent->boundsChanged();
+		}
 	}
 
 	// greebo: It's enough if only root nodes call the global scenegraph
@@ -411,6 +514,28 @@ void Node::boundsChanged() {
 	}
 }
 
+void Node::onChildBoundsChanged(const INodePtr& child, const AABB& previousBounds, bool previousBoundsKnown) const
+{
+	// If the child is already pending, its earlier bounds have been checked before
+	if (!_childBoundsChanged && _changedChildren.count(child) == 0)
+	{
+		// A child can be merged later on if its previous bounds didn't reach the
+		// boundary of our child bounds, i.e. removing them can't shrink the result
+		if (previousBoundsKnown && (!previousBounds.isValid() ||
+			(_childBounds.isValid() && !touchesBoundary(previousBounds, _childBounds))))
+		{
+			_changedChildren.insert(child);
+		}
+		else
+		{
+			_childBoundsChanged = true;
+			_changedChildren.clear();
+		}
+	}
+
+	invalidateBounds();
+}
+
 const Matrix4& Node::localToWorld() const {
 	evaluateTransform();
 	return _local2world;
@@ -423,7 +548,8 @@ void Node::evaluateTransform() const {
 
 		INodePtr parent = _parent.lock();
 		if (parent != NULL) {
-			parent->boundsChanged();
+			// Let the parent know that our bounds are about to change
+			invalidateBounds();
 		}
 
 		_local2world = (parent != NULL) ? parent->localToWorld() : Matrix4::getIdentity();
@@ -454,6 +580,10 @@ void Node::transformChangedLocal()
 
 void Node::transformChanged()
 {
+	// Inform the parent about the change before our bounds are marked as dirty,
+	// such that it gets to know the bounds we had so far
+	invalidateBounds();
+
 	// First, notify ourselves
 	transformChangedLocal();
 
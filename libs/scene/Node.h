@@ -4,6 +4,7 @@
 #include "ipath.h"
 #include "irender.h"
 #include <list>
+#include <unordered_set>
 #include "TraversableNodeSet.h"
 #include "math/AABB.h"
 #include "math/Matrix4.h"
@@ -48,6 +49,11 @@ private:
 	mutable bool _boundsMutex;
 	mutable bool _childBoundsChanged;
 	mutable bool _childBoundsMutex;
+
+	// Children which changed their bounds without defining the extents of
+	// _childBounds, these can be merged into _childBounds without re-evaluating
+	// all the other children. Only used as long as _childBoundsChanged is false.
+	mutable std::unordered_set<INodePtr> _changedChildren;
 	mutable bool _transformChanged;
 	mutable bool _transformMutex;
 	Callback _transformChangedCallback;
@@ -64,6 +70,9 @@ private:
 	// The list of layers this object is associated to
 	LayerList _layers;
 
+	// Location of this node in the scene's space partition (if linked)
+	SpacePartitionSlot _spacePartitionSlot;
+
 protected:
 	// If this node is attached to a parent entity, this is the reference to it
     IRenderEntity* _renderEntity;
@@ -75,6 +84,22 @@ protected:
 	GraphWeakPtr _sceneGraph;
 
 public:
+	// Counters used to monitor the child bounds evaluations
+	struct BoundsStatistics
+	{
+		std::size_t fullEvaluations;	// child bounds rebuilt from all children
+		std::size_t childrenTraversed;	// number of children visited for the above
+		std::size_t incrementalUpdates;	// child bounds extended by a few changed children
+		std::size_t childrenMerged;		// number of children merged for the above
+
+		BoundsStatistics() :
+			fullEvaluations(0),
+			childrenTraversed(0),
+			incrementalUpdates(0),
+			childrenMerged(0)
+		{}
+	};
+
 	Node();
 	Node(const Node& other);
 
@@ -83,6 +108,10 @@ public:
 	static void resetIds();
 	static unsigned long getNewId();
 
+	// Statistics about the child bounds evaluations since the last reset
+	static const BoundsStatistics& getBoundsStatistics();
+	static void resetBoundsStatistics();
+
     // Default name for generic nodes
     std::string name() const override { return "node"; }
 
@@ -156,6 +185,11 @@ public:
 
 	void setTransformChangedCallback(const Callback& callback);
 
+	SpacePartitionSlot& getSpacePartitionSlot() override
+	{
+		return _spacePartitionSlot;
+	}
+
 	// greebo: This gets called as soon as a scene::Node gets inserted into
 	// the TraversableNodeSet. This triggers an instantiation call on the child node.
 	virtual void onChildAdded(const INodePtr& child);
@@ -215,6 +249,16 @@ private:
 	void evaluateBounds() const;
 	void evaluateChildBounds() const;
 	void evaluateTransform() const;
+
+	// Marks this node's bounds as dirty and passes the notification
+	// up to the parent, along with the previous bounds (if known)
+	void invalidateBounds() const;
+
+	// Called by a child node whose bounds got invalidated. The previous bounds
+	// are used to decide whether the child bounds need a full re-evaluation.
+	void onChildBoundsChanged(const INodePtr& child, const AABB& previousBounds, bool previousBoundsKnown) const;
+
+	static BoundsStatistics _boundsStatistics;
 };
 
 typedef std::shared_ptr<Node> NodePtr;
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+
+#include "os/fs.h"
+
+/**
+ * Helpers for the binary cache files (map cache, archive manifests) and for
+ * replacing files without leaving a half-written one behind.
+ *
+ * Values are stored in the byte order of the writing platform, the files are
+ * local caches and not meant to be exchanged between machines.
+ */
+namespace stream
+{
+
+namespace binary
+{
+
+template<typename T>
+inline void writeValue(std::ostream& stream, const T& value)
+{
+	stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Appends the value to the given memory buffer
+template<typename T>
+inline void writeValue(std::string& buffer, const T& value)
+{
+	buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Writes the length of the string, followed by its characters
+inline void writeString(std::ostream& stream, const std::string& str)
+{
+	writeValue(stream, static_cast<std::uint32_t>(str.size()));
+	stream.write(str.data(), str.size());
+}
+
+// Reads the given number of bytes, throws std::runtime_error at the end of the stream
+inline void readData(std::istream& stream, void* data, std::size_t size)
+{
+	stream.read(static_cast<char*>(data), size);
+
+	if (!stream)
+	{
+		throw std::runtime_error("Unexpected end of file");
+	}
+}
+
+template<typename T>
+inline T readValue(std::istream& stream)
+{
+	T value;
+	readData(stream, &value, sizeof(T));
+	return value;
+}
+
+// Reads an element count, throws std::runtime_error if it is above the given limit.
+// The limit protects against huge allocations when reading a damaged file.
+inline std::uint32_t readCount(std::istream& stream, std::uint32_t maxCount)
+{
+	std::uint32_t count = readValue<std::uint32_t>(stream);
+
+	if (count > maxCount)
+	{
+		throw std::runtime_error("Invalid element count");
+	}
+
+	return count;
+}
+
+// Reads a string written by writeString(), its length is checked against the given limit
+inline std::string readString(std::istream& stream, std::uint32_t maxLength)
+{
+	std::string str(readCount(stream, maxLength), '\0');
+
+	if (!str.empty())
+	{
+		readData(stream, &str[0], str.size());
+	}
+
+	return str;
+}
+
+} // namespace binary
+
+namespace detail
+{
+
+inline void removeFileIfExists(const std::string& filename)
+{
+	try
+	{
+		if (fs::exists(filename))
+		{
+			fs::remove(filename);
+		}
+	}
+	catch (fs::filesystem_error&)
+	{}
+}
+
+} // namespace detail
+
+/**
+ * Calls the given function to write the contents of the file to a temporary
+ * file next to it, which then replaces the file. The existing file is only
+ * touched once the new contents have been written completely. If anything
+ * fails, the temporary file is removed and a std::runtime_error is thrown.
+ */
+inline void writeFileAtomically(const std::string& filename,
+	const std::function<void(std::ostream&)>& writeContents)
+{
+	std::string tempFilename = filename + ".tmp";
+
+	try
+	{
+		{
+			std::ofstream stream(tempFilename, std::ios::binary);
+
+			if (!stream)
+			{
+				throw std::runtime_error("Cannot open " + tempFilename + " for writing");
+			}
+
+			writeContents(stream);
+
+			stream.flush();
+
+			if (!stream)
+			{
+				throw std::runtime_error("Failure writing to " + tempFilename);
+			}
+		}
+
+		if (fs::exists(filename))
+		{
+			fs::remove(filename);
+		}
+
+		fs::rename(tempFilename, filename);
+	}
+	catch (fs::filesystem_error& ex)
+	{
+		detail::removeFileIfExists(tempFilename);
+		throw std::runtime_error(ex.what());
+	}
+	catch (...)
+	{
+		detail::removeFileIfExists(tempFilename);
+		throw;
+	}
+}
+
+} // namespace stream
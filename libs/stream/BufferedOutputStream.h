@@ -0,0 +1,139 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+#include <climits>
+
+namespace stream
+{
+
+/**
+ * An output stream collecting everything in a growable memory buffer.
+ *
+ * If a target stream is passed to the constructor, the collected data is handed
+ * over to the target in large chunks: whenever the buffer reaches the chunk size,
+ * when this stream is flushed and on destruction. Without a target stream the buffer
+ * just keeps growing, its contents can be accessed through data() and size().
+ */
+class BufferedOutputStream :
+	public std::ostream
+{
+private:
+	class Buffer :
+		public std::streambuf
+	{
+	private:
+		std::vector<char> _data;
+		std::ostream* _target;
+
+	public:
+		Buffer(std::ostream* target, std::size_t initialSize) :
+			_data(initialSize > 0 ? initialSize : 1),
+			_target(target)
+		{
+			reset(0);
+		}
+
+		const char* data() const
+		{
+			return pbase();
+		}
+
+		std::size_t size() const
+		{
+			return pptr() - pbase();
+		}
+
+		// Hands the collected data over to the target stream, if there is one
+		void writeToTarget()
+		{
+			if (_target != nullptr && size() > 0)
+			{
+				_target->write(data(), size());
+				reset(0);
+			}
+		}
+
+	protected:
+		int_type overflow(int_type c) override
+		{
+			if (_target != nullptr)
+			{
+				writeToTarget();
+			}
+			else
+			{
+				// No target, make room for more data
+				std::size_t used = size();
+				_data.resize(_data.size() * 2);
+				reset(used);
+			}
+
+			if (!traits_type::eq_int_type(c, traits_type::eof()))
+			{
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);
+			}
+
+			return traits_type::not_eof(c);
+		}
+
+		int sync() override
+		{
+			writeToTarget();
+
+			return _target == nullptr || _target->good() ? 0 : -1;
+		}
+
+	private:
+		// Assigns the put area to the buffer, placing the put pointer at the given offset
+		void reset(std::size_t offset)
+		{
+			setp(_data.data(), _data.data() + _data.size());
+
+			// pbump() takes an int
+			for (; offset > INT_MAX; offset -= INT_MAX)
+			{
+				pbump(INT_MAX);
+			}
+
+			pbump(static_cast<int>(offset));
+		}
+	};
+
+	Buffer _buffer;
+
+public:
+	// Construct a stream which just keeps all the data in memory
+	BufferedOutputStream(std::size_t initialSize = 64 * 1024) :
+		std::ostream(nullptr),
+		_buffer(nullptr, initialSize)
+	{
+		rdbuf(&_buffer);
+	}
+
+	// Construct a stream which passes the data to the target stream in chunks of the given size
+	BufferedOutputStream(std::ostream& target, std::size_t chunkSize) :
+		std::ostream(nullptr),
+		_buffer(&target, chunkSize)
+	{
+		rdbuf(&_buffer);
+	}
+
+	~BufferedOutputStream()
+	{
+		_buffer.writeToTarget();
+	}
+
+	const char* data() const
+	{
+		return _buffer.data();
+	}
+
+	std::size_t size() const
+	{
+		return _buffer.size();
+	}
+};
+
+}
@@ -8,9 +8,13 @@ namespace archive
 {
 
 /**
- * Scoped class reading all the data from the attached
- * ArchiveFile into a single memory chunk. Clients usually 
+ * Scoped class providing all the data of the attached
+ * ArchiveFile as a single memory chunk. Clients usually 
  * refer to the buffer variable to access the data.
+ *
+ * If the file can provide its data in place (see ArchiveFile::getData)
+ * no copy is made, otherwise the data is read into a null-terminated
+ * buffer owned by this instance.
  */
 class ScopedArchiveBuffer
 {
@@ -19,13 +23,19 @@ private:
 	std::unique_ptr<InputStream::byte_type[]> data;
 
 public:
-	InputStream::byte_type* const buffer; // immutable pointer for convenience purposes
+	const InputStream::byte_type* const buffer; // immutable pointer for convenience purposes
 	std::size_t length;
 	
 	ScopedArchiveBuffer(ArchiveFile& file) :
-		data(new InputStream::byte_type[file.size() + 1]),
-		buffer(data.get())
+		data(file.getData() == nullptr ? new InputStream::byte_type[file.size() + 1] : nullptr),
+		buffer(data ? data.get() : file.getData())
 	{
+		if (!data)
+		{
+			length = file.size();
+			return;
+		}
+
 		length = file.getInputStream().read(data.get(), file.size());
 		data[file.size()] = 0;
 	}
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <functional>
+#include <ostream>
+#include "case_conv.h"
+
+namespace string
+{
+
+namespace detail
+{
+
+// One entry per distinct string, the key of the pool map holds the characters
+struct InternedEntry
+{
+	const std::string* str;
+
+	// The entry of the lowercase variant, which is the same for all strings
+	// only differing in case (the lowercase entry points to itself)
+	const InternedEntry* lower;
+};
+
+/**
+ * The pool holding the interned strings. It is split into a number of
+ * independently locked shards, since the def files are parsed in parallel.
+ * Entries are never removed, their addresses stay valid for the lifetime
+ * of the process.
+ */
+class InternedStringPool
+{
+private:
+	static const std::size_t NUM_SHARDS = 16;
+
+	struct Shard
+	{
+		std::mutex lock;
+		std::unordered_map<std::string, InternedEntry> entries;
+	};
+
+	Shard _shards[NUM_SHARDS];
+
+public:
+	// Returns the entry of the given string, adding it if necessary
+	const InternedEntry* intern(const std::string& str)
+	{
+		std::size_t hash = std::hash<std::string>()(str);
+
+		{
+			Shard& shard = _shards[hash % NUM_SHARDS];
+			std::lock_guard<std::mutex> lock(shard.lock);
+
+			auto found = shard.entries.find(str);
+
+			if (found != shard.entries.end())
+			{
+				return &found->second;
+			}
+		}
+
+		// Not known yet, get hold of the lowercase entry first
+		std::string lowerStr = to_lower_copy(str);
+
+		const InternedEntry* lower = nullptr;
+
+		if (lowerStr != str)
+		{
+			lower = intern(lowerStr);
+		}
+
+		Shard& shard = _shards[hash % NUM_SHARDS];
+		std::lock_guard<std::mutex> lock(shard.lock);
+
+		// Another thread might have been faster, then that entry is returned
+		auto result = shard.entries.emplace(str, InternedEntry{ nullptr, lower });
+		InternedEntry& entry = result.first->second;
+
+		if (result.second)
+		{
+			entry.str = &result.first->first;
+
+			if (entry.lower == nullptr)
+			{
+				entry.lower = &entry;
+			}
+		}
+
+		return &entry;
+	}
+
+	// Returns the entry of the given string or nullptr if it has never been interned
+	const InternedEntry* find(const std::string& str)
+	{
+		std::size_t hash = std::hash<std::string>()(str);
+
+		Shard& shard = _shards[hash % NUM_SHARDS];
+		std::lock_guard<std::mutex> lock(shard.lock);
+
+		auto found = shard.entries.find(str);
+
+		return found != shard.entries.end() ? &found->second : nullptr;
+	}
+
+	static InternedStringPool& Instance()
+	{
+		// Never destroyed, handles might still be around at static destruction time
+		static InternedStringPool* _instance = new InternedStringPool;
+		return *_instance;
+	}
+};
+
+}
+
+/**
+ * Handle to a string stored in a process-wide pool, each distinct
+ * string is only stored once. Handles are as cheap to copy as a pointer,
+ * and comparing two of them is a pointer comparison, both case-sensitive
+ * (operator==) and case-insensitive (equalsNoCase).
+ *
+ * Use this for names occurring many times, like material names, classnames
+ * or spawnarg keys. Creating a handle needs a lookup in the pool, so keep
+ * the handle around instead of re-creating it from a std::string.
+ *
+ * Note: the pool lives in the binary including this header, a module
+ * has its own one. Don't pass handles across module boundaries.
+ */
+class InternedString
+{
+private:
+	const detail::InternedEntry* _entry;
+
+	explicit InternedString(const detail::InternedEntry* entry) :
+		_entry(entry)
+	{}
+
+public:
+	// An empty string
+	InternedString() :
+		_entry(emptyEntry())
+	{}
+
+	InternedString(const std::string& str) :
+		_entry(detail::InternedStringPool::Instance().intern(str))
+	{}
+
+	InternedString(const char* str) :
+		_entry(detail::InternedStringPool::Instance().intern(str))
+	{}
+
+	/**
+	 * Looks up the given string without adding it to the pool. Returns true
+	 * and assigns the handle if the string has been interned before. If it
+	 * returns false, no handle refers to this string (in any case variant).
+	 */
+	static bool Find(const std::string& str, InternedString& handle)
+	{
+		const detail::InternedEntry* entry = detail::InternedStringPool::Instance().find(str);
+
+		if (entry == nullptr)
+		{
+			// Other case variants might have been interned, check the lowercase one
+			entry = detail::InternedStringPool::Instance().find(to_lower_copy(str));
+
+			if (entry == nullptr)
+			{
+				return false;
+			}
+		}
+
+		handle = InternedString(entry);
+		return true;
+	}
+
+	const std::string& str() const
+	{
+		return *_entry->str;
+	}
+
+	operator const std::string&() const
+	{
+		return *_entry->str;
+	}
+
+	const char* c_str() const
+	{
+		return _entry->str->c_str();
+	}
+
+	bool empty() const
+	{
+		return _entry->str->empty();
+	}
+
+	// Case-insensitive comparison
+	bool equalsNoCase(const InternedString& other) const
+	{
+		return _entry->lower == other._entry->lower;
+	}
+
+	bool operator==(const InternedString& other) const
+	{
+		return _entry == other._entry;
+	}
+
+	bool operator!=(const InternedString& other) const
+	{
+		return _entry != other._entry;
+	}
+
+	// Orders case-insensitively by characters, like string_compare_nocase
+	bool lessNoCase(const InternedString& other) const
+	{
+		return _entry->lower != other._entry->lower &&
+			*_entry->lower->str < *other._entry->lower->str;
+	}
+
+	// The address of the pool entry, for use as hash value
+	std::size_t hash() const
+	{
+		return std::hash<const void*>()(_entry);
+	}
+
+private:
+	static const detail::InternedEntry* emptyEntry()
+	{
+		static const detail::InternedEntry* _empty = detail::InternedStringPool::Instance().intern(std::string());
+		return _empty;
+	}
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const InternedString& str)
+{
+	return stream << str.str();
+}
+
+// Orders the handles case-insensitively, for use as key comparator in ordered containers
+struct InternedStringLessNoCase
+{
+	bool operator()(const InternedString& a, const InternedString& b) const
+	{
+		return a.lessNoCase(b);
+	}
+};
+
+}
+
+namespace std
+{
+
+template<>
+struct hash<::string::InternedString>
+{
+	std::size_t operator()(const ::string::InternedString& str) const
+	{
+		return str.hash();
+	}
+};
+
+}
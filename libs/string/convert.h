@@ -3,6 +3,7 @@
 #include "math/Vector3.h"
 #include "math/Vector4.h"
 #include <sstream>
+#include <string_view>
 
 namespace string
 {
@@ -209,6 +210,114 @@ inline std::string convert<std::string, std::string>(const std::string& str, std
 	return str;
 }
 
+namespace detail
+{
+
+/**
+ * Converts a plain decimal number like "-12.5" or "0.015625" or "1e-3", which
+ * needs to cover the whole given range. The result is exact (the same as strtod's)
+ * as long as the significant digits fit into the double's mantissa and the power
+ * of ten is exactly representable, in which case a single multiplication or
+ * division does the job. Returns false for anything else.
+ */
+inline bool convertDecimalFast(const char* str, std::size_t length, double& result)
+{
+	static const double powersOfTen[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char* p = str;
+	const char* end = str + length;
+
+	bool negative = false;
+
+	if (p != end && (*p == '-' || *p == '+'))
+	{
+		negative = *p++ == '-';
+	}
+
+	unsigned long long mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool hasDigits = false;
+
+	for (; p != end && *p >= '0' && *p <= '9'; ++p)
+	{
+		hasDigits = true;
+
+		if (mantissa == 0 && *p == '0') continue; // leading zero
+
+		if (++significantDigits > 18) return false;
+
+		mantissa = mantissa * 10 + (*p - '0');
+	}
+
+	if (p != end && *p == '.')
+	{
+		for (++p; p != end && *p >= '0' && *p <= '9'; ++p)
+		{
+			hasDigits = true;
+			--exponent;
+
+			if (mantissa == 0 && *p == '0') continue; // leading zero
+
+			if (++significantDigits > 18) return false;
+
+			mantissa = mantissa * 10 + (*p - '0');
+		}
+	}
+
+	if (!hasDigits) return false;
+
+	if (p != end && (*p == 'e' || *p == 'E'))
+	{
+		++p;
+
+		bool negativeExponent = false;
+
+		if (p != end && (*p == '-' || *p == '+'))
+		{
+			negativeExponent = *p++ == '-';
+		}
+
+		if (p == end) return false;
+
+		int value = 0;
+
+		for (; p != end && *p >= '0' && *p <= '9'; ++p)
+		{
+			if (value > 1000) return false;
+
+			value = value * 10 + (*p - '0');
+		}
+
+		exponent += negativeExponent ? -value : value;
+	}
+
+	if (p != end) return false; // trailing characters
+
+	if (mantissa == 0)
+	{
+		result = negative ? -0.0 : 0.0;
+		return true;
+	}
+
+	if (mantissa > (1ull << 53) || exponent < -22 || exponent > 22)
+	{
+		return false;
+	}
+
+	double value = static_cast<double>(mantissa);
+	value = exponent < 0 ? value / powersOfTen[-exponent] : value * powersOfTen[exponent];
+
+	result = negative ? -value : value;
+	return true;
+}
+
+} // namespace detail
+
 #ifdef SPECIALISE_STR_TO_FLOAT
 /**
  * \brief
@@ -216,6 +325,8 @@ inline std::string convert<std::string, std::string>(const std::string& str, std
  *
  * If the SPECIALISE_STR_TO_FLOAT macro is defined, this will use the atof() C
  * function instead of convert<float>() which may provide a speed benefit.
+ * Plain decimal numbers (which is what the map and decl files are made of)
+ * are converted without calling into the C library at all.
  *
  * \internal
  * This is a separate function rather than an actual specialisation of
@@ -227,7 +338,15 @@ inline std::string convert<std::string, std::string>(const std::string& str, std
  */
 template<typename Src> double to_float(const Src& str)
 {
-    return std::atof(str.c_str());
+	double result;
+	return detail::convertDecimalFast(str.data(), str.size(), result) ? result : std::atof(str.c_str());
+}
+
+// Overload for tokens returned by the string_view based DefTokeniser
+inline double to_float(std::string_view str)
+{
+	double result;
+	return detail::convertDecimalFast(str.data(), str.size(), result) ? result : std::atof(std::string(str).c_str());
 }
 #else
 template<typename Src> float to_float(const Src& src)
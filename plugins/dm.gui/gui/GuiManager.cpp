@@ -11,7 +11,7 @@ namespace gui
 {
 
 GuiManager::GuiManager() :
-    _guiLoader(std::bind(&GuiManager::findGuis, this))
+    _guiLoader(std::bind(&GuiManager::findGuis, this), "GUIs")
 {}
 
 void GuiManager::registerGui(const std::string& guiPath)
@@ -205,6 +205,7 @@ const StringSet& GuiManager::getDependencies() const
 	if (_dependencies.empty())
 	{
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
+		_dependencies.insert(MODULE_THREADMANAGER);
 	}
 
 	return _dependencies;
@@ -16,7 +16,7 @@ class OggFileStream
 {
 	archive::ScopedArchiveBuffer& _source;
 
-	unsigned char* _curPtr;
+	const unsigned char* _curPtr;
 public:
 	OggFileStream(archive::ScopedArchiveBuffer& source) :
 		_source(source)
@@ -13,7 +13,7 @@ namespace sound
 
 // Constructor
 SoundManager::SoundManager() :
-    _defLoader(std::bind(&SoundManager::loadShadersFromFilesystem, this)),
+    _defLoader(std::bind(&SoundManager::loadShadersFromFilesystem, this), "Sound shaders"),
 	_emptyShader(new SoundShader("", ""))
 {}
 
@@ -116,6 +116,7 @@ const StringSet& SoundManager::getDependencies() const
 
 	if (_dependencies.empty()) {
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
+		_dependencies.insert(MODULE_THREADMANAGER);
 	}
 
 	return _dependencies;
@@ -1,105 +1,291 @@
 #include "RadiantThreadManager.h"
 
-#include <wx/thread.h>
+#include "itextstream.h"
+#include "modulesystem/StaticModule.h"
+
 #include <algorithm>
-#include <stdexcept>
+#include <iterator>
+#include <chrono>
 
 namespace radiant
 {
 
-class RadiantThreadManager::DetachedThread : 
-	public wxThread
+namespace
 {
-private:
-	std::size_t _threadId;
-	std::function<void()> _func;
-	RadiantThreadManager& _owner;
-
-public:
-	DetachedThread(std::size_t threadId, std::function<void()>& func, RadiantThreadManager& owner) :
-		wxThread(wxTHREAD_JOINABLE),
-		_threadId(threadId),
-		_func(func),
-		_owner(owner)
-	{}
-
-	void OnExit()
-	{
-		_owner.onThreadFinished(_threadId);
-	}
+	// The pool the current thread is a worker of (or nullptr) and its index
+	thread_local const RadiantThreadManager* _currentPool = nullptr;
+	thread_local std::size_t _currentWorkerIndex = 0;
+}
 
-	ExitCode Entry()
-	{
-		_func();
+RadiantThreadManager::RadiantThreadManager() :
+	_numPendingTasks(0),
+	_stopped(false),
+	_nextJobId(1)
+{}
 
-		return static_cast<ExitCode>(0);
-	}
-};
+const std::string& RadiantThreadManager::getName() const
+{
+	static std::string _name(MODULE_THREADMANAGER);
+	return _name;
+}
+
+const StringSet& RadiantThreadManager::getDependencies() const
+{
+	static StringSet _dependencies;
+	return _dependencies;
+}
+
+void RadiantThreadManager::initialiseModule(const ApplicationContext& ctx)
+{
+	rMessage() << getName() << "::initialiseModule called." << std::endl;
+
+	// One worker per core, hardware_concurrency() might not be able to tell
+	std::size_t numWorkers = std::thread::hardware_concurrency();
+
+	startWorkers(numWorkers > 0 ? numWorkers : 2);
+
+	rMessage() << "[threads] Started " << _workers.size() << " worker threads." << std::endl;
+}
+
+void RadiantThreadManager::shutdownModule()
+{
+	rMessage() << getName() << "::shutdownModule called." << std::endl;
+
+	// Let the running tasks finish, the queued ones are dropped. The modules
+	// which posted them might have been shut down already.
+	stopWorkers();
+
+	std::lock_guard<std::mutex> lock(_jobLock);
+	_jobs.clear();
+}
+
+bool RadiantThreadManager::isInitialisationThreadSafe() const
+{
+	// Nothing but our own state is touched during initialisation
+	return true;
+}
 
-RadiantThreadManager::~RadiantThreadManager()
+void RadiantThreadManager::post(std::function<void()> task, Priority priority)
 {
-	std::for_each(_threads.begin(), _threads.end(), [] (const ThreadMap::value_type& pair)
 	{
-		if (pair.second->IsRunning())
+		std::lock_guard<std::mutex> lock(_lock);
+
+		if (_stopped)
 		{
-			pair.second->Delete();
+			// Shutting down, the task is destroyed on return
+			return;
 		}
-	});
 
-	std::for_each(_threads.begin(), _threads.end(), [](const ThreadMap::value_type& pair)
-	{
-		if (pair.second->IsRunning())
+		if (!_workers.empty())
 		{
-			pair.second->Wait();
+			// Count the task before queueing it, a worker seeing the counter
+			// can then only be ahead of the queue, never behind
+			++_numPendingTasks;
+
+			if (_currentPool == this)
+			{
+				// Posted by one of our tasks, keep it close to its worker
+				WorkerQueue& queue = *_workerQueues[_currentWorkerIndex];
+
+				std::lock_guard<std::mutex> queueLock(queue.lock);
+				queue.tasks.emplace_back(std::move(task));
+			}
+			else
+			{
+				_queues[static_cast<std::size_t>(priority)].emplace_back(std::move(task));
+			}
+
+			_taskAvailable.notify_one();
+			return;
 		}
-	});
+	}
+
+	// Not running yet, do it right now
+	task();
+}
 
-	_threads.clear();
+std::size_t RadiantThreadManager::getNumWorkers() const
+{
+	return _workers.size();
 }
 
 std::size_t RadiantThreadManager::execute(std::function<void()> func)
 {
-	std::size_t threadId = getFreeThreadId();
+	std::shared_future<void> job = submit(func, Priority::Low).share();
+
+	std::lock_guard<std::mutex> lock(_jobLock);
+
+	// Forget about the finished jobs
+	for (JobMap::iterator i = _jobs.begin(); i != _jobs.end();)
+	{
+		if (i->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			_jobs.erase(i++);
+		}
+		else
+		{
+			++i;
+		}
+	}
 
-	_threads[threadId] = DetachedThreadPtr(new DetachedThread(threadId, func, *this));
-	_threads[threadId]->Run();
+	std::size_t threadId = _nextJobId++;
+	_jobs[threadId] = job;
 
 	return threadId;
 }
 
 bool RadiantThreadManager::threadIsRunning(std::size_t threadId)
 {
-	ThreadMap::const_iterator found = _threads.find(threadId);
+	std::lock_guard<std::mutex> lock(_jobLock);
+
+	JobMap::const_iterator found = _jobs.find(threadId);
+
+	if (found == _jobs.end()) return false;
+
+	return found->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void RadiantThreadManager::startWorkers(std::size_t numWorkers)
+{
+	std::lock_guard<std::mutex> lock(_lock);
 
-	if (found == _threads.end()) return false;
+	_stopped = false;
 
-	return found->second->IsRunning();
+	for (std::size_t i = 0; i < numWorkers; ++i)
+	{
+		_workerQueues.emplace_back(new WorkerQueue);
+	}
+
+	for (std::size_t i = 0; i < numWorkers; ++i)
+	{
+		_workers.emplace_back(&RadiantThreadManager::runWorker, this, i);
+	}
+}
+
+void RadiantThreadManager::stopWorkers()
+{
+	std::vector<Task> droppedTasks;
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		_stopped = true;
+
+		// Take the queued tasks away, post() doesn't add any from now on
+		for (std::deque<Task>& queue : _queues)
+		{
+			std::move(queue.begin(), queue.end(), std::back_inserter(droppedTasks));
+			queue.clear();
+		}
+
+		for (const std::unique_ptr<WorkerQueue>& queue : _workerQueues)
+		{
+			std::lock_guard<std::mutex> queueLock(queue->lock);
+
+			std::move(queue->tasks.begin(), queue->tasks.end(), std::back_inserter(droppedTasks));
+			queue->tasks.clear();
+		}
+	}
+
+	_taskAvailable.notify_all();
+
+	// Destroying the tasks breaks the promises of the submitted ones,
+	// which wakes up anyone waiting for them
+	droppedTasks.clear();
+
+	for (std::thread& worker : _workers)
+	{
+		worker.join();
+	}
+
+	std::lock_guard<std::mutex> lock(_lock);
+
+	_workers.clear();
+	_workerQueues.clear();
+
+	_numPendingTasks = 0;
 }
 
-void RadiantThreadManager::onThreadFinished(std::size_t threadId)
+void RadiantThreadManager::runWorker(std::size_t index)
 {
-	ThreadMap::iterator found = _threads.find(threadId);
+	_currentPool = this;
+	_currentWorkerIndex = index;
+
+	while (!_stopped)
+	{
+		Task task;
+
+		if (tryGetTask(index, task))
+		{
+			--_numPendingTasks;
 
-	assert(found != _threads.end());
+			try
+			{
+				task();
+			}
+			catch (std::exception& ex)
+			{
+				rError() << "[threads] Unhandled exception in worker thread: " << ex.what() << std::endl;
+			}
 
-	// Don't delete the thread yet, it's stil used by wxWidgets
-	_finishedThreads.push_back(found->second);
-	_threads.erase(found);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_lock);
+
+		_taskAvailable.wait(lock, [this]() { return _stopped || _numPendingTasks > 0; });
+	}
+
+	_currentPool = nullptr;
 }
 
-std::size_t RadiantThreadManager::getFreeThreadId()
+bool RadiantThreadManager::tryGetTask(std::size_t index, Task& task)
 {
-	_finishedThreads.clear();
+	// Our own queue first, newest task first
+	{
+		WorkerQueue& queue = *_workerQueues[index];
+		std::lock_guard<std::mutex> lock(queue.lock);
 
-	for (std::size_t i = 1; i < std::numeric_limits<std::size_t>::max(); ++i)
+		if (!queue.tasks.empty())
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			return true;
+		}
+	}
+
+	// The tasks posted from outside, by priority
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		for (std::deque<Task>& queue : _queues)
+		{
+			if (!queue.empty())
+			{
+				task = std::move(queue.front());
+				queue.pop_front();
+				return true;
+			}
+		}
+	}
+
+	// Steal the oldest task of another worker, starting with our neighbour
+	for (std::size_t i = 1; i < _workerQueues.size(); ++i)
 	{
-		if (_threads.find(i) == _threads.end())
+		WorkerQueue& queue = *_workerQueues[(index + i) % _workerQueues.size()];
+		std::lock_guard<std::mutex> lock(queue.lock);
+
+		if (!queue.tasks.empty())
 		{
-			return i;
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			return true;
 		}
 	}
 
-	throw std::runtime_error("No more free thread IDs.");
+	return false;
 }
 
+// Static module instance
+module::StaticModule<RadiantThreadManager> radiantThreadManagerModule;
+
 }
@@ -4,34 +4,70 @@
 #include <memory>
 #include <map>
 #include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 namespace radiant
 {
 
 /// ThreadManager implementation class
-class RadiantThreadManager : 
+class RadiantThreadManager :
 	public ThreadManager
 {
-	class DetachedThread;
-	typedef std::shared_ptr<DetachedThread> DetachedThreadPtr;
+	typedef std::function<void()> Task;
 
-	typedef std::map<std::size_t, DetachedThreadPtr> ThreadMap;
-	ThreadMap _threads;
+	// Every worker has its own queue, accessed LIFO by its owner and FIFO by
+	// the other workers looking for something to steal
+	struct WorkerQueue
+	{
+		std::mutex lock;
+		std::deque<Task> tasks;
+	};
+	std::vector<std::unique_ptr<WorkerQueue>> _workerQueues;
+	std::vector<std::thread> _workers;
 
-	std::vector<DetachedThreadPtr> _finishedThreads;
+	// Tasks posted from outside the pool, one queue per priority
+	std::mutex _lock;
+	std::deque<Task> _queues[3];
+
+	// Number of tasks in all the queues, workers sleep while this is 0
+	std::atomic<std::size_t> _numPendingTasks;
+	std::condition_variable _taskAvailable;
+
+	// Set on shutdown, no more tasks are started or queued from then on
+	std::atomic<bool> _stopped;
+
+	// The jobs started by execute()
+	std::mutex _jobLock;
+	typedef std::map<std::size_t, std::shared_future<void>> JobMap;
+	JobMap _jobs;
+	std::size_t _nextJobId;
 
 public:
-	~RadiantThreadManager();
+	RadiantThreadManager();
 
-    // ThreadManager implementation
-	std::size_t execute(std::function<void()>);
-	bool threadIsRunning(std::size_t threadId);
+	// RegisterableModule implementation
+	const std::string& getName() const override;
+	const StringSet& getDependencies() const override;
+	void initialiseModule(const ApplicationContext& ctx) override;
+	void shutdownModule() override;
+	bool isInitialisationThreadSafe() const override;
 
-	// Called by the worker threads
-	void onThreadFinished(std::size_t threadId);
+	// ThreadManager implementation
+	void post(std::function<void()> task, Priority priority) override;
+	std::size_t getNumWorkers() const override;
+	std::size_t execute(std::function<void()> func) override;
+	bool threadIsRunning(std::size_t threadId) override;
 
 private:
-	std::size_t getFreeThreadId();
+	void startWorkers(std::size_t numWorkers);
+	void stopWorkers();
+
+	void runWorker(std::size_t index);
+	bool tryGetTask(std::size_t index, Task& task);
 };
 
 }
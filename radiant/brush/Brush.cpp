@@ -1371,6 +1371,12 @@ void Brush::buildBRep() {
       }
     }
   }
+
+  // The windings are final now, have the faces re-triangulate them
+  for (const FacePtr& face : m_faces)
+  {
+    face->windingChanged();
+  }
 }
 
 // ----------------------------------------------------------------------------
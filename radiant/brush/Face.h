@@ -12,6 +12,7 @@
 #include "SurfaceShader.h"
 #include "PlanePoints.h"
 #include "FacePlane.h"
+#include "FaceGeometry.h"
 #include <memory>
 #include "util/Noncopyable.h"
 #include <sigc++/signal.h>
@@ -61,6 +62,12 @@ private:
 	// Cached visibility flag, queried during front end rendering
 	bool _faceIsVisible;
 
+	// The triangulated winding in the VBO page of our material, used for
+	// the solid rendering. It is rewritten on the next render after the
+	// winding, its texture coordinates or the material have changed.
+	mutable brush::FaceGeometry _geometry;
+	mutable bool _geometryChanged;
+
 public:
 
 	// Constructors
@@ -86,6 +93,9 @@ public:
 	// greebo: Emits the updated normals to the Winding class.
 	void updateWinding();
 
+	// Marks the render geometry as outdated, to be called after the winding has changed
+	void windingChanged();
+
     void connectUndoSystem(IMapFileChangeTracker& changeTracker);
     void disconnectUndoSystem(IMapFileChangeTracker& changeTracker);
 
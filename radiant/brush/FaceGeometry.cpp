@@ -0,0 +1,468 @@
+#include "FaceGeometry.h"
+
+#include "igl.h"
+#include "Winding.h"
+#include "GLProgramAttributes.h"
+
+#include <cstddef>
+#include <algorithm>
+
+namespace brush
+{
+
+namespace
+{
+	// The smallest range handed out, a triangle needs three vertices
+	const std::size_t MIN_RANGE_SIZE = 4;
+
+	// The initial size of the GL buffers, in vertices
+	const std::size_t MIN_BUFFER_SIZE = 256;
+
+	inline const GLvoid* vertexOffset(std::size_t offset)
+	{
+		return reinterpret_cast<const GLvoid*>(offset);
+	}
+
+	inline std::size_t getSizeClass(std::size_t rangeSize)
+	{
+		std::size_t sizeClass = 0;
+
+		for (std::size_t size = MIN_RANGE_SIZE; size < rangeSize; size <<= 1)
+		{
+			++sizeClass;
+		}
+
+		return sizeClass;
+	}
+}
+
+FaceGeometryPage::FaceGeometryPage() :
+	_used(0),
+	_numVerticesInUse(0),
+	_vertexBuffer(0),
+	_indexBuffer(0),
+	_bufferSize(0)
+{}
+
+FaceGeometryPage::~FaceGeometryPage()
+{
+	if (_vertexBuffer != 0)
+	{
+		glDeleteBuffers(1, &_vertexBuffer);
+		glDeleteBuffers(1, &_indexBuffer);
+	}
+}
+
+std::size_t FaceGeometryPage::getRangeSize(std::size_t numVertices)
+{
+	std::size_t rangeSize = MIN_RANGE_SIZE;
+
+	while (rangeSize < numVertices)
+	{
+		rangeSize <<= 1;
+	}
+
+	return rangeSize;
+}
+
+std::size_t FaceGeometryPage::allocate(std::size_t rangeSize)
+{
+	std::size_t sizeClass = getSizeClass(rangeSize);
+
+	if (sizeClass < _freeRanges.size() && !_freeRanges[sizeClass].empty())
+	{
+		std::size_t offset = _freeRanges[sizeClass].back();
+		_freeRanges[sizeClass].pop_back();
+
+		_numVerticesInUse += rangeSize;
+		return offset;
+	}
+
+	if (_used + rangeSize > MAX_VERTICES)
+	{
+		return INVALID_OFFSET;
+	}
+
+	std::size_t offset = _used;
+	_used += rangeSize;
+	_numVerticesInUse += rangeSize;
+
+	return offset;
+}
+
+void FaceGeometryPage::release(std::size_t offset, std::size_t rangeSize)
+{
+	std::size_t sizeClass = getSizeClass(rangeSize);
+
+	if (sizeClass >= _freeRanges.size())
+	{
+		_freeRanges.resize(sizeClass + 1);
+	}
+
+	_freeRanges[sizeClass].push_back(offset);
+	_numVerticesInUse -= rangeSize;
+}
+
+bool FaceGeometryPage::empty() const
+{
+	return _numVerticesInUse == 0;
+}
+
+std::size_t FaceGeometryPage::update(std::size_t offset, const Winding& winding)
+{
+	std::size_t numVertices = winding.size();
+
+	if (numVertices < 3)
+	{
+		return 0;
+	}
+
+	std::size_t numIndices = (numVertices - 2) * 3;
+
+	if (_pendingVertices.size() > _used * 2)
+	{
+		discardOverwrittenUpdates();
+	}
+
+	_pendingUpdates.push_back(PendingUpdate{ offset, numVertices, numIndices,
+		_pendingVertices.size(), _pendingIndices.size() });
+
+	for (const WindingVertex& wv : winding)
+	{
+		_pendingVertices.emplace_back();
+		FaceVertex& vertex = _pendingVertices.back();
+
+		vertex.vertex = Vector3f(wv.vertex.x(), wv.vertex.y(), wv.vertex.z());
+		vertex.texcoord[0] = static_cast<float>(wv.texcoord.x());
+		vertex.texcoord[1] = static_cast<float>(wv.texcoord.y());
+		vertex.normal = Vector3f(wv.normal.x(), wv.normal.y(), wv.normal.z());
+		vertex.tangent = Vector3f(wv.tangent.x(), wv.tangent.y(), wv.tangent.z());
+		vertex.bitangent = Vector3f(wv.bitangent.x(), wv.bitangent.y(), wv.bitangent.z());
+	}
+
+	// Windings are convex, triangulate them as a fan around the first vertex
+	for (std::size_t i = 1; i + 1 < numVertices; ++i)
+	{
+		_pendingIndices.push_back(static_cast<RenderIndex>(offset));
+		_pendingIndices.push_back(static_cast<RenderIndex>(offset + i));
+		_pendingIndices.push_back(static_cast<RenderIndex>(offset + i + 1));
+	}
+
+	return numIndices;
+}
+
+void FaceGeometryPage::discardOverwrittenUpdates()
+{
+	std::vector<PendingUpdate> updates;
+	std::vector<FaceVertex> vertices;
+	std::vector<RenderIndex> indices;
+
+	std::vector<bool> isUpdated(_used, false);
+
+	// Keep the most recent update of each range
+	for (auto i = _pendingUpdates.rbegin(); i != _pendingUpdates.rend(); ++i)
+	{
+		if (isUpdated[i->offset]) continue;
+
+		isUpdated[i->offset] = true;
+
+		updates.push_back(PendingUpdate{ i->offset, i->numVertices, i->numIndices,
+			vertices.size(), indices.size() });
+
+		vertices.insert(vertices.end(), _pendingVertices.begin() + i->firstVertex,
+			_pendingVertices.begin() + i->firstVertex + i->numVertices);
+		indices.insert(indices.end(), _pendingIndices.begin() + i->firstIndex,
+			_pendingIndices.begin() + i->firstIndex + i->numIndices);
+	}
+
+	_pendingUpdates.swap(updates);
+	_pendingVertices.swap(vertices);
+	_pendingIndices.swap(indices);
+}
+
+void FaceGeometryPage::upload() const
+{
+	if (_bufferSize < _used)
+	{
+		// Grow the buffers to the next power of two and upload everything
+		std::size_t bufferSize = std::max(_bufferSize, MIN_BUFFER_SIZE);
+
+		while (bufferSize < _used)
+		{
+			bufferSize <<= 1;
+		}
+
+		std::vector<FaceVertex> vertices(_used);
+		std::vector<RenderIndex> indices(_used * 3);
+
+		// Fetch what has been uploaded before, then apply the changes
+		if (_bufferSize > 0)
+		{
+			glGetBufferSubData(GL_ARRAY_BUFFER, 0, _bufferSize * sizeof(FaceVertex), &vertices.front());
+			glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, _bufferSize * 3 * sizeof(RenderIndex), &indices.front());
+		}
+
+		for (const PendingUpdate& update : _pendingUpdates)
+		{
+			std::copy(_pendingVertices.begin() + update.firstVertex,
+				_pendingVertices.begin() + update.firstVertex + update.numVertices,
+				vertices.begin() + update.offset);
+
+			std::copy(_pendingIndices.begin() + update.firstIndex,
+				_pendingIndices.begin() + update.firstIndex + update.numIndices,
+				indices.begin() + update.offset * 3);
+		}
+
+		_bufferSize = std::min(bufferSize, MAX_VERTICES);
+
+		glBufferData(GL_ARRAY_BUFFER, _bufferSize * sizeof(FaceVertex), nullptr, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, _used * sizeof(FaceVertex), &vertices.front());
+
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, _bufferSize * 3 * sizeof(RenderIndex), nullptr, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, _used * 3 * sizeof(RenderIndex), &indices.front());
+	}
+	else
+	{
+		// Later updates of the same range are overwriting the earlier ones
+		for (const PendingUpdate& update : _pendingUpdates)
+		{
+			glBufferSubData(GL_ARRAY_BUFFER, update.offset * sizeof(FaceVertex),
+				update.numVertices * sizeof(FaceVertex), &_pendingVertices[update.firstVertex]);
+
+			glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, update.offset * 3 * sizeof(RenderIndex),
+				update.numIndices * sizeof(RenderIndex), &_pendingIndices[update.firstIndex]);
+		}
+	}
+
+	_pendingUpdates.clear();
+
+	// Don't hold on to the memory needed for loading a whole map
+	if (_pendingVertices.capacity() > MIN_BUFFER_SIZE)
+	{
+		std::vector<PendingUpdate>().swap(_pendingUpdates);
+		std::vector<FaceVertex>().swap(_pendingVertices);
+		std::vector<RenderIndex>().swap(_pendingIndices);
+	}
+	else
+	{
+		_pendingVertices.clear();
+		_pendingIndices.clear();
+	}
+}
+
+void FaceGeometryPage::bind(const RenderInfo& info) const
+{
+	if (_vertexBuffer == 0)
+	{
+		glGenBuffers(1, &_vertexBuffer);
+		glGenBuffers(1, &_indexBuffer);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+
+	if (_bufferSize < _used || !_pendingUpdates.empty())
+	{
+		upload();
+	}
+
+	// Our vertex colours are always white, if requested
+	glDisableClientState(GL_COLOR_ARRAY);
+	if (info.checkFlag(RENDER_VERTEX_COLOUR))
+	{
+		glColor3f(1, 1, 1);
+	}
+
+	const GLsizei stride = sizeof(FaceVertex);
+
+	glVertexPointer(3, GL_FLOAT, stride, vertexOffset(offsetof(FaceVertex, vertex)));
+
+	// Check render flags. Multiple flags may be set, so the order matters.
+	// See Winding::render() for the client-array equivalent.
+	if (info.checkFlag(RENDER_TEXTURE_CUBEMAP))
+	{
+		// In cube-map mode, we submit the vertex coordinate as the texture coordinate
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(3, GL_FLOAT, stride, vertexOffset(offsetof(FaceVertex, vertex)));
+	}
+	else if (info.checkFlag(RENDER_BUMP))
+	{
+		// Lighting mode, submit normals, tangents and texcoords to the shader program
+		glVertexAttribPointer(ATTR_NORMAL, 3, GL_FLOAT, 0, stride, vertexOffset(offsetof(FaceVertex, normal)));
+		glVertexAttribPointer(ATTR_TEXCOORD, 2, GL_FLOAT, 0, stride, vertexOffset(offsetof(FaceVertex, texcoord)));
+		glVertexAttribPointer(ATTR_TANGENT, 3, GL_FLOAT, 0, stride, vertexOffset(offsetof(FaceVertex, tangent)));
+		glVertexAttribPointer(ATTR_BITANGENT, 3, GL_FLOAT, 0, stride, vertexOffset(offsetof(FaceVertex, bitangent)));
+	}
+	else
+	{
+		if (info.checkFlag(RENDER_LIGHTING))
+		{
+			glNormalPointer(GL_FLOAT, stride, vertexOffset(offsetof(FaceVertex, normal)));
+		}
+
+		if (info.checkFlag(RENDER_TEXTURE_2D))
+		{
+			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+			glTexCoordPointer(2, GL_FLOAT, stride, vertexOffset(offsetof(FaceVertex, texcoord)));
+		}
+	}
+}
+
+void FaceGeometryPage::unbind(const RenderInfo& info) const
+{
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void FaceGeometryPage::render(const RenderInfo& info, std::size_t offset, std::size_t numIndices) const
+{
+	if (numIndices == 0) return;
+
+	bind(info);
+
+	glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(numIndices), RenderIndexTypeID,
+		vertexOffset(offset * 3 * sizeof(RenderIndex)));
+
+	unbind(info);
+}
+
+void FaceGeometryPage::renderBatch(const RenderInfo& info,
+	const std::vector<const OpenGLRenderable*>& renderables) const
+{
+	_counts.clear();
+	_offsets.clear();
+
+	for (const OpenGLRenderable* renderable : renderables)
+	{
+		// We're only the batch of the face geometry
+		const FaceGeometry& geometry = static_cast<const FaceGeometry&>(*renderable);
+
+		if (geometry.getNumIndices() == 0) continue;
+
+		_counts.push_back(static_cast<GLsizei>(geometry.getNumIndices()));
+		_offsets.push_back(vertexOffset(geometry.getOffset() * 3 * sizeof(RenderIndex)));
+	}
+
+	if (_counts.empty()) return;
+
+	bind(info);
+
+	glMultiDrawElements(GL_TRIANGLES, &_counts.front(), RenderIndexTypeID,
+		&_offsets.front(), static_cast<GLsizei>(_counts.size()));
+
+	unbind(info);
+}
+
+FaceGeometryPage& BrushGeometryStore::allocate(const string::InternedString& material,
+	std::size_t rangeSize, std::size_t& offset)
+{
+	Pages& pages = _buckets[material];
+
+	// Try the most recently added pages first, the older ones are likely full
+	for (Pages::reverse_iterator i = pages.rbegin(); i != pages.rend(); ++i)
+	{
+		offset = (*i)->allocate(rangeSize);
+
+		if (offset != FaceGeometryPage::INVALID_OFFSET)
+		{
+			return **i;
+		}
+	}
+
+	pages.emplace_back(new FaceGeometryPage);
+	offset = pages.back()->allocate(rangeSize);
+
+	return *pages.back();
+}
+
+void BrushGeometryStore::release(const string::InternedString& material, FaceGeometryPage& page,
+	std::size_t offset, std::size_t rangeSize)
+{
+	page.release(offset, rangeSize);
+
+	if (!page.empty()) return;
+
+	// Remove the page, and the bucket if this has been the last one
+	auto bucket = _buckets.find(material);
+
+	if (bucket == _buckets.end()) return;
+
+	Pages& pages = bucket->second;
+
+	for (Pages::iterator i = pages.begin(); i != pages.end(); ++i)
+	{
+		if (i->get() == &page)
+		{
+			pages.erase(i);
+			break;
+		}
+	}
+
+	if (pages.empty())
+	{
+		_buckets.erase(bucket);
+	}
+}
+
+BrushGeometryStore& BrushGeometryStore::Instance()
+{
+	// Never destroyed, faces might still release their ranges at static destruction time
+	static BrushGeometryStore* _instance = new BrushGeometryStore;
+	return *_instance;
+}
+
+FaceGeometry::FaceGeometry() :
+	_page(nullptr),
+	_offset(0),
+	_rangeSize(0),
+	_numIndices(0)
+{}
+
+FaceGeometry::~FaceGeometry()
+{
+	clear();
+}
+
+void FaceGeometry::update(const Winding& winding, const string::InternedString& material)
+{
+	std::size_t rangeSize = FaceGeometryPage::getRangeSize(winding.size());
+
+	// Keep our range if it's still the right one, otherwise get a new one
+	if (_page == nullptr || _rangeSize != rangeSize || _material != material)
+	{
+		clear();
+
+		_material = material;
+		_rangeSize = rangeSize;
+		_page = &BrushGeometryStore::Instance().allocate(_material, _rangeSize, _offset);
+	}
+
+	_numIndices = _page->update(_offset, winding);
+}
+
+void FaceGeometry::clear()
+{
+	if (_page == nullptr) return;
+
+	BrushGeometryStore::Instance().release(_material, *_page, _offset, _rangeSize);
+
+	_page = nullptr;
+	_numIndices = 0;
+}
+
+void FaceGeometry::render(const RenderInfo& info) const
+{
+	if (_page != nullptr)
+	{
+		_page->render(info, _offset, _numIndices);
+	}
+}
+
+const OpenGLRenderBatch* FaceGeometry::getRenderBatch() const
+{
+	return _page;
+}
+
+}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "irender.h"
+#include "render.h"
+#include "math/Vector3.h"
+#include "string/InternedString.h"
+#include "util/Noncopyable.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+class Winding;
+
+namespace brush
+{
+
+// The vertex format of the face geometry in the VBO pages
+struct FaceVertex
+{
+	Vector3f vertex;
+	float texcoord[2];
+	Vector3f normal;
+	Vector3f tangent;
+	Vector3f bitangent;
+};
+
+/**
+ * A pair of vertex and index buffers holding the triangulated windings
+ * of many faces using the same material. Every face gets a range of vertices,
+ * its indices are stored at three times the vertex offset. The ranges are
+ * handed out in power-of-two sizes and recycled once the face is gone.
+ *
+ * The buffers start small and grow up to MAX_VERTICES. Updated windings are
+ * staged until the next draw, which uploads them range by range. The page
+ * doesn't keep a copy of the uploaded geometry, growing the buffers reads
+ * their contents back instead (which happens a few times per page at most).
+ *
+ * The page is the OpenGLRenderBatch of its faces, the faces submitted in a row
+ * are drawn with a single glMultiDrawElements call.
+ */
+class FaceGeometryPage :
+	public OpenGLRenderBatch,
+	public util::Noncopyable
+{
+public:
+	static const std::size_t MAX_VERTICES = 1 << 16;
+
+	// Returned by allocate() if the page is full
+	static const std::size_t INVALID_OFFSET = static_cast<std::size_t>(-1);
+
+private:
+	// A triangulated winding waiting to be uploaded
+	struct PendingUpdate
+	{
+		std::size_t offset;
+		std::size_t numVertices;
+		std::size_t numIndices;
+
+		// Where the data is found in the staging buffers
+		std::size_t firstVertex;
+		std::size_t firstIndex;
+	};
+
+	// The updates since the last upload, in order
+	mutable std::vector<PendingUpdate> _pendingUpdates;
+	mutable std::vector<FaceVertex> _pendingVertices;
+	mutable std::vector<RenderIndex> _pendingIndices;
+
+	// The number of vertices handed out so far, including the freed ones
+	std::size_t _used;
+
+	// The number of vertices in ranges currently in use
+	std::size_t _numVerticesInUse;
+
+	// Freed ranges, one list per size class
+	std::vector<std::vector<std::size_t>> _freeRanges;
+
+	mutable GLuint _vertexBuffer;
+	mutable GLuint _indexBuffer;
+
+	// The size of the GL buffers, in vertices
+	mutable std::size_t _bufferSize;
+
+	// Buffers for glMultiDrawElements
+	mutable std::vector<GLsizei> _counts;
+	mutable std::vector<const GLvoid*> _offsets;
+
+public:
+	FaceGeometryPage();
+	~FaceGeometryPage();
+
+	// Returns the size of the range handed out for the given number of vertices
+	static std::size_t getRangeSize(std::size_t numVertices);
+
+	// Returns the offset of a range of the given size or INVALID_OFFSET
+	std::size_t allocate(std::size_t rangeSize);
+	void release(std::size_t offset, std::size_t rangeSize);
+
+	// True if no range is in use anymore
+	bool empty() const;
+
+	// Triangulates the given winding into the range at the given offset,
+	// returns the number of indices written
+	std::size_t update(std::size_t offset, const Winding& winding);
+
+	// Draws the given number of indices, starting at the range at the given offset
+	void render(const RenderInfo& info, std::size_t offset, std::size_t numIndices) const;
+
+	// OpenGLRenderBatch implementation
+	void renderBatch(const RenderInfo& info,
+		const std::vector<const OpenGLRenderable*>& renderables) const override;
+
+private:
+	// Uploads the pending updates to the bound buffers, growing them if necessary
+	void upload() const;
+
+	// Drops the updates overwritten by later ones, for pages not being drawn for a while
+	void discardOverwrittenUpdates();
+
+	// Uploads the changes, binds the buffers and sets the array pointers
+	void bind(const RenderInfo& info) const;
+	void unbind(const RenderInfo& info) const;
+};
+
+/**
+ * The FaceGeometryPages of all the brush faces, organised in one
+ * bucket of pages per material, so the faces of one material are drawn
+ * from as few buffers as possible. Pages are removed as soon as they are
+ * empty, such that no GL objects remain once the map is unloaded.
+ */
+class BrushGeometryStore :
+	public util::Noncopyable
+{
+private:
+	typedef std::vector<std::unique_ptr<FaceGeometryPage>> Pages;
+	std::map<string::InternedString, Pages, string::InternedStringLessNoCase> _buckets;
+
+public:
+	// Allocates a range of the given size in a page of the given material
+	FaceGeometryPage& allocate(const string::InternedString& material, std::size_t rangeSize, std::size_t& offset);
+
+	// Releases the range, the page must belong to the bucket of the given material
+	void release(const string::InternedString& material, FaceGeometryPage& page,
+		std::size_t offset, std::size_t rangeSize);
+
+	static BrushGeometryStore& Instance();
+};
+
+/**
+ * The triangulated geometry of a single face, living in a page of
+ * the BrushGeometryStore. This is the renderable submitted for the solid
+ * rendering of the face.
+ */
+class FaceGeometry :
+	public OpenGLRenderable,
+	public util::Noncopyable
+{
+private:
+	string::InternedString _material;
+
+	FaceGeometryPage* _page;
+	std::size_t _offset;
+	std::size_t _rangeSize;
+
+	std::size_t _numIndices;
+
+public:
+	FaceGeometry();
+	~FaceGeometry();
+
+	// Writes the given winding to the page of the given material
+	void update(const Winding& winding, const string::InternedString& material);
+
+	// Gives the range back to the store
+	void clear();
+
+	std::size_t getOffset() const
+	{
+		return _offset;
+	}
+
+	std::size_t getNumIndices() const
+	{
+		return _numIndices;
+	}
+
+	// OpenGLRenderable implementation
+	void render(const RenderInfo& info) const override;
+	const OpenGLRenderBatch* getRenderBatch() const override;
+};
+
+}
@@ -42,11 +42,43 @@ public:
 		}
 	}
 
+	// Resolves the edge indices and writes single-precision lines
+	bool writeToStream(const RenderInfo& info, RenderStream& stream) const
+	{
+		// There are no texture coordinates or normals to stream
+		if (RenderStream::needsFullVertices(info)) return false;
+
+		if (m_size == 0) return true;
+
+		RenderStream::Vertex* vertex = stream.addPrimitive(GL_LINES, m_size << 1,
+			info.checkFlag(RENDER_VERTEX_COLOUR));
+
+		for (std::size_t i = 0; i < m_size; ++i)
+		{
+			writeVertex(*vertex++, m_vertices[m_faceVertex[i].first]);
+			writeVertex(*vertex++, m_vertices[m_faceVertex[i].second]);
+		}
+
+		return true;
+	}
+
 	std::vector<EdgeRenderIndices> m_faceVertex;
 	std::size_t m_size;
 	const VertexCb* m_vertices;
 
 	virtual ~RenderableWireframe() {}
+
+private:
+	static void writeVertex(RenderStream::Vertex& vertex, const VertexCb& source)
+	{
+		vertex.vertex[0] = static_cast<float>(source.vertex.x());
+		vertex.vertex[1] = static_cast<float>(source.vertex.y());
+		vertex.vertex[2] = static_cast<float>(source.vertex.z());
+		vertex.colour[0] = source.colour.r;
+		vertex.colour[1] = source.colour.g;
+		vertex.colour[2] = source.colour.b;
+		vertex.colour[3] = source.colour.a;
+	}
 };
 
 #endif /*RENDERABLEWIREFRAME_H_*/
@@ -137,6 +137,59 @@ void Winding::render(const RenderInfo& info) const
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 }
 
+bool Winding::writeToStream(const RenderInfo& info, RenderStream& stream) const
+{
+	if (empty())
+	{
+		return true;
+	}
+
+	// Our vertex colours are always white, see render()
+	bool useColours = info.checkFlag(RENDER_VERTEX_COLOUR);
+
+	if (!RenderStream::needsFullVertices(info))
+	{
+		RenderStream::Vertex* vertex = stream.addPrimitive(GL_POLYGON, size(), useColours);
+
+		for (const WindingVertex& wv : *this)
+		{
+			for (std::size_t i = 0; i < 3; ++i)
+			{
+				vertex->vertex[i] = static_cast<float>(wv.vertex[i]);
+				vertex->colour[i] = 255;
+			}
+
+			vertex->colour[3] = 255;
+
+			++vertex;
+		}
+
+		return true;
+	}
+
+	RenderStream::FullVertex* vertex = stream.addFullPrimitive(GL_POLYGON, size(), useColours);
+
+	for (const WindingVertex& wv : *this)
+	{
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			vertex->vertex[i] = static_cast<float>(wv.vertex[i]);
+			vertex->normal[i] = static_cast<float>(wv.normal[i]);
+			vertex->tangent[i] = static_cast<float>(wv.tangent[i]);
+			vertex->bitangent[i] = static_cast<float>(wv.bitangent[i]);
+			vertex->colour[i] = 255;
+		}
+
+		vertex->texcoord[0] = static_cast<float>(wv.texcoord[0]);
+		vertex->texcoord[1] = static_cast<float>(wv.texcoord[1]);
+		vertex->colour[3] = 255;
+
+		++vertex;
+	}
+
+	return true;
+}
+
 void Winding::testSelect(SelectionTest& test, SelectionIntersection& best)
 {
 	if (empty()) return;
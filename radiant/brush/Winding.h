@@ -58,6 +58,9 @@ public:
 	// Submits this winding to OpenGL
 	void render(const RenderInfo& info) const;
 
+	// Writes this winding as polygon to the given stream
+	bool writeToStream(const RenderInfo& info, RenderStream& stream) const;
+
 	// Submits the wireframe render commands to OpenGL
 	void drawWireframe() const;
 
@@ -7,6 +7,7 @@
 #include "ieventmanager.h"
 #include "imainframe.h"
 #include "itextstream.h"
+#include "iprofiler.h"
 
 #include <time.h>
 #include <fmt/format.h>
@@ -21,6 +22,7 @@
 #include "GlobalCamera.h"
 #include "render/RenderStatistics.h"
 #include "render/frontend/RenderableCollectionWalker.h"
+#include "scene/Node.h"
 #include "wxutil/MouseButton.h"
 #include "registry/adaptors.h"
 #include "selection/OccludeSelector.h"
@@ -587,6 +589,7 @@ void CamWnd::Cam_Draw()
     render::RenderStatistics::Instance().resetStats();
 
     render::View::resetCullStats();
+    scene::Node::resetBoundsStatistics();
 
     glMatrixMode(GL_PROJECTION);
 
@@ -684,7 +687,12 @@ void CamWnd::Cam_Draw()
         CamRenderer renderer(allowedRenderFlags, _primitiveHighlightShader,
                              _faceHighlightShader, _view.getViewer());
 
-        render::RenderableCollectionWalker::CollectRenderablesInScene(renderer, _view);
+        if (!_visibleSet)
+        {
+            _visibleSet = GlobalSceneGraph().createVisibleSetCache();
+        }
+
+        render::RenderableCollectionWalker::CollectRenderablesInScene(renderer, _view, *_visibleSet);
 
         // Render any active mousetools
         for (const ActiveMouseTools::value_type& i : _activeMouseTools)
@@ -764,6 +772,14 @@ void CamWnd::Cam_Draw()
 
     GlobalOpenGL().drawString(render::View::getCullStats());
 
+    glRasterPos3f(1.0f, static_cast<float>(_camera.height) - 21.0f, 0.0f);
+
+    const scene::Node::BoundsStatistics& boundsStats = scene::Node::getBoundsStatistics();
+
+    GlobalOpenGL().drawString(fmt::format("child bounds: full {0:d} ({1:d} children) | incremental {2:d} ({3:d} children)",
+        boundsStats.fullEvaluations, boundsStats.childrenTraversed,
+        boundsStats.incrementalUpdates, boundsStats.childrenMerged));
+
     drawTime();
 
     if (!_activeMouseTools.empty())
@@ -798,6 +814,7 @@ void CamWnd::draw()
     {
         debug::assertNoGlErrors();
 
+        profile::ScopedSpan span("Camera frame", "render");
         Cam_Draw();
 
         debug::assertNoGlErrors();
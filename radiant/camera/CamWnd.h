@@ -53,6 +53,9 @@ private:
 
     render::View _view;
 
+    // The scene nodes found in the view during the last redraw
+    scene::IVisibleSetCachePtr _visibleSet;
+
     // The contained camera
     Camera _camera;
 
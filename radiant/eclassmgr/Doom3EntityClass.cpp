@@ -361,7 +361,7 @@ void Doom3EntityClass::forEachClassAttribute(
          ++i)
     {
         // Visit if it is a non-editor key or we are visiting all keys
-        if (editorKeys || !string::istarts_with(*i->first, "editor_"))
+        if (editorKeys || !string::istarts_with(i->first.str(), "editor_"))
         {
             visitor(i->second);
         }
@@ -466,9 +466,14 @@ bool Doom3EntityClass::isOfType(const std::string& className)
 // Find a single attribute
 EntityClassAttribute& Doom3EntityClass::getAttribute(const std::string& name)
 {
-    StringPtr ref(new std::string(name));
+    string::InternedString key;
 
-    EntityAttributeMap::iterator f = _attributes.find(ref);
+    if (!string::InternedString::Find(name, key))
+    {
+        return _emptyAttribute;
+    }
+
+    EntityAttributeMap::iterator f = _attributes.find(key);
 
     return (f != _attributes.end()) ? f->second : _emptyAttribute;
 }
@@ -476,9 +481,14 @@ EntityClassAttribute& Doom3EntityClass::getAttribute(const std::string& name)
 // Find a single attribute
 const EntityClassAttribute& Doom3EntityClass::getAttribute(const std::string& name) const
 {
-    StringPtr ref(new std::string(name));
+    string::InternedString key;
+
+    if (!string::InternedString::Find(name, key))
+    {
+        return _emptyAttribute;
+    }
 
-    EntityAttributeMap::const_iterator f = _attributes.find(ref);
+    EntityAttributeMap::const_iterator f = _attributes.find(key);
 
     return (f != _attributes.end()) ? f->second : _emptyAttribute;
 }
@@ -605,4 +615,27 @@ void Doom3EntityClass::parseFromTokens(parser::DefTokeniser& tokeniser)
     _changedSignal.emit();
 }
 
+void Doom3EntityClass::takeContentsFrom(Doom3EntityClass& other)
+{
+    // The name and the parent pointer are kept, as in parseFromTokens()
+    _isLight = other._isLight;
+    _colour = other._colour;
+    _colourTransparent = other._colourTransparent;
+    _fillShader = std::move(other._fillShader);
+    _wireShader = std::move(other._wireShader);
+    _fixedSize = other._fixedSize;
+    _attributes = std::move(other._attributes);
+    _model = std::move(other._model);
+    _skin = std::move(other._skin);
+    _inheritanceResolved = other._inheritanceResolved;
+    _modName = std::move(other._modName);
+    _attachments = std::move(other._attachments);
+
+    other._attachments.reset(new Attachments(other._name));
+    other.clear();
+
+    // Notify the observers
+    _changedSignal.emit();
+}
+
 } // namespace eclass
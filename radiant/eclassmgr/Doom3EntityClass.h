@@ -30,18 +30,6 @@ typedef std::shared_ptr<Doom3EntityClass> Doom3EntityClassPtr;
 class Doom3EntityClass
 : public IEntityClass
 {
-    typedef std::shared_ptr<std::string> StringPtr;
-
-    class StringCompareFunctor
-    {
-    public:
-        bool operator()(const StringPtr& lhs, const StringPtr& rhs) const
-        {
-            //return boost::algorithm::ilexicographical_compare(lhs, rhs); // this is slow!
-            return string_compare_nocase(lhs->c_str(), rhs->c_str()) < 0;
-        }
-    };
-
     // The name of this entity class
     std::string _name;
 
@@ -69,16 +57,13 @@ class Doom3EntityClass
     // Map of named EntityAttribute structures. EntityAttributes are picked
     // up from the DEF file during parsing. Ignores key case.
 
-    // greebo: I've changed the EntityAttributeMap key type to StringPtr, to save
+    // The EntityAttributeMap is keyed by the interned attribute name, to save
     // more than 130 MB of string data used for just the keys. A default TDM installation
     // has about 780k entity class attributes after resolving inheritance.
-    // However, the memory saving comes with a performance cost since we need 
-    // to convert the incoming std::string queries to StringRefs before passing
-    // them to std::map::find(). During a regular DarkRadiant startup 
-    // there are about 64k find() operations, a single idLight
-    // creation costs about 30-40 find() operations, which is ok I guess.
+    // Queries are looked up in the string pool first, a name which has never been
+    // interned cannot be an attribute, so no map lookup is needed at all.
 
-    typedef std::map<StringPtr, EntityClassAttribute, StringCompareFunctor> EntityAttributeMap;
+    typedef std::map<string::InternedString, EntityClassAttribute, string::InternedStringLessNoCase> EntityAttributeMap;
     EntityAttributeMap _attributes;
 
     // The model and skin for this entity class (if it has one)
@@ -210,6 +195,11 @@ public:
     // Initialises this class from the given tokens
     void parseFromTokens(parser::DefTokeniser& tokeniser);
 
+    // Replaces the contents of this class with the ones of the given class
+    // (which has been freshly parsed), leaving the other class empty.
+    // This instance stays valid, observers are notified about the change.
+    void takeContentsFrom(Doom3EntityClass& other);
+
     void setParseStamp(std::size_t parseStamp)
     {
         _parseStamp = parseStamp;
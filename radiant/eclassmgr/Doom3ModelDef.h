@@ -45,6 +45,19 @@ public:
 		modName = "base";
 	}
 
+	// Replaces the contents of this modelDef with the ones of the given one (except the name)
+	void takeContentsFrom(Doom3ModelDef& other)
+	{
+		resolved = other.resolved;
+		mesh = std::move(other.mesh);
+		skin = std::move(other.skin);
+		parent = std::move(other.parent);
+		anims = std::move(other.anims);
+		modName = std::move(other.modName);
+
+		other.clear();
+	}
+
 	// Reads the data from the given tokens into the member variables
 	void parseFromTokens(parser::DefTokeniser& tokeniser)
 	{
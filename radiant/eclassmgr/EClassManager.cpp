@@ -10,6 +10,7 @@
 #include "iradiant.h"
 #include "iuimanager.h"
 #include "ifilesystem.h"
+#include "ithread.h"
 #include "parser/DefTokeniser.h"
 
 #include "Doom3EntityClass.h"
@@ -17,6 +18,7 @@
 
 #include "string/case_conv.h"
 #include <functional>
+#include <algorithm>
 
 #include "debugging/ScopedDebugTimer.h"
 #include "modulesystem/StaticModule.h"
@@ -26,7 +28,7 @@ namespace eclass {
 // Constructor
 EClassManager::EClassManager() :
     _realised(false),
-    _defLoader(std::bind(&EClassManager::loadDefAndResolveInheritance, this)),
+    _defLoader(std::bind(&EClassManager::loadDefAndResolveInheritance, this), "Entity definitions"),
 	_curParseStamp(0)
 {}
 
@@ -131,10 +133,47 @@ void EClassManager::parseDefFiles()
 
 	{
 		ScopedDebugTimer timer("EntityDefs parsed: ");
+
+		std::vector<std::string> filenames;
+
         GlobalFileSystem().forEachFile(
             "def/", "def",
-            [&](const vfs::FileInfo& fileInfo) { parseFile(fileInfo.name); }
+            [&](const vfs::FileInfo& fileInfo) { filenames.push_back(fileInfo.name); }
         );
+
+		// Open the files and look up their mod names here, the mod name is
+		// derived from the registry which is not meant to be accessed by the workers
+		std::vector<ArchiveTextFilePtr> files(filenames.size());
+		std::vector<std::string> modNames(filenames.size());
+
+		for (std::size_t i = 0; i < filenames.size(); ++i)
+		{
+			files[i] = GlobalFileSystem().openTextFile("def/" + filenames[i]);
+
+			if (files[i])
+			{
+				modNames[i] = files[i]->getModName();
+			}
+		}
+
+		// Parse the files on all cores, each into its own result
+		std::vector<ParsedDefFile> results(filenames.size());
+
+		GlobalThreadManager().parallelForEach(filenames.size(), [&](std::size_t i)
+		{
+			if (!files[i]) return;
+
+			parseFile(*files[i], modNames[i], results[i]);
+
+			// Close the file right away
+			files[i].reset();
+		});
+
+		// Merge the results in VFS order, for the definitions to override each other as before
+		for (std::size_t i = 0; i < filenames.size(); ++i)
+		{
+			mergeParsedDefs(filenames[i], results[i]);
+		}
 	}
 }
 
@@ -148,25 +187,46 @@ void EClassManager::resolveInheritance()
 
     // Resolve inheritance for the entities. At this stage the classes
     // will have the name of their parent, but not an actual pointer to
-    // it
+    // it. Sort them into generations, the classes of one generation only
+    // depend on the ones before, so each generation can be resolved in parallel.
+    std::map<const Doom3EntityClass*, int> depths;
+    std::vector<std::vector<Doom3EntityClass*>> generations;
+
     for (EntityClasses::value_type& pair : _entityClasses)
-	{
-		// Tell the class to resolve its own inheritance using the given
-		// map as a source for parent lookup
-        pair.second->resolveInheritance(_entityClasses);
+    {
+        std::size_t depth = static_cast<std::size_t>(getInheritanceDepth(*pair.second, depths));
 
-        // If the entity has a model path ("model" key), lookup the actual
-        // model and apply its mesh and skin to this entity.
-        if (!pair.second->getModelPath().empty())
+        if (generations.size() <= depth)
         {
-            Models::iterator j = _models.find(pair.second->getModelPath());
+            generations.resize(depth + 1);
+        }
 
-            if (j != _models.end())
+        generations[depth].push_back(pair.second.get());
+    }
+
+    for (const std::vector<Doom3EntityClass*>& generation : generations)
+    {
+        GlobalThreadManager().parallelForEach(generation.size(), [&](std::size_t i)
+        {
+            Doom3EntityClass& eclass = *generation[i];
+
+            // Tell the class to resolve its own inheritance using the given
+            // map as a source for parent lookup
+            eclass.resolveInheritance(_entityClasses);
+
+            // If the entity has a model path ("model" key), lookup the actual
+            // model and apply its mesh and skin to this entity.
+            if (!eclass.getModelPath().empty())
             {
-                pair.second->setModelPath(j->second->mesh);
-                pair.second->setSkin(j->second->skin);
+                Models::const_iterator j = _models.find(eclass.getModelPath());
+
+                if (j != _models.end())
+                {
+                    eclass.setModelPath(j->second->mesh);
+                    eclass.setSkin(j->second->skin);
+                }
             }
-        }
+        });
     }
 
 	// greebo: Override the eclass colours of two special entityclasses
@@ -188,6 +248,38 @@ void EClassManager::resolveInheritance()
 	}
 }
 
+int EClassManager::getInheritanceDepth(const Doom3EntityClass& eclass,
+    std::map<const Doom3EntityClass*, int>& depths)
+{
+    auto found = depths.find(&eclass);
+
+    if (found != depths.end())
+    {
+        // A class which is still being looked at is part of a cycle,
+        // resolveInheritance() will deal with it as part of the first generation
+        return std::max(found->second, 0);
+    }
+
+    depths[&eclass] = -1;
+
+    int depth = 0;
+    std::string parentName = eclass.getAttribute("inherit").getValue();
+
+    if (!parentName.empty() && parentName != eclass.getName())
+    {
+        EntityClasses::const_iterator parent = _entityClasses.find(parentName);
+
+        if (parent != _entityClasses.end())
+        {
+            depth = getInheritanceDepth(*parent->second, depths) + 1;
+        }
+    }
+
+    depths[&eclass] = depth;
+
+    return depth;
+}
+
 void EClassManager::ensureDefsLoaded()
 {
     assert(_realised);
@@ -297,6 +389,7 @@ const StringSet& EClassManager::getDependencies() const {
 		_dependencies.insert(MODULE_UIMANAGER);
 		_dependencies.insert(MODULE_EVENTMANAGER);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
+		_dependencies.insert(MODULE_THREADMANAGER);
 	}
 
 	return _dependencies;
@@ -353,11 +446,13 @@ void EClassManager::onFileSystemShutdown()
 
 // Parse the provided stream containing the contents of a single .def file.
 // Extract all entitydefs and create objects accordingly.
-void EClassManager::parse(TextInputStream& inStr, const std::string& modDir)
+void EClassManager::parse(TextInputStream& inStr, const std::string& modDir, ParsedDefFile& result)
 {
-	// Construct a tokeniser for the stream
+	// Load the file into memory and construct a tokeniser working on it
 	std::istream is(&inStr);
-    parser::BasicDefTokeniser<std::istream> tokeniser(is);
+	std::string contents((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+    parser::BasicDefTokeniser<std::string_view> tokeniser(contents);
 
     while (tokeniser.hasMoreTokens())
 	{
@@ -370,100 +465,100 @@ void EClassManager::parse(TextInputStream& inStr, const std::string& modDir)
 			const std::string sName =
     			string::to_lower_copy(tokeniser.nextToken());
 
-			// Ensure that an Entity class with this name already exists
-			// When reloading entityDef declarations, most names will already be registered
-			EntityClasses::iterator i = _entityClasses.find(sName);
-
-			if (i == _entityClasses.end())
-			{
-				// Not existing yet, allocate a new class
-        		Doom3EntityClassPtr entityClass(new eclass::Doom3EntityClass(sName));
-
-				std::pair<EntityClasses::iterator, bool> result = _entityClasses.insert(
-					EntityClasses::value_type(sName, entityClass)
-				);
-
-				i = result.first;
-			}
-			else
-			{
-				// EntityDef already exists, compare the parse stamp
-				if (i->second->getParseStamp() == _curParseStamp)
-				{
-					rWarning() << "[eclassmgr]: EntityDef "
-						<< sName << " redefined" << std::endl;
-				}
-			}
-
-			// At this point, i is pointing to a valid entityclass
-
-			i->second->setParseStamp(_curParseStamp);
+			// Allocate a new class, which is merged into the existing one later.
+			// It is kept even if parsing fails halfway through.
+			Doom3EntityClassPtr entityClass(new eclass::Doom3EntityClass(sName));
+			result.entityClasses.push_back(entityClass);
 
         	// Parse the contents of the eclass (excluding name)
-			i->second->parseFromTokens(tokeniser);
+			entityClass->parseFromTokens(tokeniser);
 
 			// Set the mod directory
-        	i->second->setModName(modDir);
+        	entityClass->setModName(modDir);
         }
         else if (blockType == "model")
 		{
 			// Read the name
 			std::string modelDefName = tokeniser.nextToken();
 
-			// Ensure that an Entity class with this name already exists
-			// When reloading entityDef declarations, most names will already be registered
-			Models::iterator i = _models.find(modelDefName);
+			// Allocate an empty ModelDef
+			Doom3ModelDefPtr model(new Doom3ModelDef(modelDefName));
+			result.models.push_back(model);
 
-			if (i == _models.end())
-			{
-				// Does not exist yet, allocate a new one
+        	model->parseFromTokens(tokeniser);
+			model->setModName(modDir);
+        }
+    }
+}
 
-				// Allocate an empty ModelDef
-        		Doom3ModelDefPtr model(new Doom3ModelDef(modelDefName));
+void EClassManager::parseFile(ArchiveTextFile& file, const std::string& modName, ParsedDefFile& result)
+{
+	try
+    {
+		// Parse entity defs from the file
+		parse(file.getInputStream(), modName, result);
+	}
+    catch (parser::ParseException& e)
+    {
+		result.error = e.what();
+	}
+}
 
-				std::pair<Models::iterator, bool> result = _models.insert(
-					Models::value_type(modelDefName, model)
-				);
+void EClassManager::mergeParsedDefs(const std::string& filename, ParsedDefFile& parsed)
+{
+	for (const Doom3EntityClassPtr& entityClass : parsed.entityClasses)
+	{
+		// When reloading entityDef declarations, most names will already be registered
+		EntityClasses::iterator i = _entityClasses.find(entityClass->getName());
 
-				i = result.first;
-			}
-			else
+		if (i == _entityClasses.end())
+		{
+			// Not existing yet, take the new class
+			i = _entityClasses.insert(EntityClasses::value_type(entityClass->getName(), entityClass)).first;
+		}
+		else
+		{
+			// EntityDef already exists, compare the parse stamp
+			if (i->second->getParseStamp() == _curParseStamp)
 			{
-				// Model already exists, compare the parse stamp
-				if (i->second->getParseStamp() == _curParseStamp)
-				{
-					rWarning() << "[eclassmgr]: Model "
-						<< modelDefName << " redefined" << std::endl;
-				}
+				rWarning() << "[eclassmgr]: EntityDef "
+					<< i->first << " redefined" << std::endl;
 			}
 
-			// Model structure is allocated and in the map,
-            // invoke the parser routine
-			i->second->setParseStamp(_curParseStamp);
+			// Keep the existing instance, it receives the new contents
+			i->second->takeContentsFrom(*entityClass);
+		}
 
-        	i->second->parseFromTokens(tokeniser);
-			i->second->setModName(modDir);
-        }
-    }
-}
+		i->second->setParseStamp(_curParseStamp);
+	}
 
-void EClassManager::parseFile(const std::string& filename)
-{
-	const std::string fullname = "def/" + filename;
+	for (const Doom3ModelDefPtr& model : parsed.models)
+	{
+		Models::iterator i = _models.find(model->name);
 
-	ArchiveTextFilePtr file = GlobalFileSystem().openTextFile(fullname);
+		if (i == _models.end())
+		{
+			i = _models.insert(Models::value_type(model->name, model)).first;
+		}
+		else
+		{
+			// Model already exists, compare the parse stamp
+			if (i->second->getParseStamp() == _curParseStamp)
+			{
+				rWarning() << "[eclassmgr]: Model "
+					<< i->first << " redefined" << std::endl;
+			}
 
-	if (!file) return;
+			i->second->takeContentsFrom(*model);
+		}
 
-	try
-    {
-		// Parse entity defs from the file
-		parse(file->getInputStream(), file->getModName());
+		i->second->setParseStamp(_curParseStamp);
 	}
-    catch (parser::ParseException& e)
-    {
+
+	if (!parsed.error.empty())
+	{
 		rError() << "[eclassmgr] failed to parse " << filename
-				 << " (" << e.what() << ")" << std::endl;
+				 << " (" << parsed.error << ")" << std::endl;
 	}
 }
 
@@ -80,10 +80,18 @@ public:
     virtual void initialiseModule(const ApplicationContext& ctx) override;
     virtual void shutdownModule() override;
 
-	// Method loading the DEF files
-    void parseFile(const std::string& filename);
-
 private:
+    // The definitions found in a single DEF file. These are parsed into
+    // new objects by the worker threads, and merged into the maps afterwards.
+    struct ParsedDefFile
+    {
+        std::vector<Doom3EntityClassPtr> entityClasses;
+        std::vector<Doom3ModelDefPtr> models;
+
+        // Set if parsing stopped early
+        std::string error;
+    };
+
     // Since loading is happening in a worker thread, we need to ensure
     // that it's done loading before accessing any defs or models.
     void ensureDefsLoaded();
@@ -96,8 +104,15 @@ private:
 	Doom3EntityClassPtr insertUnique(const Doom3EntityClassPtr& eclass);
     Doom3EntityClassPtr findInternal(const std::string& name);
 
-	// Parses the given inputstream for DEFs.
-	void parse(TextInputStream& inStr, const std::string& modDir);
+	// Parses the given inputstream for DEFs, this doesn't touch the maps
+	static void parse(TextInputStream& inStr, const std::string& modDir, ParsedDefFile& result);
+
+	// Parses the given DEF file, whose mod name has been looked up by the caller
+	static void parseFile(ArchiveTextFile& file, const std::string& modName, ParsedDefFile& result);
+
+	// Adds the parsed definitions to the maps. Existing objects are kept
+	// and take over the parsed contents, so that all pointers remain valid.
+	void mergeParsedDefs(const std::string& filename, ParsedDefFile& parsed);
 
 	// Recursively resolves the inheritance of the model defs
 	void resolveModelInheritance(const std::string& name, const Doom3ModelDefPtr& model);
@@ -105,6 +120,11 @@ private:
 	void parseDefFiles();
 	void resolveInheritance();
 
+	// Returns the number of ancestors of the given class, for the parallel
+	// inheritance resolution. The map holds the depths determined so far.
+	int getInheritanceDepth(const Doom3EntityClass& eclass,
+		std::map<const Doom3EntityClass*, int>& depths);
+
 	void reloadDefsCmd(const cmd::ArgumentList& args);
 };
 typedef std::shared_ptr<EClassManager> EClassManagerPtr;
@@ -326,7 +326,7 @@ void Doom3Entity::erase(const KeyValues::iterator& i)
 	}
 
 	// Retrieve the key and value from the vector before deletion
-	std::string key(i->first);
+	string::InternedString key(i->first);
 	KeyValuePtr value(i->second);
 
 	// Actually delete the object from the list
@@ -353,11 +353,19 @@ void Doom3Entity::erase(const std::string& key)
 
 Doom3Entity::KeyValues::const_iterator Doom3Entity::find(const std::string& key) const
 {
+	string::InternedString internedKey;
+
+	// A key which has never been interned cannot be present
+	if (!string::InternedString::Find(key, internedKey))
+	{
+		return _keyValues.end();
+	}
+
 	for (KeyValues::const_iterator i = _keyValues.begin();
 		 i != _keyValues.end();
 		 ++i)
 	{
-		if (string::iequals(i->first, key))
+		if (i->first.equalsNoCase(internedKey))
 		{
 			return i;
 		}
@@ -369,11 +377,19 @@ Doom3Entity::KeyValues::const_iterator Doom3Entity::find(const std::string& key)
 
 Doom3Entity::KeyValues::iterator Doom3Entity::find(const std::string& key)
 {
+	string::InternedString internedKey;
+
+	// A key which has never been interned cannot be present
+	if (!string::InternedString::Find(key, internedKey))
+	{
+		return _keyValues.end();
+	}
+
 	for (KeyValues::iterator i = _keyValues.begin();
 		 i != _keyValues.end();
 		 ++i)
 	{
-		if (string::iequals(i->first, key))
+		if (i->first.equalsNoCase(internedKey))
 		{
 			return i;
 		}
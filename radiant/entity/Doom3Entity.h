@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "KeyValue.h"
+#include "string/InternedString.h"
 #include <memory>
 
 /** greebo: This is the implementation of the class Entity.
@@ -27,8 +28,9 @@ class Doom3Entity :
 
 	typedef std::shared_ptr<KeyValue> KeyValuePtr;
 
-	// A key value pair using a dynamically allocated value
-	typedef std::pair<std::string, KeyValuePtr> KeyValuePair;
+	// A key value pair using a dynamically allocated value, the keys
+	// are interned as the same few ones are used by all entities
+	typedef std::pair<string::InternedString, KeyValuePtr> KeyValuePair;
 
 	// The unsorted list of KeyValue pairs
 	typedef std::vector<KeyValuePair> KeyValues;
@@ -63,6 +63,10 @@ Vector3& Doom3Group::getOrigin() {
 	return m_origin;
 }
 
+const Vector3& Doom3Group::getOrigin() const {
+	return m_origin;
+}
+
 const Vector3& Doom3Group::getUntransformedOrigin() const
 {
     return m_originKey.get();
@@ -152,6 +152,11 @@ void Doom3GroupNode::removeOriginFromChildren()
 	}
 }
 
+Vector3 Doom3GroupNode::getChildTranslationForExport() const
+{
+	return _d3Group.isModel() ? Vector3(0, 0, 0) : -_d3Group.getOrigin();
+}
+
 void Doom3GroupNode::selectionChangedComponent(const ISelectable& selectable) {
 	GlobalSelectionSystem().onComponentSelection(Node::getSelf(), selectable);
 }
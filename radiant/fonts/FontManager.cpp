@@ -27,7 +27,7 @@ in game descriptor";
 }
 
 FontManager::FontManager() :
-    _loader(std::bind(&FontManager::loadFonts, this)),
+    _loader(std::bind(&FontManager::loadFonts, this), "Fonts"),
 	_curLanguage("english")
 {}
 
@@ -47,6 +47,7 @@ const StringSet& FontManager::getDependencies() const
 		_dependencies.insert(MODULE_XMLREGISTRY);
 		_dependencies.insert(MODULE_GAMEMANAGER);
 		_dependencies.insert(MODULE_SHADERSYSTEM);
+		_dependencies.insert(MODULE_THREADMANAGER);
 	}
 
 	return _dependencies;
@@ -66,6 +67,12 @@ void FontManager::shutdownModule()
     _fonts.clear();
 }
 
+bool FontManager::isInitialisationThreadSafe() const
+{
+    // Nothing but our own state is touched during initialisation
+    return true;
+}
+
 const std::string& FontManager::getCurLanguage()
 {
 	return _curLanguage;
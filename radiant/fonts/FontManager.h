@@ -31,6 +31,7 @@ public:
     const StringSet& getDependencies() const override;
     void initialiseModule(const ApplicationContext& ctx) override;
     void shutdownModule() override;
+    bool isInitialisationThreadSafe() const override;
 
 	// Returns the info structure of a specific font (current language),
 	// returns NULL if no font info is available yet
@@ -22,6 +22,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #include "dds.h"
 
 #include <stdlib.h>
+#include <cstring>
 #include <algorithm>
 
 #include "ifilesystem.h"
@@ -34,6 +35,36 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 namespace image
 {
 
+namespace
+{
+
+// Reads from a block of memory, for the files which can provide their data in place
+class MemoryInputStream :
+	public InputStream
+{
+private:
+	const byte_type* _pos;
+	const byte_type* _end;
+
+public:
+	MemoryInputStream(const byte_type* data, std::size_t length) :
+		_pos(data),
+		_end(data + length)
+	{}
+
+	size_type read(byte_type* buffer, size_type length) override
+	{
+		size_type count = std::min(static_cast<size_type>(_end - _pos), length);
+
+		std::memcpy(buffer, _pos, count);
+		_pos += count;
+
+		return count;
+	}
+};
+
+}
+
 DDSImagePtr LoadDDSFromStream(InputStream& stream)
 {
 	int width(0), height(0);
@@ -115,6 +146,15 @@ DDSImagePtr LoadDDSFromStream(InputStream& stream)
 }
 
 ImagePtr LoadDDS(ArchiveFile& file) {
+	const InputStream::byte_type* data = file.getData();
+
+	if (data != nullptr)
+	{
+		// Copy the mipmaps straight from the file data
+		MemoryInputStream stream(data, file.size());
+		return LoadDDSFromStream(stream);
+	}
+
 	return LoadDDSFromStream(file.getInputStream());
 }
 
@@ -0,0 +1,346 @@
+#include "Profiler.h"
+
+#include "itextstream.h"
+#include "registry/registry.h"
+#include "modulesystem/ModuleRegistry.h"
+#include "modulesystem/StaticModule.h"
+
+#include <fstream>
+#include <algorithm>
+#include <fmt/format.h>
+
+namespace applog
+{
+
+namespace
+{
+	// Upper limit of recorded spans, to not run out of memory when
+	// recording rendered frames for a long time
+	const std::size_t MAX_SPANS = 1 << 20;
+
+	// Whether to keep recording once the startup is done
+	const char* const RKEY_PROFILER_ENABLED = "user/ui/profiler/recordAfterStartup";
+
+	// The spans still open on this thread
+	thread_local std::vector<Profiler::Span> _openSpans;
+	thread_local std::size_t _threadId = 0;
+
+	double toMicroseconds(profile::IProfiler::Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::micro>(duration).count();
+	}
+
+	double toMilliseconds(profile::IProfiler::Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	// Quotes the given string for use in JSON
+	std::string quote(const std::string& str)
+	{
+		std::string result("\"");
+
+		for (char c : str)
+		{
+			switch (c)
+			{
+			case '"': result += "\\\""; break;
+			case '\\': result += "\\\\"; break;
+			case '\n': result += "\\n"; break;
+			case '\t': result += "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					result += fmt::format("\\u{0:04x}", static_cast<int>(c));
+				}
+				else
+				{
+					result += c;
+				}
+			}
+		}
+
+		return result + "\"";
+	}
+}
+
+Profiler::Profiler() :
+	_origin(Clock::now()),
+	_enabled(true),
+	_numDroppedSpans(0)
+{}
+
+const std::string& Profiler::getName() const
+{
+	static std::string _name(MODULE_PROFILER);
+	return _name;
+}
+
+const StringSet& Profiler::getDependencies() const
+{
+	static StringSet _dependencies;
+	return _dependencies;
+}
+
+void Profiler::initialiseModule(const ApplicationContext& ctx)
+{
+	rMessage() << getName() << "::initialiseModule called." << std::endl;
+
+	_mainThread = std::this_thread::get_id();
+	_defaultTraceFile = ctx.getSettingsPath() + "profile.json";
+
+	module::ModuleRegistry::Instance().signal_allModulesInitialised().connect(
+		sigc::mem_fun(this, &Profiler::postModuleInitialisation)
+	);
+}
+
+void Profiler::postModuleInitialisation()
+{
+	GlobalCommandSystem().addCommand("ProfilerSummary",
+		std::bind(&Profiler::writeSummaryCmd, this, std::placeholders::_1));
+	GlobalCommandSystem().addCommand("ProfilerWriteTrace",
+		std::bind(&Profiler::writeChromeTraceCmd, this, std::placeholders::_1),
+		{ cmd::ARGTYPE_STRING | cmd::ARGTYPE_OPTIONAL });
+	GlobalCommandSystem().addCommand("ProfilerClear",
+		std::bind(&Profiler::clearCmd, this, std::placeholders::_1));
+	GlobalCommandSystem().addCommand("ProfilerToggle",
+		std::bind(&Profiler::toggleCmd, this, std::placeholders::_1));
+
+	setEnabled(registry::getValue<bool>(RKEY_PROFILER_ENABLED));
+
+	// Show where the startup time went
+	TemporaryThreadsafeStream stream = rMessage();
+
+	stream << "[profiler] Startup summary:" << std::endl;
+	writeSummary(stream);
+}
+
+bool Profiler::isEnabled() const
+{
+	return _enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+	_enabled = enabled;
+}
+
+std::size_t Profiler::beginSpan(const std::string& name, const std::string& category)
+{
+	Span span;
+	span.name = name;
+	span.category = category;
+	span.threadId = getCurrentThreadId();
+	span.depth = _openSpans.size();
+	span.start = Clock::now();
+
+	_openSpans.emplace_back(std::move(span));
+
+	// The handle is the stack size including the new span
+	return _openSpans.size();
+}
+
+void Profiler::endSpan(std::size_t handle)
+{
+	Clock::time_point end = Clock::now();
+
+	// Close the given span, as well as any nested ones which have been left open
+	while (!_openSpans.empty() && _openSpans.size() >= handle)
+	{
+		Span span = std::move(_openSpans.back());
+		_openSpans.pop_back();
+
+		span.end = end;
+		addSpan(std::move(span));
+	}
+}
+
+void Profiler::recordSpan(const std::string& name, const std::string& category,
+	Clock::time_point start, Clock::time_point end)
+{
+	if (!isEnabled()) return;
+
+	Span span;
+	span.name = name;
+	span.category = category;
+	span.threadId = getCurrentThreadId();
+	span.depth = _openSpans.size();
+	span.start = start;
+	span.end = end;
+
+	addSpan(std::move(span));
+}
+
+void Profiler::clear()
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	_spans.clear();
+	_numDroppedSpans = 0;
+}
+
+void Profiler::writeChromeTrace(std::ostream& stream)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	// Name the threads first
+	bool first = true;
+
+	for (const std::map<std::thread::id, std::size_t>::value_type& pair : _threadIds)
+	{
+		std::string threadName = pair.first == _mainThread ?
+			"Main thread" : fmt::format("Thread {0}", pair.second);
+
+		stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+			<< pair.second << ",\"args\":{\"name\":" << quote(threadName) << "}}";
+
+		first = false;
+	}
+
+	for (const Span& span : _spans)
+	{
+		stream << (first ? "" : ",") << "\n{\"name\":" << quote(span.name)
+			<< ",\"cat\":" << quote(span.category)
+			<< ",\"ph\":\"X\",\"pid\":1,\"tid\":" << span.threadId
+			<< fmt::format(",\"ts\":{0:.3f},\"dur\":{1:.3f}}}",
+				toMicroseconds(span.start - _origin), toMicroseconds(span.end - span.start));
+
+		first = false;
+	}
+
+	stream << "\n]}\n";
+}
+
+void Profiler::writeSummary(std::ostream& stream)
+{
+	struct Entry
+	{
+		std::string category;
+		std::string name;
+		std::size_t depth;
+		std::size_t count;
+		double total;
+		double max;
+	};
+
+	std::vector<Entry> entries;
+	std::size_t numDroppedSpans = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		std::map<std::pair<std::string, std::string>, std::size_t> index;
+
+		for (const Span& span : _spans)
+		{
+			double duration = toMilliseconds(span.end - span.start);
+
+			auto result = index.insert(std::make_pair(std::make_pair(span.category, span.name), entries.size()));
+
+			if (result.second)
+			{
+				entries.push_back(Entry{ span.category, span.name, span.depth, 0, 0.0, 0.0 });
+			}
+
+			Entry& entry = entries[result.first->second];
+
+			entry.depth = std::min(entry.depth, span.depth);
+			entry.count++;
+			entry.total += duration;
+			entry.max = std::max(entry.max, duration);
+		}
+
+		numDroppedSpans = _numDroppedSpans;
+	}
+
+	// Group by category, the most expensive spans first
+	std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+	{
+		return a.category != b.category ? a.category < b.category : a.total > b.total;
+	});
+
+	stream << fmt::format("{0:<12} {1:<48} {2:>8} {3:>12} {4:>10} {5:>10}",
+		"Category", "Span", "Count", "Total (ms)", "Avg (ms)", "Max (ms)") << std::endl;
+
+	for (const Entry& entry : entries)
+	{
+		// Nested spans are indented by their depth
+		std::string name = std::string(std::min<std::size_t>(entry.depth, 8) * 2, ' ') + entry.name;
+
+		stream << fmt::format("{0:<12} {1:<48} {2:>8} {3:>12.1f} {4:>10.2f} {5:>10.2f}",
+			entry.category, name, entry.count, entry.total, entry.total / entry.count, entry.max) << std::endl;
+	}
+
+	if (numDroppedSpans > 0)
+	{
+		stream << numDroppedSpans << " spans have been dropped, the limit is " << MAX_SPANS << std::endl;
+	}
+}
+
+std::size_t Profiler::getCurrentThreadId()
+{
+	if (_threadId == 0)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		auto result = _threadIds.insert(std::make_pair(std::this_thread::get_id(), _threadIds.size() + 1));
+		_threadId = result.first->second;
+	}
+
+	return _threadId;
+}
+
+void Profiler::addSpan(Span&& span)
+{
+	std::lock_guard<std::mutex> lock(_lock);
+
+	if (_spans.size() >= MAX_SPANS)
+	{
+		++_numDroppedSpans;
+		return;
+	}
+
+	_spans.emplace_back(std::move(span));
+}
+
+void Profiler::writeSummaryCmd(const cmd::ArgumentList& args)
+{
+	TemporaryThreadsafeStream stream = rMessage();
+	writeSummary(stream);
+}
+
+void Profiler::writeChromeTraceCmd(const cmd::ArgumentList& args)
+{
+	std::string filename = !args.empty() ? args[0].getString() : _defaultTraceFile;
+
+	std::ofstream stream(filename);
+
+	if (!stream)
+	{
+		rError() << "[profiler] Cannot write to " << filename << std::endl;
+		return;
+	}
+
+	writeChromeTrace(stream);
+
+	rMessage() << "[profiler] Trace written to " << filename << std::endl;
+}
+
+void Profiler::clearCmd(const cmd::ArgumentList& args)
+{
+	clear();
+}
+
+void Profiler::toggleCmd(const cmd::ArgumentList& args)
+{
+	setEnabled(!isEnabled());
+
+	rMessage() << "[profiler] Recording " << (isEnabled() ? "enabled" : "disabled") << std::endl;
+}
+
+// Static module instance
+module::StaticModule<Profiler> profilerModule;
+
+} // namespace applog
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "iprofiler.h"
+#include "icommandsystem.h"
+
+#include <vector>
+#include <map>
+#include <thread>
+
+namespace applog
+{
+
+/**
+ * Implementation of the IProfiler interface. The finished spans of
+ * all threads are collected in one list, the ones still running are kept
+ * in a per-thread stack until they are closed.
+ *
+ * The module has no dependencies and is initialised before all other modules,
+ * so their initialisation is recorded as well. A summary of the startup is
+ * written to the console once all modules are initialised, after that the
+ * recording is only continued if enabled in the registry.
+ */
+class Profiler :
+	public profile::IProfiler
+{
+public:
+	struct Span
+	{
+		std::string name;
+		std::string category;
+		std::size_t threadId;
+		std::size_t depth;
+		Clock::time_point start;
+		Clock::time_point end;
+	};
+
+private:
+	// All times are written relative to this one
+	Clock::time_point _origin;
+
+	std::atomic<bool> _enabled;
+
+	std::mutex _lock;
+	std::vector<Span> _spans;
+	std::size_t _numDroppedSpans;
+
+	// Thread IDs are numbered in order of appearance
+	std::map<std::thread::id, std::size_t> _threadIds;
+	std::thread::id _mainThread;
+
+	std::string _defaultTraceFile;
+
+public:
+	Profiler();
+
+	// RegisterableModule implementation
+	const std::string& getName() const override;
+	const StringSet& getDependencies() const override;
+	void initialiseModule(const ApplicationContext& ctx) override;
+
+	// IProfiler implementation
+	bool isEnabled() const override;
+	void setEnabled(bool enabled) override;
+	std::size_t beginSpan(const std::string& name, const std::string& category) override;
+	void endSpan(std::size_t handle) override;
+	void recordSpan(const std::string& name, const std::string& category,
+		Clock::time_point start, Clock::time_point end) override;
+	void clear() override;
+	void writeChromeTrace(std::ostream& stream) override;
+	void writeSummary(std::ostream& stream) override;
+
+private:
+	std::size_t getCurrentThreadId();
+	void addSpan(Span&& span);
+
+	void postModuleInitialisation();
+
+	// Command targets
+	void writeSummaryCmd(const cmd::ArgumentList& args);
+	void writeChromeTraceCmd(const cmd::ArgumentList& args);
+	void clearCmd(const cmd::ArgumentList& args);
+	void toggleCmd(const cmd::ArgumentList& args);
+};
+
+} // namespace applog
@@ -6,6 +6,7 @@
 #include "mapfile.h"
 #include "itextstream.h"
 #include "iscenegraph.h"
+#include "ithread.h"
 #include "iradiant.h"
 #include "imainframe.h"
 #include "ipreferencesystem.h"
@@ -22,6 +23,8 @@
 #include "string/string.h"
 #include "string/convert.h"
 #include "map/Map.h"
+#include "map/MapSnapshot.h"
+#include "map/algorithm/Traverse.h"
 #include "modulesystem/ApplicationContextImpl.h"
 #include "modulesystem/StaticModule.h"
 #include "wxutil/dialog/MessageBox.h"
@@ -140,10 +143,12 @@ void AutoMapSaver::saveSnapshot()
 
 		rMessage() << "Autosaving snapshot to " << filename << std::endl;
 
-		// Dump to map to the next available filename
-		GlobalMap().saveDirect(filename);
+		// The folder size is checked once the file has been written
+		_snapshotPath = snapshotPath;
+		_snapshotMapName = mapName;
 
-		handleSnapshotSizeLimit(existingSnapshots, snapshotPath, mapName);
+		// Dump to map to the next available filename
+		saveInBackground(filename, true);
 	}
 	else 
 	{
@@ -152,6 +157,62 @@ void AutoMapSaver::saveSnapshot()
 	}
 }
 
+void AutoMapSaver::saveInBackground(const std::string& filename, bool isSnapshot)
+{
+	// Copy the map contents right now, the scene must not be accessed by the worker
+	MapSnapshotPtr snapshot = std::make_shared<MapSnapshot>(
+		*Map::getFormatForFile(filename), GlobalSceneGraph().root(), map::traverse);
+
+	_writeTask = GlobalThreadManager().submit([this, snapshot, filename, isSnapshot]()
+	{
+		wxThreadEvent* event = new wxThreadEvent;
+
+		event->SetString(filename);
+		event->SetInt(isSnapshot ? 1 : 0);
+
+		try
+		{
+			snapshot->writeToFile(filename);
+			event->SetExtraLong(1);
+		}
+		catch (std::runtime_error& ex)
+		{
+			rError() << "AutoSaver: Failed to write " << filename << ": " << ex.what() << std::endl;
+			event->SetExtraLong(0);
+		}
+
+		// Let the main thread know that we're done
+		wxQueueEvent(this, event);
+	}, ThreadManager::Priority::Low);
+}
+
+bool AutoMapSaver::writeInProgress() const
+{
+	return _writeTask.valid() &&
+		_writeTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+void AutoMapSaver::onWriteFinished(wxThreadEvent& ev)
+{
+	std::string filename = ev.GetString().ToStdString();
+
+	if (ev.GetExtraLong() == 0)
+	{
+		wxutil::Messagebox::ShowError(fmt::format(_("Autosave failed, could not write the file {0}"), filename));
+		return;
+	}
+
+	rMessage() << "AutoSaver: Finished writing " << filename << std::endl;
+
+	if (ev.GetInt() != 0)
+	{
+		std::map<int, std::string> existingSnapshots;
+		collectExistingSnapshots(existingSnapshots, _snapshotPath, _snapshotMapName);
+
+		handleSnapshotSizeLimit(existingSnapshots, _snapshotPath, _snapshotMapName);
+	}
+}
+
 void AutoMapSaver::handleSnapshotSizeLimit(const std::map<int, std::string>& existingSnapshots, 
 	const fs::path& snapshotPath, const std::string& mapName)
 {
@@ -253,6 +314,14 @@ void AutoMapSaver::checkSave()
 		return;
 	}
 
+	// Don't queue another save while the last one is still being written
+	if (writeInProgress())
+	{
+		rMessage() << "AutoSaver: The previous save is still in progress, " <<
+			"will wait for another period." << std::endl;
+		return;
+	}
+
 	// Check if the user is currently pressing a mouse button
 	// Don't start the save if the user is holding a mouse button
 	if (wxGetMouseState().ButtonIsDown(wxMOUSE_BTN_ANY)) 
@@ -296,7 +365,7 @@ void AutoMapSaver::checkSave()
 				rMessage() << "Autosaving unnamed map to " << autoSaveFilename << std::endl;
 
 				// Invoke the save call
-				GlobalMap().saveDirect(autoSaveFilename);
+				saveInBackground(autoSaveFilename, false);
 			}
 			else
 			{
@@ -312,7 +381,7 @@ void AutoMapSaver::checkSave()
 				rMessage() << "Autosaving map to " << filename << std::endl;
 
 				// Invoke the save call
-				GlobalMap().saveDirect(filename);
+				saveInBackground(filename, false);
 			}
 		}
 	}
@@ -378,6 +447,7 @@ const StringSet& AutoMapSaver::getDependencies() const
 		_dependencies.insert(MODULE_XMLREGISTRY);
 		_dependencies.insert(MODULE_MAINFRAME);
 		_dependencies.insert(MODULE_RADIANT);
+		_dependencies.insert(MODULE_THREADMANAGER);
 	}
 
 	return _dependencies;
@@ -392,6 +462,7 @@ void AutoMapSaver::initialiseModule(const ApplicationContext& ctx)
 	constructPreferences();
 
 	Connect(wxEVT_TIMER, wxTimerEventHandler(AutoMapSaver::onIntervalReached), NULL, this);
+	Connect(wxEVT_THREAD, wxThreadEventHandler(AutoMapSaver::onWriteFinished), NULL, this);
 
 	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_INTERVAL).connect(
 		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
@@ -425,6 +496,12 @@ void AutoMapSaver::shutdownModule()
 	_enabled = false;
 	stopTimer();
 
+	// Let any pending write finish
+	if (_writeTask.valid())
+	{
+		_writeTask.wait();
+	}
+
 	// Destroy the timer
 	_timer.reset();
 }
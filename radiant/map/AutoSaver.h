@@ -7,6 +7,7 @@
 #include "imap.h"
 
 #include <vector>
+#include <future>
 #include <sigc++/connection.h>
 #include <wx/timer.h>
 #include <wx/sharedptr.h>
@@ -39,6 +40,13 @@ class AutoMapSaver :
 
 	std::vector<sigc::connection> _signalConnections;
 
+	// The worker writing the last snapshot to disk
+	std::future<void> _writeTask;
+
+	// The snapshot folder and map name of the file being written, used for the size check
+	fs::path _snapshotPath;
+	std::string _snapshotMapName;
+
 public:
 	// Constructor
 	AutoMapSaver();
@@ -73,6 +81,15 @@ private:
 	// Saves a snapshot of the currently active map (only named maps)
 	void saveSnapshot();
 
+	// Serialises the current map and writes it to the given file in the background
+	void saveInBackground(const std::string& filename, bool isSnapshot);
+
+	// Returns true if the previous save has not been written to disk yet
+	bool writeInProgress() const;
+
+	// Receives the outcome of the background write on the main thread
+	void onWriteFinished(wxThreadEvent& ev);
+
 	// This gets called when the interval time is over
 	void onIntervalReached(wxTimerEvent& ev);
 
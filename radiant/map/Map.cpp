@@ -5,6 +5,7 @@
 #include <fstream>
 #include "itextstream.h"
 #include "iscenegraph.h"
+#include "ithread.h"
 #include "idialogmanager.h"
 #include "ieventmanager.h"
 #include "imodel.h"
@@ -972,6 +973,7 @@ const StringSet& Map::getDependencies() const
 		_dependencies.insert(MODULE_GAMEMANAGER);
 		_dependencies.insert(MODULE_SCENEGRAPH);
 		_dependencies.insert(MODULE_FILETYPES);
+		_dependencies.insert(MODULE_THREADMANAGER);
     }
 
     return _dependencies;
@@ -0,0 +1,641 @@
+#include "MapCache.h"
+
+#include <cstring>
+#include <sstream>
+#include "itextstream.h"
+#include "ientity.h"
+#include "ieclass.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "scenelib.h"
+
+#include "os/fs.h"
+#include "os/file.h"
+#include "stream/BinaryFile.h"
+#include "format/primitiveparsers/ParsedPrimitive.h"
+
+namespace map
+{
+
+using stream::binary::writeValue;
+using stream::binary::writeString;
+using stream::binary::readData;
+using stream::binary::readValue;
+
+namespace
+{
+	const char CACHE_MAGIC[4] = { 'D', 'R', 'M', 'C' };
+
+	// Increase this whenever the layout below changes
+	const std::uint32_t CACHE_VERSION = 1;
+
+	const char* const CACHE_EXTENSION = ".drcache";
+
+	// Sanity limits to avoid huge allocations when reading a damaged file
+	const std::uint32_t MAX_STRING_LENGTH = 1 << 24;
+	const std::uint32_t MAX_ELEMENTS = 1 << 24;
+
+	enum PrimitiveType : std::uint8_t
+	{
+		PRIMITIVE_BRUSH = 0,
+		PRIMITIVE_PATCH = 1,
+	};
+
+	// A single brush face, written as a whole
+	struct FaceRecord
+	{
+		double plane[4];	// normal, dist
+		double texdef[6];	// xx yx tx xy yy ty
+		std::uint32_t shader;
+		std::uint32_t unused;
+	};
+	static_assert(sizeof(FaceRecord) == 88, "FaceRecord is expected to have no padding");
+
+	void writeStamp(std::ostream& stream, const MapCache::FileStamp& stamp)
+	{
+		writeValue(stream, stamp.size);
+		writeValue(stream, stamp.modificationTime);
+		writeValue(stream, stamp.hash);
+	}
+
+	std::uint32_t readCount(std::istream& stream)
+	{
+		return stream::binary::readCount(stream, MAX_ELEMENTS);
+	}
+
+	std::string readString(std::istream& stream)
+	{
+		return stream::binary::readString(stream, MAX_STRING_LENGTH);
+	}
+
+	MapCache::FileStamp readStamp(std::istream& stream)
+	{
+		MapCache::FileStamp stamp;
+
+		stamp.size = readValue<std::uint64_t>(stream);
+		stamp.modificationTime = readValue<std::int64_t>(stream);
+		stamp.hash = readValue<std::uint64_t>(stream);
+
+		return stamp;
+	}
+
+	// FNV-1a variant processing 8 bytes at a time
+	std::uint64_t getContentHash(const std::string& data)
+	{
+		const std::uint64_t prime = 1099511628211ull;
+
+		std::uint64_t hash = 14695981039346656037ull ^ data.size();
+		std::size_t i = 0;
+
+		for (; i + sizeof(std::uint64_t) <= data.size(); i += sizeof(std::uint64_t))
+		{
+			std::uint64_t word;
+			std::memcpy(&word, data.data() + i, sizeof(word));
+
+			hash = (hash ^ word) * prime;
+			hash ^= hash >> 32; // let the upper bits have an effect on the lower ones
+		}
+
+		for (; i < data.size(); ++i)
+		{
+			hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+		}
+
+		return hash;
+	}
+
+	// Checks size and modification time, before going through the hash
+	bool fileMatchesStamp(const std::string& filename, const MapCache::FileStamp& stamp)
+	{
+		try
+		{
+			if (fs::file_size(filename) != stamp.size ||
+				os::getFileModificationTime(filename) != stamp.modificationTime)
+			{
+				return false;
+			}
+		}
+		catch (fs::filesystem_error&)
+		{
+			return false;
+		}
+
+		MapCache::FileStamp current;
+		std::string contents;
+
+		return MapCache::getFileStamp(filename, current, contents) && current.hash == stamp.hash;
+	}
+
+	// Collects the direct children of a node
+	class ChildCollector :
+		public scene::NodeVisitor
+	{
+	public:
+		std::vector<scene::INodePtr> children;
+
+		bool pre(const scene::INodePtr& node) override
+		{
+			children.push_back(node);
+			return false;
+		}
+	};
+}
+
+MapCache::MapCache() :
+	_numEntities(0),
+	_hasInfoFile(false),
+	_entityDataStart(0)
+{}
+
+std::string MapCache::getCacheFilename(const std::string& mapFilename)
+{
+	return os::replaceExtension(mapFilename, CACHE_EXTENSION);
+}
+
+bool MapCache::getFileStamp(const std::string& filename, FileStamp& stamp, std::string& contents)
+{
+	std::ifstream file(filename, std::ios::binary);
+
+	if (!file)
+	{
+		return false;
+	}
+
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	contents = buffer.str();
+
+	stamp.size = contents.size();
+	stamp.modificationTime = os::getFileModificationTime(filename);
+	stamp.hash = getContentHash(contents);
+
+	return true;
+}
+
+bool MapCache::capture(const scene::INodePtr& root, const MapFormat& format, std::size_t expectedNodeCount)
+{
+	_mapFormatName = format.getMapFormatName();
+
+	std::size_t nodeCount = 0;
+
+	ChildCollector entities;
+	root->traverseChildren(entities);
+
+	for (const scene::INodePtr& node : entities.children)
+	{
+		IEntityNodePtr entity = std::dynamic_pointer_cast<IEntityNode>(node);
+
+		if (!entity)
+		{
+			return false; // the map readers don't create anything else
+		}
+
+		++_numEntities;
+		++nodeCount;
+
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> keyValues;
+
+		entity->getEntity().forEachKeyValue([&](const std::string& key, const std::string& value)
+		{
+			keyValues.emplace_back(getStringIndex(key), getStringIndex(value));
+		});
+
+		writeValue(_entityData, static_cast<std::uint32_t>(keyValues.size()));
+
+		for (const auto& pair : keyValues)
+		{
+			writeValue(_entityData, pair.first);
+			writeValue(_entityData, pair.second);
+		}
+
+		ChildCollector children;
+		node->traverseChildren(children);
+
+		std::vector<scene::INodePtr> primitives;
+
+		for (const scene::INodePtr& child : children.children)
+		{
+			if (Node_isPrimitive(child))
+			{
+				primitives.push_back(child);
+			}
+		}
+
+		writeValue(_entityData, static_cast<std::uint32_t>(primitives.size()));
+
+		for (const scene::INodePtr& primitive : primitives)
+		{
+			IBrushNodePtr brush = std::dynamic_pointer_cast<IBrushNode>(primitive);
+
+			if (brush)
+			{
+				captureBrush(brush);
+			}
+			else
+			{
+				capturePatch(std::dynamic_pointer_cast<IPatchNode>(primitive));
+			}
+		}
+
+		nodeCount += primitives.size();
+	}
+
+	return nodeCount == expectedNodeCount;
+}
+
+void MapCache::captureBrush(const IBrushNodePtr& brushNode)
+{
+	const IBrush& brush = brushNode->getIBrush();
+
+	writeValue(_entityData, PRIMITIVE_BRUSH);
+	writeValue(_entityData, static_cast<std::uint8_t>(brush.getDetailFlag()));
+	writeValue(_entityData, static_cast<std::uint32_t>(brush.getNumFaces()));
+
+	for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+	{
+		const IFace& face = brush.getFace(i);
+
+		const Plane3& plane = face.getPlane3();
+		Matrix4 texdef = face.getTexDefMatrix();
+
+		FaceRecord record;
+
+		record.plane[0] = plane.normal().x();
+		record.plane[1] = plane.normal().y();
+		record.plane[2] = plane.normal().z();
+		record.plane[3] = plane.dist();
+
+		record.texdef[0] = texdef.xx();
+		record.texdef[1] = texdef.yx();
+		record.texdef[2] = texdef.tx();
+		record.texdef[3] = texdef.xy();
+		record.texdef[4] = texdef.yy();
+		record.texdef[5] = texdef.ty();
+
+		record.shader = getStringIndex(face.getShader());
+		record.unused = 0;
+
+		writeValue(_entityData, record);
+	}
+}
+
+void MapCache::capturePatch(const IPatchNodePtr& patchNode)
+{
+	const IPatch& patch = patchNode->getPatch();
+
+	writeValue(_entityData, PRIMITIVE_PATCH);
+	writeValue(_entityData, static_cast<std::uint8_t>(patch.subdivisionsFixed() ? 1 : 0));
+	writeValue(_entityData, getStringIndex(patch.getShader()));
+	writeValue(_entityData, static_cast<std::uint32_t>(patch.getWidth()));
+	writeValue(_entityData, static_cast<std::uint32_t>(patch.getHeight()));
+	writeValue(_entityData, static_cast<std::uint32_t>(patch.getSubdivisions().x()));
+	writeValue(_entityData, static_cast<std::uint32_t>(patch.getSubdivisions().y()));
+
+	// Column by column, like in the map file
+	for (std::size_t c = 0; c < patch.getWidth(); c++)
+	{
+		for (std::size_t r = 0; r < patch.getHeight(); r++)
+		{
+			const PatchControl& ctrl = patch.ctrlAt(r, c);
+
+			writeValue(_entityData, ctrl.vertex.x());
+			writeValue(_entityData, ctrl.vertex.y());
+			writeValue(_entityData, ctrl.vertex.z());
+			writeValue(_entityData, ctrl.texcoord.x());
+			writeValue(_entityData, ctrl.texcoord.y());
+		}
+	}
+}
+
+std::uint32_t MapCache::getStringIndex(const std::string& str)
+{
+	auto found = _stringIndices.find(str);
+
+	if (found != _stringIndices.end())
+	{
+		return found->second;
+	}
+
+	std::uint32_t index = static_cast<std::uint32_t>(_strings.size());
+
+	_strings.push_back(str);
+	_stringIndices.emplace(str, index);
+
+	return index;
+}
+
+bool MapCache::readMapFile(const std::string& mapFilename, std::string& contents)
+{
+	return getFileStamp(mapFilename, _mapStamp, contents);
+}
+
+bool MapCache::readInfoFile(const std::string& infoFilename)
+{
+	_hasInfoFile = getFileStamp(infoFilename, _infoStamp, _infoFileContents);
+	return _hasInfoFile;
+}
+
+void MapCache::save(const std::string& mapFilename)
+{
+	std::string cacheFilename = getCacheFilename(mapFilename);
+
+	try
+	{
+		stream::writeFileAtomically(cacheFilename, [&](std::ostream& stream)
+		{
+			stream.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+			writeValue(stream, CACHE_VERSION);
+
+			writeStamp(stream, _mapStamp);
+
+			writeValue(stream, static_cast<std::uint8_t>(_hasInfoFile ? 1 : 0));
+
+			if (_hasInfoFile)
+			{
+				writeStamp(stream, _infoStamp);
+				writeString(stream, _infoFileContents);
+			}
+
+			writeString(stream, _mapFormatName);
+
+			writeValue(stream, static_cast<std::uint32_t>(_strings.size()));
+
+			for (const std::string& str : _strings)
+			{
+				writeString(stream, str);
+			}
+
+			writeValue(stream, _numEntities);
+			stream.write(_entityData.data(), _entityData.size());
+		});
+	}
+	catch (std::runtime_error& ex)
+	{
+		rWarning() << "Failed to write map cache " << cacheFilename << ": " << ex.what() << std::endl;
+	}
+}
+
+bool MapCache::load(const std::string& mapFilename, const std::string& infoFilename)
+{
+	std::string cacheFilename = getCacheFilename(mapFilename);
+
+	if (!os::fileOrDirExists(cacheFilename))
+	{
+		return false;
+	}
+
+	_stream.open(cacheFilename, std::ios::binary);
+
+	if (!_stream)
+	{
+		return false;
+	}
+
+	try
+	{
+		char magic[sizeof(CACHE_MAGIC)];
+		readData(_stream, magic, sizeof(magic));
+
+		if (std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0 ||
+			readValue<std::uint32_t>(_stream) != CACHE_VERSION)
+		{
+			return false;
+		}
+
+		if (!fileMatchesStamp(mapFilename, readStamp(_stream)))
+		{
+			rMessage() << "Map cache " << cacheFilename << " is outdated." << std::endl;
+			return false;
+		}
+
+		_hasInfoFile = readValue<std::uint8_t>(_stream) != 0;
+
+		if (_hasInfoFile)
+		{
+			if (!fileMatchesStamp(infoFilename, readStamp(_stream)))
+			{
+				rMessage() << "Map cache " << cacheFilename << " doesn't match the info file." << std::endl;
+				return false;
+			}
+
+			_infoFileContents = readString(_stream);
+		}
+		else if (!infoFilename.empty() && os::fileOrDirExists(infoFilename))
+		{
+			return false; // info file has been added since
+		}
+
+		_mapFormatName = readString(_stream);
+
+		std::uint32_t numStrings = readCount(_stream);
+		_strings.reserve(numStrings);
+
+		for (std::uint32_t i = 0; i < numStrings; ++i)
+		{
+			_strings.emplace_back(readString(_stream));
+		}
+
+		_numEntities = readCount(_stream);
+		_entityDataStart = _stream.tellg();
+
+		return true;
+	}
+	catch (std::runtime_error& ex)
+	{
+		rWarning() << "Cannot read map cache " << cacheFilename << ": " << ex.what() << std::endl;
+		return false;
+	}
+}
+
+const std::string& MapCache::getMapFormatName() const
+{
+	return _mapFormatName;
+}
+
+bool MapCache::hasInfoFile() const
+{
+	return _hasInfoFile;
+}
+
+const std::string& MapCache::getInfoFileContents() const
+{
+	return _infoFileContents;
+}
+
+std::istream& MapCache::getStream()
+{
+	return _stream;
+}
+
+void MapCache::createNodes(IMapImportFilter& importFilter)
+{
+	// The stream might have been repositioned in the meantime
+	_stream.clear();
+	_stream.seekg(_entityDataStart);
+
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> keyValues;
+
+	for (std::uint32_t e = 0; e < _numEntities; ++e)
+	{
+		keyValues.resize(readCount(_stream));
+
+		for (auto& pair : keyValues)
+		{
+			pair.first = readValue<std::uint32_t>(_stream);
+			pair.second = readValue<std::uint32_t>(_stream);
+		}
+
+		scene::INodePtr entity = createEntity(keyValues);
+
+		std::uint32_t numPrimitives = readCount(_stream);
+
+		for (std::uint32_t p = 0; p < numPrimitives; ++p)
+		{
+			std::uint8_t type = readValue<std::uint8_t>(_stream);
+
+			if (type == PRIMITIVE_BRUSH)
+			{
+				importFilter.addPrimitiveToEntity(createBrush(), entity);
+			}
+			else if (type == PRIMITIVE_PATCH)
+			{
+				importFilter.addPrimitiveToEntity(createPatch(), entity);
+			}
+			else
+			{
+				throw std::runtime_error("Unknown primitive type in map cache file");
+			}
+		}
+
+		importFilter.addEntity(entity);
+	}
+}
+
+scene::INodePtr MapCache::createEntity(const std::vector<std::pair<std::uint32_t, std::uint32_t>>& keyValues)
+{
+	const std::string* className = nullptr;
+
+	for (const auto& pair : keyValues)
+	{
+		if (getString(pair.first) == "classname")
+		{
+			className = &getString(pair.second);
+		}
+	}
+
+	if (className == nullptr)
+	{
+		throw std::runtime_error("Entity without classname in map cache file");
+	}
+
+	// Same as in the map readers
+	IEntityClassPtr classPtr = GlobalEntityClassManager().findClass(*className);
+
+	if (!classPtr)
+	{
+		rError() << "[MapCache]: Could not find entity class: " << *className << std::endl;
+
+		// EntityClass not found, insert a brush-based one
+		classPtr = GlobalEntityClassManager().findOrInsert(*className, true);
+	}
+
+	IEntityNodePtr node(GlobalEntityCreator().createEntity(classPtr));
+
+	for (const auto& pair : keyValues)
+	{
+		node->getEntity().setKeyValue(getString(pair.first), getString(pair.second));
+	}
+
+	return node;
+}
+
+scene::INodePtr MapCache::createBrush()
+{
+	ParsedBrush brush;
+
+	brush.hasDetailFlag = true;
+	brush.detailFlag = static_cast<IBrush::DetailFlag>(readValue<std::uint8_t>(_stream));
+
+	std::vector<FaceRecord> records(readCount(_stream));
+
+	if (!records.empty())
+	{
+		readData(_stream, records.data(), records.size() * sizeof(FaceRecord));
+	}
+
+	brush.faces.reserve(records.size());
+
+	for (const FaceRecord& record : records)
+	{
+		ParsedBrush::Face face;
+
+		face.plane = Plane3(record.plane[0], record.plane[1], record.plane[2], record.plane[3]);
+
+		face.texdef = Matrix4::getIdentity();
+		face.texdef.xx() = record.texdef[0];
+		face.texdef.yx() = record.texdef[1];
+		face.texdef.tx() = record.texdef[2];
+		face.texdef.xy() = record.texdef[3];
+		face.texdef.yy() = record.texdef[4];
+		face.texdef.ty() = record.texdef[5];
+
+		face.shader = getString(record.shader);
+
+		brush.faces.emplace_back(std::move(face));
+	}
+
+	return brush.createNode();
+}
+
+scene::INodePtr MapCache::createPatch()
+{
+	bool fixedSubdivisions = readValue<std::uint8_t>(_stream) != 0;
+
+	ParsedPatch patch(fixedSubdivisions ? PatchDefType::Def3 : PatchDefType::Def2);
+
+	patch.shader = getString(readValue<std::uint32_t>(_stream));
+	patch.width = readCount(_stream);
+	patch.height = readCount(_stream);
+
+	std::uint32_t subdivisionsX = readValue<std::uint32_t>(_stream);
+	std::uint32_t subdivisionsY = readValue<std::uint32_t>(_stream);
+
+	patch.fixedSubdivisions = fixedSubdivisions;
+	patch.subdivisions = Subdivisions(subdivisionsX, subdivisionsY);
+
+	if (patch.width * patch.height > MAX_ELEMENTS)
+	{
+		throw std::runtime_error("Invalid patch dimensions in map cache file");
+	}
+
+	std::vector<double> values(patch.width * patch.height * 5);
+
+	if (!values.empty())
+	{
+		readData(_stream, values.data(), values.size() * sizeof(double));
+	}
+
+	patch.controlPoints.resize(patch.width * patch.height);
+
+	for (std::size_t i = 0; i < patch.controlPoints.size(); ++i)
+	{
+		PatchControl& ctrl = patch.controlPoints[i];
+
+		ctrl.vertex = Vector3(values[i * 5], values[i * 5 + 1], values[i * 5 + 2]);
+		ctrl.texcoord = Vector2(values[i * 5 + 3], values[i * 5 + 4]);
+	}
+
+	return patch.createNode();
+}
+
+const std::string& MapCache::getString(std::uint32_t index) const
+{
+	if (index >= _strings.size())
+	{
+		throw std::runtime_error("Invalid string index in map cache file");
+	}
+
+	return _strings[index];
+}
+
+} // namespace map
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+#include "inode.h"
+#include "imapformat.h"
+
+namespace map
+{
+
+/**
+ * Binary sidecar cache of a map file, stored next to the map.
+ *
+ * It holds the entity spawnargs, brush planes and texdefs, patch control
+ * grids (with all shader names and keys stored in a string table) and the
+ * contents of the info file, in the form they had right after parsing.
+ * This way a map can be re-opened without running it through the tokeniser.
+ *
+ * The cache is validated against the size, modification time and content
+ * hash of both the map and the info file. If anything doesn't match, the
+ * caller is supposed to parse the text files as usual.
+ */
+class MapCache
+{
+public:
+	// Size, modification time and content hash of a file
+	struct FileStamp
+	{
+		std::uint64_t size;
+		std::int64_t modificationTime;
+		std::uint64_t hash;
+
+		FileStamp() :
+			size(0),
+			modificationTime(0),
+			hash(0)
+		{}
+	};
+
+private:
+	std::string _mapFormatName;
+
+	// Interned strings (shader names, spawnargs), and their indices
+	std::vector<std::string> _strings;
+	std::unordered_map<std::string, std::uint32_t> _stringIndices;
+
+	// The number of entities and their binary records, as collected by capture()
+	std::uint32_t _numEntities;
+	std::string _entityData;
+
+	// The stamps of the files the captured data has been parsed from
+	FileStamp _mapStamp;
+	FileStamp _infoStamp;
+
+	bool _hasInfoFile;
+	std::string _infoFileContents;
+
+	// The cache file opened by load(), the entity records are read from here
+	std::ifstream _stream;
+	std::streampos _entityDataStart;
+
+public:
+	MapCache();
+
+	// Returns the filename of the cache belonging to the given map file
+	static std::string getCacheFilename(const std::string& mapFilename);
+
+	/**
+	 * Reads the map file which is about to be parsed and records its stamp.
+	 * The returned contents need to be the ones passed to the map reader, such
+	 * that the cache is only valid for exactly these bytes, even if the file
+	 * changes while it is being parsed. Returns false if the file can't be read.
+	 */
+	bool readMapFile(const std::string& mapFilename, std::string& contents);
+
+	/**
+	 * Same as readMapFile() for the info file, its contents are stored in the
+	 * cache and returned by getInfoFileContents(). Returns false if there's
+	 * no such file, in which case the cache is saved without info file.
+	 */
+	bool readInfoFile(const std::string& infoFilename);
+
+	/**
+	 * Collects the entities and primitives below the given root, which has just
+	 * been loaded by the given format. This needs to be called before the child
+	 * primitives are moved into the world (addOriginToChildPrimitives).
+	 * The expected node count is the number of entities and primitives the reader
+	 * passed to the import filter. If the scene turns out to have fewer (i.e. some
+	 * have been rejected), the map can't be cached and false is returned.
+	 */
+	bool capture(const scene::INodePtr& root, const MapFormat& format, std::size_t expectedNodeCount);
+
+	// Writes the captured data to the cache file, stamped with the files read before.
+	// Failures are reported to the console, a missing cache is no problem after all.
+	void save(const std::string& mapFilename);
+
+	/**
+	 * Opens the cache of the given map file and checks it against the map and info files.
+	 * Returns true if the cache is valid, in which case the nodes can be created.
+	 */
+	bool load(const std::string& mapFilename, const std::string& infoFilename);
+
+	const std::string& getMapFormatName() const;
+
+	bool hasInfoFile() const;
+	const std::string& getInfoFileContents() const;
+
+	// The stream of the loaded cache, for progress display
+	std::istream& getStream();
+
+	/**
+	 * Creates the nodes from the loaded cache, passing them to the given import filter
+	 * in the same order as the map reader would. Throws std::runtime_error if the
+	 * cache turns out to be damaged.
+	 */
+	void createNodes(IMapImportFilter& importFilter);
+
+	// Returns the stamp of the given file, the contents are stored in the given string
+	static bool getFileStamp(const std::string& filename, FileStamp& stamp, std::string& contents);
+
+private:
+	std::uint32_t getStringIndex(const std::string& str);
+
+	void captureBrush(const IBrushNodePtr& brushNode);
+	void capturePatch(const IPatchNodePtr& patchNode);
+
+	scene::INodePtr createEntity(const std::vector<std::pair<std::uint32_t, std::uint32_t>>& keyValues);
+	scene::INodePtr createBrush();
+	scene::INodePtr createPatch();
+
+	const std::string& getString(std::uint32_t index) const;
+};
+
+} // namespace map
@@ -11,7 +11,9 @@
 #include "ifilesystem.h"
 #include "imainframe.h"
 #include "iregistry.h"
+#include "registry/registry.h"
 #include "imapinfofile.h"
+#include "iprofiler.h"
 
 #include "map/Map.h"
 #include "map/RootNode.h"
@@ -36,6 +38,7 @@
 #include "algorithm/MapExporter.h"
 #include "infofile/InfoFileExporter.h"
 #include "algorithm/ChildPrimitives.h"
+#include "MapCache.h"
 
 namespace map
 {
@@ -43,8 +46,21 @@ namespace map
 namespace
 {
 	const char* const GKEY_INFO_FILE_EXTENSION = "/mapFormat/infoFileExtension";
+	const char* const RKEY_USE_BINARY_CACHE = "user/ui/map/useBinaryCache";
 
 	// name may be absolute or relative
+	inline std::string getInfoFilename(const std::string& mapFilename)
+	{
+		return mapFilename.substr(0, mapFilename.rfind('.')) +
+			game::current::getValue<std::string>(GKEY_INFO_FILE_EXTENSION);
+	}
+
+	// The binary cache is only used for physical files
+	inline bool useBinaryCache(const std::string& filename)
+	{
+		return path_is_absolute(filename.c_str()) && registry::getValue<bool>(RKEY_USE_BINARY_CACHE);
+	}
+
 	inline std::string rootPath(const std::string& name) {
 		return GlobalFileSystem().findRoot(
 			path_is_absolute(name.c_str()) ? name : GlobalFileSystem().findFile(name)
@@ -331,11 +347,35 @@ RootNodePtr MapResource::loadMapNode()
         return rootNode;
 	}
 
+	profile::ScopedSpan span("Load map", "map");
+
 	try
 	{
 		// Build the map path
 		std::string fullpath = _path + _name;
 
+		if (useBinaryCache(fullpath))
+		{
+			// Try to skip the parsing step
+			if (loadMapNodeFromCache(fullpath, rootNode))
+			{
+				return rootNode;
+			}
+
+			// Parse the very bytes the new cache is stamped with, the file
+			// might change before the cache gets written
+			MapCache cache;
+			std::string contents;
+
+			if (cache.readMapFile(fullpath, contents))
+			{
+				std::istringstream mapStream(contents);
+				rootNode = loadMapNodeFromStream(mapStream, fullpath, &cache);
+
+				return rootNode;
+			}
+		}
+
 		// Open a stream (from physical file or VFS)
 		openFileStream(fullpath, [&](std::istream& mapStream)
 		{
@@ -350,7 +390,7 @@ RootNodePtr MapResource::loadMapNode()
 	return rootNode;
 }
 
-RootNodePtr MapResource::loadMapNodeFromStream(std::istream& stream, const std::string& fullpath)
+RootNodePtr MapResource::loadMapNodeFromStream(std::istream& stream, const std::string& fullpath, MapCache* cache)
 {
 	// Get the mapformat
 	MapFormatPtr format = determineMapFormat(stream);
@@ -367,7 +407,7 @@ RootNodePtr MapResource::loadMapNodeFromStream(std::istream& stream, const std::
 	// Create a new map root node
     RootNodePtr root = std::make_shared<RootNode>(_name);
 
-	if (loadFile(stream, *format, root, fullpath))
+	if (loadFile(stream, *format, root, fullpath, cache))
 	{
 		return root;
 	}
@@ -375,7 +415,69 @@ RootNodePtr MapResource::loadMapNodeFromStream(std::istream& stream, const std::
     return RootNodePtr();
 }
 
-bool MapResource::loadFile(std::istream& mapStream, const MapFormat& format, const RootNodePtr& root, const std::string& filename)
+bool MapResource::loadMapNodeFromCache(const std::string& fullpath, RootNodePtr& rootNode)
+{
+	MapCache cache;
+
+	if (!cache.load(fullpath, getInfoFilename(fullpath)))
+	{
+		return false;
+	}
+
+	MapFormatPtr format = GlobalMapFormatManager().getMapFormatByName(cache.getMapFormatName());
+
+	if (!format)
+	{
+		return false;
+	}
+
+	rMessage() << "Loading map " << fullpath << " from its cache file." << std::endl;
+
+	profile::ScopedSpan span("Create nodes from map cache", "map");
+
+	RootNodePtr root = std::make_shared<RootNode>(_name);
+
+	try
+	{
+		MapImporter importFilter(root, cache.getStream());
+
+		cache.createNodes(importFilter);
+
+		addOriginToChildPrimitives(root);
+
+		if (format->allowInfoFileCreation() && cache.hasInfoFile())
+		{
+			std::istringstream infoFileStream(cache.getInfoFileContents());
+			loadInfoFileFromStream(infoFileStream, root, importFilter.getNodeMap());
+		}
+
+		rootNode = root;
+		return true;
+	}
+	catch (wxutil::ModalProgressDialog::OperationAbortedException&)
+	{
+		wxutil::Messagebox::ShowError(_("Map loading cancelled"));
+
+		scene::NodeRemover remover;
+		root->traverseChildren(remover);
+
+		// Don't fall back to parsing the map, the user wants to stop
+		rootNode.reset();
+		return true;
+	}
+	catch (std::runtime_error& ex)
+	{
+		rWarning() << "Cannot load map from cache, falling back to parsing: " << ex.what() << std::endl;
+
+		scene::NodeRemover remover;
+		root->traverseChildren(remover);
+
+		return false;
+	}
+}
+
+bool MapResource::loadFile(std::istream& mapStream, const MapFormat& format, const RootNodePtr& root,
+						   const std::string& filename, MapCache* cache)
 {
 	// Our importer taking care of scene insertion
 	MapImporter importFilter(root, mapStream);
@@ -386,19 +488,44 @@ bool MapResource::loadFile(std::istream& mapStream, const MapFormat& format, con
 	try
 	{
 		// Start parsing
-		reader->readFromStream(mapStream);
+		{
+			profile::ScopedSpan span("Parse map", "map");
+			reader->readFromStream(mapStream);
+		}
+
+		// Take the snapshot for the cache before the child primitives are moved
+		if (cache != nullptr)
+		{
+			profile::ScopedSpan span("Capture map cache", "map");
+
+			if (!cache->capture(root, format, importFilter.getNodeMap().size()))
+			{
+				cache = nullptr;
+			}
+		}
 
 		// Prepare child primitives
 		addOriginToChildPrimitives(root);
 
-		if (!format.allowInfoFileCreation())
+		if (format.allowInfoFileCreation())
 		{
-			// No info file handling, just return success
-			return true;
+			// Check for an additional info file, the cache gets the contents it is stamped with
+			if (cache != nullptr && cache->readInfoFile(getInfoFilename(filename)))
+			{
+				std::istringstream infoFileStream(cache->getInfoFileContents());
+				loadInfoFileFromStream(infoFileStream, root, importFilter.getNodeMap());
+			}
+			else
+			{
+				loadInfoFile(root, filename, importFilter.getNodeMap());
+			}
 		}
 
-		// Check for an additional info file
-		loadInfoFile(root, filename, importFilter.getNodeMap());
+		if (cache != nullptr)
+		{
+			profile::ScopedSpan span("Save map cache", "map");
+			cache->save(filename);
+		}
 
 		return true;
 	}
@@ -431,10 +558,7 @@ void MapResource::loadInfoFile(const RootNodePtr& root, const std::string& filen
 {
 	try
 	{
-		std::string infoFilename(filename.substr(0, filename.rfind('.')));
-		infoFilename += game::current::getValue<std::string>(GKEY_INFO_FILE_EXTENSION);
-
-		openFileStream(infoFilename, [&](std::istream& infoFileStream)
+		openFileStream(getInfoFilename(filename), [&](std::istream& infoFileStream)
 		{
 			loadInfoFileFromStream(infoFileStream, root, nodeMap);
 		});
@@ -455,6 +579,8 @@ void MapResource::loadInfoFileFromStream(std::istream& infoFileStream, const Roo
 
 	rMessage() << "Parsing info file..." << std::endl;
 
+	profile::ScopedSpan span("Parse info file", "map");
+
 	try
 	{
 		// Read the infofile
@@ -574,9 +700,8 @@ bool MapResource::saveFile(const MapFormat& format, const scene::INodePtr& root,
 		IMapWriterPtr mapWriter = format.getMapWriter();
 
 		// Create our main MapExporter walker, and pass the desired 
-		// writer to it. The constructor will prepare the scene
-		// and the destructor will clean it up afterwards. That way
-		// we ensure a nice and tidy scene when exceptions are thrown.
+		// writer to it. The scene is left untouched, child primitives
+		// are written relative to their entity's origin on the fly.
 		MapExporterPtr exporter;
 		
 		if (format.allowInfoFileCreation())
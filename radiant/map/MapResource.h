@@ -12,6 +12,8 @@
 namespace map
 {
 
+class MapCache;
+
 class MapResource :
 	public IMapResource,
 	public util::Noncopyable
@@ -54,7 +56,13 @@ private:
 	bool saveBackup();
 
 	RootNodePtr loadMapNode();
-    RootNodePtr loadMapNodeFromStream(std::istream& stream, const std::string& fullPath);
+	// Parses the map, the nodes are captured in the given cache if it is not null
+	RootNodePtr loadMapNodeFromStream(std::istream& stream, const std::string& fullPath,
+									  MapCache* cache = nullptr);
+
+	// Creates the map nodes from the binary cache next to the given map file. Returns false
+	// if the cache is missing or outdated, in which case the map file needs to be parsed.
+	bool loadMapNodeFromCache(const std::string& fullPath, RootNodePtr& rootNode);
 
 	void connectMap();
 
@@ -63,7 +71,8 @@ private:
 	MapFormatPtr determineMapFormat(std::istream& stream);
 
 	bool loadFile(std::istream& mapStream, const MapFormat& format, 
-                  const RootNodePtr& root, const std::string& filename);
+                  const RootNodePtr& root, const std::string& filename,
+                  MapCache* cache = nullptr);
 
 	void loadInfoFile(const RootNodePtr& root, const std::string& filename, const NodeIndexMap& nodeMap);
 	void loadInfoFileFromStream(std::istream& infoFileStream, const RootNodePtr& root, const NodeIndexMap& nodeMap);
@@ -0,0 +1,211 @@
+#include "MapSnapshot.h"
+
+#include <sstream>
+#include <stdexcept>
+#include "igame.h"
+#include "gamelib.h"
+
+#include "os/fs.h"
+#include "string/convert.h"
+#include "stream/BinaryFile.h"
+#include "algorithm/MapExporter.h"
+#include "infofile/InfoFileExporter.h"
+#include "format/Doom3MapWriter.h"
+#include "../brush/Brush.h"
+
+namespace map
+{
+
+namespace
+{
+	const char* const GKEY_INFO_FILE_EXTENSION = "/mapFormat/infoFileExtension";
+	const char* const RKEY_FLOAT_PRECISION = "/mapFormat/floatPrecision";
+}
+
+// Copies the values of the visited nodes, numbering them the same way the MapExporter does
+class MapSnapshot::SceneCollector :
+	public scene::NodeVisitor
+{
+private:
+	std::vector<Entity>& _entities;
+
+	// Optional, is NULL if no info file should be written
+	InfoFileExporter* _infoFileExporter;
+
+	std::size_t _entityNum;
+	std::size_t _primitiveNum;
+
+public:
+	SceneCollector(std::vector<Entity>& entities, InfoFileExporter* infoFileExporter) :
+		_entities(entities),
+		_infoFileExporter(infoFileExporter),
+		_entityNum(0),
+		_primitiveNum(0)
+	{}
+
+	bool pre(const scene::INodePtr& node) override
+	{
+		auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
+
+		if (entity)
+		{
+			_entities.emplace_back(entity);
+
+			if (_infoFileExporter) _infoFileExporter->visitEntity(node, _entityNum);
+
+			return true;
+		}
+
+		// Primitives are only expected below entities
+		if (_entities.empty()) return true;
+
+		auto brush = std::dynamic_pointer_cast<IBrushNode>(node);
+
+		if (brush)
+		{
+			// Bring the windings up to date, this is a no-op for unchanged brushes
+			Node_getBrush(node)->evaluateBRep();
+
+			if (brush->getIBrush().hasContributingFaces())
+			{
+				Primitive primitive;
+				primitive.brush.reset(new BrushSnapshot(brush->getIBrush()));
+				_entities.back().primitives.emplace_back(std::move(primitive));
+
+				visitPrimitive(node);
+			}
+
+			return true;
+		}
+
+		auto patch = std::dynamic_pointer_cast<IPatchNode>(node);
+
+		if (patch)
+		{
+			Primitive primitive;
+			primitive.patch.reset(new PatchSnapshot(patch->getPatch()));
+			_entities.back().primitives.emplace_back(std::move(primitive));
+
+			visitPrimitive(node);
+		}
+
+		return true;
+	}
+
+	void post(const scene::INodePtr& node) override
+	{
+		if (std::dynamic_pointer_cast<IEntityNode>(node))
+		{
+			_entityNum++;
+		}
+	}
+
+private:
+	void visitPrimitive(const scene::INodePtr& node)
+	{
+		if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
+
+		_primitiveNum++;
+	}
+};
+
+MapSnapshot::MapSnapshot(const MapFormat& format, const scene::INodePtr& root, const GraphTraversalFunc& traverse) :
+	_writer(std::dynamic_pointer_cast<Doom3MapWriter>(format.getMapWriter())),
+	_precision(0),
+	_isSerialised(false),
+	_hasInfoFile(format.allowInfoFileCreation()),
+	_infoFileExtension(game::current::getValue<std::string>(GKEY_INFO_FILE_EXTENSION))
+{
+	std::ostringstream infoFileStream;
+
+	if (!_writer)
+	{
+		// Unknown writer, serialise the map right away
+		std::ostringstream mapStream;
+
+		IMapWriterPtr mapWriter = format.getMapWriter();
+
+		{
+			// A node count of 0 disables the progress dialog
+			std::unique_ptr<MapExporter> exporter(_hasInfoFile ?
+				new MapExporter(*mapWriter, root, mapStream, infoFileStream, 0) :
+				new MapExporter(*mapWriter, root, mapStream, 0));
+
+			exporter->exportMap(root, traverse);
+		}
+
+		_isSerialised = true;
+		_mapContents = mapStream.str();
+		_infoFileContents = infoFileStream.str();
+		return;
+	}
+
+	xml::NodeList nodes = GlobalGameManager().currentGame()->getLocalXPath(RKEY_FLOAT_PRECISION);
+	assert(!nodes.empty());
+
+	_precision = string::convert<int>(nodes[0].getAttributeValue("value"));
+
+	{
+		// The info file is written when the exporter is destroyed
+		std::unique_ptr<InfoFileExporter> infoFileExporter(_hasInfoFile ?
+			new InfoFileExporter(infoFileStream) : nullptr);
+
+		SceneCollector collector(_entities, infoFileExporter.get());
+		traverse(root, collector);
+	}
+
+	_infoFileContents = infoFileStream.str();
+}
+
+void MapSnapshot::writeToFile(const std::string& filename)
+{
+	stream::writeFileAtomically(filename, [&](std::ostream& stream)
+	{
+		if (_isSerialised)
+		{
+			stream.write(_mapContents.data(), _mapContents.size());
+		}
+		else
+		{
+			writeMap(stream);
+		}
+	});
+
+	if (_hasInfoFile)
+	{
+		stream::writeFileAtomically(os::replaceExtension(filename, _infoFileExtension), [&](std::ostream& stream)
+		{
+			stream.write(_infoFileContents.data(), _infoFileContents.size());
+		});
+	}
+}
+
+void MapSnapshot::writeMap(std::ostream& stream)
+{
+	stream.precision(_precision);
+
+	_writer->beginWriteMap(stream);
+
+	for (const Entity& entity : _entities)
+	{
+		_writer->beginEntity(entity.values, stream);
+
+		for (const Primitive& primitive : entity.primitives)
+		{
+			if (primitive.brush)
+			{
+				_writer->writeBrush(*primitive.brush, stream);
+			}
+			else
+			{
+				_writer->writePatch(*primitive.patch, stream);
+			}
+		}
+
+		_writer->endEntity(stream);
+	}
+
+	_writer->endWriteMap(stream);
+}
+
+} // namespace map
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <ios>
+#include "inode.h"
+#include "imapformat.h"
+
+#include "format/ExportSnapshot.h"
+
+namespace map
+{
+
+class Doom3MapWriter;
+
+/**
+ * A copy of the map contents, to be written to disk by a worker thread.
+ *
+ * The snapshot is taken on the main thread, which is the only one allowed
+ * to touch the scene. Only the values are copied (spawnargs, face planes,
+ * texture definitions and patch control points), the text is formatted when
+ * the snapshot is written, while the user continues editing the map.
+ *
+ * The info file is small and its contents are provided by the info file
+ * modules, it is serialised right away.
+ */
+class MapSnapshot
+{
+private:
+	// Either one of the two is set
+	struct Primitive
+	{
+		std::unique_ptr<BrushSnapshot> brush;
+		std::unique_ptr<PatchSnapshot> patch;
+	};
+
+	struct Entity
+	{
+		EntitySnapshot values;
+		std::vector<Primitive> primitives;
+
+		explicit Entity(const IEntityNodePtr& entity) :
+			values(entity)
+		{}
+	};
+
+	class SceneCollector;
+
+	// The writer of the map format, all built-in formats are using a Doom3MapWriter
+	std::shared_ptr<Doom3MapWriter> _writer;
+
+	std::vector<Entity> _entities;
+
+	std::streamsize _precision;
+
+	// Formats not supporting the snapshot values are serialised on construction
+	bool _isSerialised;
+	std::string _mapContents;
+
+	bool _hasInfoFile;
+	std::string _infoFileContents;
+
+	// Looked up on construction, the game settings are not meant to be accessed by worker threads
+	std::string _infoFileExtension;
+
+public:
+	// Copies the nodes below the given root, using the given format and traversal function.
+	// This doesn't show any progress dialog.
+	MapSnapshot(const MapFormat& format, const scene::INodePtr& root, const GraphTraversalFunc& traverse);
+
+	/**
+	 * Writes the snapshot to the given map file, and the info file next to it.
+	 * Each file is written to a temporary file first, which then replaces the
+	 * existing one. Throws std::runtime_error on failure. This is meant to be
+	 * called once, by any thread.
+	 */
+	void writeToFile(const std::string& filename);
+
+private:
+	void writeMap(std::ostream& stream);
+};
+typedef std::shared_ptr<MapSnapshot> MapSnapshotPtr;
+
+} // namespace map
@@ -83,4 +83,21 @@ void removeOriginFromChildPrimitives(const scene::INodePtr& root)
 	root->traverse(remover);
 }
 
+Vector3 getChildPrimitiveTranslation(const scene::INodePtr& entityNode)
+{
+	Entity* entity = Node_getEntity(entityNode);
+
+	if (entity != NULL && !entity->isWorldspawn())
+	{
+		scene::GroupNodePtr groupNode = Node_getGroupNode(entityNode);
+
+		if (groupNode)
+		{
+			return groupNode->getChildTranslationForExport();
+		}
+	}
+
+	return Vector3(0, 0, 0);
+}
+
 } // namespace
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include "math/Vector3.h"
 
 // Forward Decl.
 namespace scene { class INode; typedef std::shared_ptr<INode> INodePtr; }
@@ -19,4 +20,11 @@ void addOriginToChildPrimitives(const scene::INodePtr& root);
  */
 void removeOriginFromChildPrimitives(const scene::INodePtr& root);
 
+/**
+ * Returns the translation removeOriginFromChildPrimitives() would apply to the
+ * child primitives of the given entity, or a zero vector if they stay in place.
+ * The map writers use this to export the primitives without moving them.
+ */
+Vector3 getChildPrimitiveTranslation(const scene::INodePtr& entityNode);
+
 } // namespace
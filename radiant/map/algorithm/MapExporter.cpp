@@ -2,6 +2,7 @@
 
 #include <ostream>
 #include "i18n.h"
+#include "ithread.h"
 #include "itextstream.h"
 #include "ibrush.h"
 #include "ipatch.h"
@@ -13,8 +14,6 @@
 #include "registry/registry.h"
 #include "string/string.h"
 
-#include "ChildPrimitives.h"
-
 namespace map
 {
 
@@ -22,17 +21,26 @@ namespace map
 	{
 		const char* const RKEY_FLOAT_PRECISION = "/mapFormat/floatPrecision";
 		const char* const RKEY_MAP_SAVE_STATUS_INTERLEAVE = "user/ui/map/saveStatusInterleave";
+		const char* const RKEY_MAP_SAVE_PARALLEL = "user/ui/map/parallelSave";
+
+		// The output is passed to the target stream in chunks of this size
+		const std::size_t OUTPUT_CHUNK_SIZE = 4 * 1024 * 1024;
+
+		// Entities are collected until a job has this many writer calls
+		const std::size_t MIN_CALLS_PER_JOB = 512;
 	}
 
 MapExporter::MapExporter(IMapWriter& writer, const scene::INodePtr& root, std::ostream& mapStream, std::size_t nodeCount) :
 	_writer(writer),
-	_mapStream(mapStream),
+	_mapStream(mapStream, OUTPUT_CHUNK_SIZE),
 	_root(root),
 	_dialogEventLimiter(registry::getValue<int>(RKEY_MAP_SAVE_STATUS_INTERLEAVE)),
 	_totalNodeCount(nodeCount),
 	_curNodeCount(0),
 	_entityNum(0),
-	_primitiveNum(0)
+	_primitiveNum(0),
+	_writeEntitiesInParallel(false),
+	_maxPendingJobs(0)
 {
 	construct();
 }
@@ -40,26 +48,32 @@ MapExporter::MapExporter(IMapWriter& writer, const scene::INodePtr& root, std::o
 MapExporter::MapExporter(IMapWriter& writer, const scene::INodePtr& root, 
 				std::ostream& mapStream, std::ostream& auxStream, std::size_t nodeCount) :
 	_writer(writer),
-	_mapStream(mapStream),
+	_mapStream(mapStream, OUTPUT_CHUNK_SIZE),
 	_infoFileExporter(new InfoFileExporter(auxStream)),
 	_root(root),
 	_dialogEventLimiter(registry::getValue<int>(RKEY_MAP_SAVE_STATUS_INTERLEAVE)),
 	_totalNodeCount(nodeCount),
 	_curNodeCount(0),
 	_entityNum(0),
-	_primitiveNum(0)
+	_primitiveNum(0),
+	_writeEntitiesInParallel(false),
+	_maxPendingJobs(0)
 {
 	construct();
 }
 
 MapExporter::~MapExporter()
 {
+	// Wait for any workers still busy with the scene (e.g. when cancelled)
+	for (std::future<EntityJobResult>& job : _pendingJobs)
+	{
+		job.wait();
+	}
+
+	_pendingJobs.clear();
+
 	// Close any info file stream
 	_infoFileExporter.reset();
-
-	// The finish() call is placed in the destructor to make sure that 
-	// even on unhandled exceptions the map is left in a working state
-	finishScene();
 }
 
 void MapExporter::construct()
@@ -79,8 +93,12 @@ void MapExporter::construct()
 	int precision = string::convert<int>(nodes[0].getAttributeValue("value"));
 	_mapStream.precision(precision);
 
-	// Add origin to func_* children before writing
-	prepareScene();
+	// Writing entities in parallel requires the writer to support it
+	_writeEntitiesInParallel = registry::getValue<bool>(RKEY_MAP_SAVE_PARALLEL) && 
+		_writer.createEntityWriter(0);
+
+	// Don't let the workers get too far ahead of the output
+	_maxPendingJobs = (GlobalThreadManager().getNumWorkers() + 1) * 2;
 }
 
 void MapExporter::exportMap(const scene::INodePtr& root, const GraphTraversalFunc& traverse)
@@ -97,6 +115,12 @@ void MapExporter::exportMap(const scene::INodePtr& root, const GraphTraversalFun
 	// Perform the actual map traversal
 	traverse(root, *this);
 
+	if (_writeEntitiesInParallel)
+	{
+		submitEntityJob();
+		writeFinishedJobs(true);
+	}
+
 	try
 	{
 		_writer.endWriteMap(_mapStream);
@@ -106,7 +130,8 @@ void MapExporter::exportMap(const scene::INodePtr& root, const GraphTraversalFun
 		rError() << "Failure exporting a node (pre): " << ex.what() << std::endl;
 	}
 
-	// finishScene() is handled through the destructor
+	_mapStream.flush();
+
 }
 
 void MapExporter::enableProgressDialog()
@@ -121,53 +146,54 @@ void MapExporter::disableProgressDialog()
 
 bool MapExporter::pre(const scene::INodePtr& node)
 {
-	try
+	auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
+
+	if (entity)
 	{
-		auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
+		// Progress dialog handling
+		onNodeProgress();
 
-		if (entity)
-		{
-			// Progress dialog handling
-			onNodeProgress();
-			
-			_writer.beginWriteEntity(entity, _mapStream);
+		if (!dispatch(WriterCall{ WriterCall::BeginEntity, entity, IBrushNodePtr(), IPatchNodePtr() })) return true;
 
-			if (_infoFileExporter) _infoFileExporter->visitEntity(node, _entityNum);
+		if (_infoFileExporter) _infoFileExporter->visitEntity(node, _entityNum);
 
-			return true;
-		}
+		return true;
+	}
 
-		auto brush = std::dynamic_pointer_cast<IBrushNode>(node);
+	auto brush = std::dynamic_pointer_cast<IBrushNode>(node);
 
-		if (brush && brush->getIBrush().hasContributingFaces())
-		{
-			// Progress dialog handling
-			onNodeProgress();
+	if (brush)
+	{
+		// Bring the windings up to date, this is a no-op for unchanged brushes.
+		// Child brushes of func_* entities are not moved, the writers are
+		// exporting them relative to the entity origin on the fly.
+		Node_getBrush(node)->evaluateBRep();
+	}
 
-			_writer.beginWriteBrush(brush, _mapStream);
+	if (brush && brush->getIBrush().hasContributingFaces())
+	{
+		// Progress dialog handling
+		onNodeProgress();
 
-			if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
+		if (!dispatch(WriterCall{ WriterCall::BeginBrush, IEntityNodePtr(), brush, IPatchNodePtr() })) return true;
 
-			return true;
-		}
+		if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
 
-		auto patch = std::dynamic_pointer_cast<IPatchNode>(node);
+		return true;
+	}
 
-		if (patch)
-		{
-			// Progress dialog handling
-			onNodeProgress();
+	auto patch = std::dynamic_pointer_cast<IPatchNode>(node);
+
+	if (patch)
+	{
+		// Progress dialog handling
+		onNodeProgress();
 
-			_writer.beginWritePatch(patch, _mapStream);
+		if (!dispatch(WriterCall{ WriterCall::BeginPatch, IEntityNodePtr(), IBrushNodePtr(), patch })) return true;
 
-			if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
+		if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
 
-			return true;
-		}
-	}
-	catch (IMapWriter::FailureException& ex)
-	{
-		rError() << "Failure exporting a node (pre): " << ex.what() << std::endl;
+		return true;
 	}
 
 	return true; // full traversal
@@ -175,87 +201,200 @@ bool MapExporter::pre(const scene::INodePtr& node)
 
 void MapExporter::post(const scene::INodePtr& node)
 {
-	try
+	auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
+
+	if (entity)
 	{
-		auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
+		if (!dispatch(WriterCall{ WriterCall::EndEntity, entity, IBrushNodePtr(), IPatchNodePtr() })) return;
 
-		if (entity)
-		{
-			_writer.endWriteEntity(entity, _mapStream);
+		_entityNum++;
 
-			_entityNum++;
-			return;
+		// Hand the collected entities to a worker once there's enough to do
+		if (_writeEntitiesInParallel && _currentJob.calls.size() >= MIN_CALLS_PER_JOB)
+		{
+			submitEntityJob();
 		}
 
-		auto brush = std::dynamic_pointer_cast<IBrushNode>(node);
+		return;
+	}
+
+	auto brush = std::dynamic_pointer_cast<IBrushNode>(node);
+
+	if (brush && brush->getIBrush().hasContributingFaces())
+	{
+		if (!dispatch(WriterCall{ WriterCall::EndBrush, IEntityNodePtr(), brush, IPatchNodePtr() })) return;
+		_primitiveNum++;
+		return;
+	}
+
+	auto patch = std::dynamic_pointer_cast<IPatchNode>(node);
+
+	if (patch)
+	{
+		if (!dispatch(WriterCall{ WriterCall::EndPatch, IEntityNodePtr(), IBrushNodePtr(), patch })) return;
+		_primitiveNum++;
+		return;
+	}
+}
 
-		if (brush && brush->getIBrush().hasContributingFaces())
+bool MapExporter::dispatch(WriterCall&& call)
+{
+	if (_writeEntitiesInParallel)
+	{
+		if (_currentJob.calls.empty())
 		{
-			_writer.endWriteBrush(brush, _mapStream);
-			_primitiveNum++;
-			return;
+			_currentJob.firstEntityNum = _entityNum;
 		}
 
-		auto patch = std::dynamic_pointer_cast<IPatchNode>(node);
+		_currentJob.calls.emplace_back(std::move(call));
+		return true;
+	}
+
+	std::string error;
+
+	if (!invokeWriter(call, _writer, _mapStream, error))
+	{
+		rError() << error << std::endl;
+		return false;
+	}
+
+	return true;
+}
 
-		if (patch)
+bool MapExporter::invokeWriter(const WriterCall& call, IMapWriter& writer, std::ostream& stream, std::string& error)
+{
+	try
+	{
+		switch (call.type)
 		{
-			_writer.endWritePatch(patch, _mapStream);
-			_primitiveNum++;
-			return;
+		case WriterCall::BeginEntity:
+			writer.beginWriteEntity(call.entity, stream);
+			break;
+		case WriterCall::EndEntity:
+			writer.endWriteEntity(call.entity, stream);
+			break;
+		case WriterCall::BeginBrush:
+			writer.beginWriteBrush(call.brush, stream);
+			break;
+		case WriterCall::EndBrush:
+			writer.endWriteBrush(call.brush, stream);
+			break;
+		case WriterCall::BeginPatch:
+			writer.beginWritePatch(call.patch, stream);
+			break;
+		case WriterCall::EndPatch:
+			writer.endWritePatch(call.patch, stream);
+			break;
 		}
 	}
 	catch (IMapWriter::FailureException& ex)
 	{
-		rError() << "Failure exporting a node (post): " << ex.what() << std::endl;
+		bool isPre = call.type == WriterCall::BeginEntity || 
+			call.type == WriterCall::BeginBrush || call.type == WriterCall::BeginPatch;
+
+		error = std::string("Failure exporting a node (") + (isPre ? "pre" : "post") + "): " + ex.what();
+		return false;
 	}
+
+	return true;
 }
 
-void MapExporter::onNodeProgress()
+void MapExporter::submitEntityJob()
 {
-	_curNodeCount++;
+	if (_currentJob.calls.empty()) return;
 
-	// Update the dialog text. This will throw an exception if the cancel
-	// button is clicked, which we must catch and handle.
-	if (_dialog && _dialogEventLimiter.readyForEvent())
+	_pendingJobs.emplace_back(GlobalThreadManager().submit(
+		[job = std::move(_currentJob), &writer = _writer, precision = _mapStream.precision()]()
 	{
-		std::string text = fmt::format(_("Writing node {0:d}"), _curNodeCount);
-		_dialog->setTextAndFraction(
-			text, 
-			static_cast<double>(_curNodeCount) / static_cast<double>(_totalNodeCount)
-		);
+		return writeEntities(job, writer, precision);
+	}));
+
+	_currentJob = EntityJob();
+
+	// Write what's done so far, and wait for the oldest job if too many are queued up
+	writeFinishedJobs(false);
+
+	while (_pendingJobs.size() > _maxPendingJobs)
+	{
+		writeNextJob();
 	}
 }
 
-void MapExporter::prepareScene()
+void MapExporter::writeFinishedJobs(bool waitForAll)
 {
-	removeOriginFromChildPrimitives(_root);
+	while (!_pendingJobs.empty())
+	{
+		if (!waitForAll && _pendingJobs.front().wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			break;
+		}
 
-	// Re-evaluate all brushes, to update the Winding calculations
-	recalculateBrushWindings();
+		writeNextJob();
+	}
 }
 
-void MapExporter::finishScene()
+void MapExporter::writeNextJob()
 {
-	addOriginToChildPrimitives(_root);
+	EntityJobResult result = _pendingJobs.front().get();
+	_pendingJobs.pop_front();
+
+	for (const std::string& error : result.errors)
+	{
+		rError() << error << std::endl;
+	}
 
-	// Re-evaluate all brushes, to update the Winding calculations
-	recalculateBrushWindings();
+	_mapStream.write(result.output->data(), result.output->size());
 }
 
-void MapExporter::recalculateBrushWindings()
+MapExporter::EntityJobResult MapExporter::writeEntities(const EntityJob& job, 
+	const IMapWriter& writer, std::streamsize precision)
 {
-	_root->foreachNode([] (const scene::INodePtr& child)->bool
+	EntityJobResult result;
+	result.output.reset(new stream::BufferedOutputStream);
+	result.output->precision(precision);
+
+	std::size_t entityNum = job.firstEntityNum;
+
+	// Each entity gets its own writer, which knows about the entity number
+	IMapWriterPtr entityWriter = writer.createEntityWriter(entityNum);
+
+	for (const WriterCall& call : job.calls)
 	{
-		Brush* brush = Node_getBrush(child);
+		if (call.type == WriterCall::BeginEntity)
+		{
+			entityWriter = writer.createEntityWriter(entityNum);
+		}
+
+		std::string error;
 
-		if (brush != NULL)
+		if (!invokeWriter(call, *entityWriter, *result.output, error))
 		{
-			brush->evaluateBRep();
+			result.errors.emplace_back(std::move(error));
 		}
 
-		return true;
-	});
+		if (call.type == WriterCall::EndEntity)
+		{
+			entityNum++;
+		}
+	}
+
+	return result;
+}
+
+void MapExporter::onNodeProgress()
+{
+	_curNodeCount++;
+
+	// Update the dialog text. This will throw an exception if the cancel
+	// button is clicked, which we must catch and handle.
+	if (_dialog && _dialogEventLimiter.readyForEvent())
+	{
+		std::string text = fmt::format(_("Writing node {0:d}"), _curNodeCount);
+		_dialog->setTextAndFraction(
+			text, 
+			static_cast<double>(_curNodeCount) / static_cast<double>(_totalNodeCount)
+		);
+	}
 }
 
 } // namespace
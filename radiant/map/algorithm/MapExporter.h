@@ -1,8 +1,11 @@
 #pragma once
 
+#include <deque>
+#include <future>
 #include "inode.h"
 #include "imapformat.h"
 #include "igame.h"
+#include "stream/BufferedOutputStream.h"
 
 #include "wxutil/ModalProgressDialog.h"
 #include "../infofile/InfoFileExporter.h"
@@ -21,6 +24,11 @@ namespace map
  * If the progress dialog is enabled (i.e. nodeCount > 0 in constructor)
  * a gtkutil::OperationAbortedException& might be thrown during traversal, 
  * the calling code needs to be able to handle that.
+ *
+ * The output is collected in memory and passed to the target stream in
+ * large chunks. If enabled in the registry and supported by the writer,
+ * the entities are serialised on worker threads into separate buffers,
+ * which are appended to the output in entity order.
  */
 class MapExporter :
 	public scene::NodeVisitor
@@ -29,8 +37,8 @@ private:
 	// The actual map format for writing nodes to the stream
 	IMapWriter& _writer;
 
-	// The stream we're writing to
-	std::ostream& _mapStream;
+	// The stream we're writing to, passing the data on to the target stream in chunks
+	stream::BufferedOutputStream _mapStream;
 
 	// Optional info file exporter (is NULL if no info file should be written)
 	InfoFileExporterPtr _infoFileExporter;
@@ -52,6 +60,54 @@ private:
 	std::size_t _entityNum;
 	std::size_t _primitiveNum;
 
+	// A writer call, recorded during traversal
+	struct WriterCall
+	{
+		enum Type
+		{
+			BeginEntity,
+			EndEntity,
+			BeginBrush,
+			EndBrush,
+			BeginPatch,
+			EndPatch,
+		};
+
+		Type type;
+		IEntityNodePtr entity;
+		IBrushNodePtr brush;
+		IPatchNodePtr patch;
+	};
+
+	// A range of consecutive entities, to be written on a worker thread
+	struct EntityJob
+	{
+		std::size_t firstEntityNum;
+		std::size_t numPrimitives;
+		std::vector<WriterCall> calls;
+
+		EntityJob() :
+			firstEntityNum(0),
+			numPrimitives(0)
+		{}
+	};
+
+	struct EntityJobResult
+	{
+		std::unique_ptr<stream::BufferedOutputStream> output;
+		std::vector<std::string> errors;
+	};
+
+	// Whether entities are written on worker threads
+	bool _writeEntitiesInParallel;
+
+	// The job which is currently being recorded
+	EntityJob _currentJob;
+
+	// The jobs in entity order, waiting to be appended to the output
+	std::deque<std::future<EntityJobResult>> _pendingJobs;
+	std::size_t _maxPendingJobs;
+
 public:
 	// The constructor prepares the scene and the output stream
 	MapExporter(IMapWriter& writer, const scene::INodePtr& root, 
@@ -80,13 +136,24 @@ private:
 
 	void onNodeProgress();
 
-	// Is called before exporting the scene to prepare func_* groups.
-	void prepareScene();
+	// Passes the call to the writer, or records it if entities are written in parallel.
+	// Returns false if the writer failed.
+	bool dispatch(WriterCall&& call);
+
+	// Invokes the writer, returns false and fills in the error message on failure
+	static bool invokeWriter(const WriterCall& call, IMapWriter& writer, std::ostream& stream, std::string& error);
+
+	// Launches a worker for the current job
+	void submitEntityJob();
+
+	// Appends the output of finished jobs to the map stream, optionally waiting for all of them
+	void writeFinishedJobs(bool waitForAll);
 
-	// Called after all the writing has been performed, cleans up func_* groups
-	void finishScene();
+	// Waits for the oldest pending job and appends its output to the map stream
+	void writeNextJob();
 
-	void recalculateBrushWindings();
+	// Worker function, writes the given entities to a separate buffer
+	static EntityJobResult writeEntities(const EntityJob& job, const IMapWriter& writer, std::streamsize precision);
 };
 typedef std::shared_ptr<MapExporter> MapExporterPtr;
 
@@ -7,8 +7,11 @@
 #include "string/string.h"
 
 #include "Doom3MapFormat.h"
+#include "MapFileScanner.h"
+#include "ThreadedPrimitiveParser.h"
 
 #include "i18n.h"
+#include <iterator>
 #include <fmt/format.h>
 
 #include "primitiveparsers/BrushDef.h"
@@ -29,9 +32,37 @@ void Doom3MapReader::readFromStream(std::istream& stream)
 	// Call the virtual method to initialise the primitve parser map (if not done yet)
 	initPrimitiveParsers();
 
-	// The tokeniser used to split the stream into pieces
-	parser::BasicDefTokeniser<std::istream> tok(stream);
+	// Load the whole stream into memory, the scanner needs to see the entire file
+	std::string buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
 
+	// Locate the entity and primitive blocks first
+	MapFileScanner scanner(buffer);
+
+	if (scanner.scan())
+	{
+		const MapFileScanner::Range& header = scanner.getHeader();
+
+		parser::BasicDefTokeniser<std::string_view> tok(std::string_view(buffer).substr(header.begin, header.end - header.begin));
+
+		// Try to parse the map version (throws on failure)
+		parseMapVersion(tok);
+
+		if (!tok.hasMoreTokens())
+		{
+			readEntitiesThreaded(buffer, scanner);
+			return;
+		}
+	}
+
+	// The file doesn't have the structure we expect, parse it token by token
+	// to report any errors exactly the way we always did
+	parser::BasicDefTokeniser<std::string_view> tok(buffer);
+
+	readFromTokeniser(tok);
+}
+
+void Doom3MapReader::readFromTokeniser(parser::DefTokeniser& tok)
+{
 	// Try to parse the map version (throws on failure)
 	parseMapVersion(tok);
 
@@ -58,6 +89,31 @@ void Doom3MapReader::readFromStream(std::istream& stream)
 	// EOF reached, success
 }
 
+void Doom3MapReader::readEntitiesThreaded(const std::string& buffer, const MapFileScanner& scanner)
+{
+	// Start parsing the primitives in the background, the nodes are created in this thread
+	ThreadedPrimitiveParser primitiveParser(buffer, scanner.getPrimitives(), _primitiveParsers);
+
+	primitiveParser.start();
+
+	for (std::size_t i = 0; i < scanner.getEntities().size(); ++i)
+	{
+		try
+		{
+			parseEntity(buffer, scanner, i, primitiveParser);
+		}
+		catch (FailureException& e)
+		{
+			std::string text = fmt::format(_("Failed parsing entity {0:d}:\n{1}"), _entityCount, e.what());
+
+			// Re-throw with more text
+			throw FailureException(text);
+		}
+
+		_entityCount++;
+	}
+}
+
 void Doom3MapReader::initPrimitiveParsers()
 {
 	if (_primitiveParsers.empty())
@@ -155,6 +211,70 @@ void Doom3MapReader::parsePrimitive(parser::DefTokeniser& tok, const scene::INod
 	}
 }
 
+void Doom3MapReader::insertPrimitive(const std::string& buffer, const MapFileScanner& scanner,
+	std::size_t primitiveIndex, ThreadedPrimitiveParser& primitiveParser, const scene::INodePtr& parentEntity)
+{
+	ThreadedPrimitiveParser::Result& result = primitiveParser.waitForResult(primitiveIndex);
+
+	if (result.status == ThreadedPrimitiveParser::Result::NotThreadSafe)
+	{
+		// Let the regular routine handle this one, the tokeniser starts at the keyword
+		const MapFileScanner::Range& range = scanner.getPrimitives()[primitiveIndex];
+
+		parser::BasicDefTokeniser<std::string_view> tok(std::string_view(buffer).substr(range.begin, range.end - range.begin));
+
+		parsePrimitive(tok, parentEntity);
+
+		if (tok.hasMoreTokens())
+		{
+			std::string text = fmt::format(_("Primitive #{0:d}: parse error"), _primitiveCount);
+			throw FailureException(text);
+		}
+
+		return;
+	}
+
+	_primitiveCount++;
+
+	if (result.status == ThreadedPrimitiveParser::Result::UnknownKeyword)
+	{
+		throw FailureException("Unknown primitive type: " + result.keyword);
+	}
+
+	if (result.status == ThreadedPrimitiveParser::Result::Failed)
+	{
+		try
+		{
+			std::rethrow_exception(result.exception);
+		}
+		catch (parser::ParseException& e)
+		{
+			// Translate ParseExceptions to FailureExceptions
+			std::string text = fmt::format(_("Primitive #{0:d}: parse exception {1}"), _primitiveCount, e.what());
+			throw FailureException(text);
+		}
+	}
+
+	scene::INodePtr primitive;
+
+	if (result.status == ThreadedPrimitiveParser::Result::Parsed)
+	{
+		primitive = result.primitive->createNode();
+
+		// The parsed data is not needed anymore
+		result.primitive.reset();
+	}
+
+	if (!primitive)
+	{
+		std::string text = fmt::format(_("Primitive #{0:d}: parse error"), _primitiveCount);
+		throw FailureException(text);
+	}
+
+	// Now add the primitive as a child of the entity
+	_importFilter.addPrimitiveToEntity(primitive, parentEntity);
+}
+
 scene::INodePtr Doom3MapReader::createEntity(const EntityKeyValues& keyValues)
 {
     // Get the classname from the EntityKeyValues
@@ -257,4 +377,72 @@ void Doom3MapReader::parseEntity(parser::DefTokeniser& tok)
 	_importFilter.addEntity(entity);
 }
 
+void Doom3MapReader::parseEntity(const std::string& buffer, const MapFileScanner& scanner,
+	std::size_t entityIndex, ThreadedPrimitiveParser& primitiveParser)
+{
+	const MapFileScanner::Entity& block = scanner.getEntities()[entityIndex];
+
+	// Map of keyvalues for this entity
+	EntityKeyValues keyValues;
+
+	// The actual entity, created when the first primitive or the end of the entity is reached
+	scene::INodePtr entity;
+
+	// Reset the primitive counter, we're starting a new entity
+	_primitiveCount = 0;
+
+	for (std::size_t i = 0; i < block.numPrimitives; ++i)
+	{
+		const MapFileScanner::Range& range = block.keyValues[i];
+
+		parseKeyValues(buffer, range.begin, range.end, "{", keyValues);
+
+		// Create the entity right now, if not yet done
+		if (entity == NULL)
+		{
+			entity = createEntity(keyValues);
+		}
+
+		insertPrimitive(buffer, scanner, block.firstPrimitive + i, primitiveParser, entity);
+	}
+
+	// The keyvalues following the last primitive, if there are any
+	const MapFileScanner::Range& range = block.keyValues.back();
+
+	parseKeyValues(buffer, range.begin, range.end, "}", keyValues);
+
+	// Create the entity if necessary
+	if (entity == NULL)
+	{
+		entity = createEntity(keyValues);
+	}
+
+	// Insert the entity
+	_importFilter.addEntity(entity);
+}
+
+void Doom3MapReader::parseKeyValues(const std::string& buffer, std::size_t begin, std::size_t end,
+	const std::string& terminator, EntityKeyValues& keyValues)
+{
+	parser::BasicDefTokeniser<std::string_view> tok(std::string_view(buffer).substr(begin, end - begin));
+
+	while (tok.hasMoreTokens())
+	{
+		std::string key = tok.nextToken();
+
+		// A missing value means that the key is directly followed by a brace
+		std::string value = tok.hasMoreTokens() ? tok.nextToken() : terminator;
+
+		// Sanity check (invalid number of tokens will get us out of sync)
+		if (value == "{" || value == "}")
+		{
+			std::string text = fmt::format(_("Parsed invalid value '{0}' for key '{1}'"), value, key);
+			throw FailureException(text);
+		}
+
+		// Otherwise add the keyvalue pair to our map
+		keyValues.insert(EntityKeyValues::value_type(key, value));
+	}
+}
+
 } // namespace map
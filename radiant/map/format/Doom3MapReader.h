@@ -8,6 +8,9 @@
 
 namespace map {
 
+class MapFileScanner;
+class ThreadedPrimitiveParser;
+
 class Doom3MapReader :
 	public IMapReader
 {
@@ -43,12 +46,31 @@ protected:
 	// Parse the version tag at the beginning, throws on failure
 	virtual void parseMapVersion(parser::DefTokeniser& tok);
 
+	// Reads version and entities from the given tokeniser, one token after the other
+	void readFromTokeniser(parser::DefTokeniser& tok);
+
+	// Reads the entities found by the given scanner, the primitives are parsed on worker threads.
+	// Primitive types which can't be parsed that way are passed to parsePrimitive() as usual.
+	void readEntitiesThreaded(const std::string& buffer, const MapFileScanner& scanner);
+
+	// Parses an entity located by the scanner, taking its primitives from the threaded parser
+	void parseEntity(const std::string& buffer, const MapFileScanner& scanner, 
+		std::size_t entityIndex, ThreadedPrimitiveParser& primitiveParser);
+
+	// Parses the keyvalue pairs in the given range, terminator is the token following the range
+	void parseKeyValues(const std::string& buffer, std::size_t begin, std::size_t end,
+		const std::string& terminator, EntityKeyValues& keyValues);
+
 	// Parses an entity plus all child primitives, throws on failure
 	virtual void parseEntity(parser::DefTokeniser& tok);
 
 	// Parse the primitive block and insert the child into the given parent
 	virtual void parsePrimitive(parser::DefTokeniser& tok, const scene::INodePtr& parentEntity);
 
+	// Insert a primitive processed by the threaded parser into the given parent
+	void insertPrimitive(const std::string& buffer, const MapFileScanner& scanner, std::size_t primitiveIndex,
+		ThreadedPrimitiveParser& primitiveParser, const scene::INodePtr& parentEntity);
+
 	// Create an entity with the given properties and layers
 	scene::INodePtr createEntity(const EntityKeyValues& keyValues);
 };
@@ -13,13 +13,14 @@ namespace map
 
 Doom3MapWriter::Doom3MapWriter() :
 	_entityCount(0),
-	_primitiveCount(0)
+	_primitiveCount(0),
+	_primitiveTranslation(0, 0, 0)
 {}
 
 void Doom3MapWriter::beginWriteMap(std::ostream& stream)
 {
 	// Write the version tag
-    stream << "Version " << MAP_VERSION_D3 << std::endl;
+    stream << "Version " << MAP_VERSION_D3 << "\n";
 }
 
 void Doom3MapWriter::endWriteMap(std::ostream& stream)
@@ -29,60 +30,93 @@ void Doom3MapWriter::endWriteMap(std::ostream& stream)
 
 void Doom3MapWriter::beginWriteEntity(const IEntityNodePtr& entity, std::ostream& stream)
 {
-	// Write out the entity number comment
-	stream << "// entity " << _entityCount++ << std::endl;
+	beginEntity(EntitySnapshot(entity), stream);
+}
 
-	// Entity opening brace
-	stream << "{" << std::endl;
+void Doom3MapWriter::endWriteEntity(const IEntityNodePtr& entity, std::ostream& stream)
+{
+	endEntity(stream);
+}
 
-	// Entity key values
-	writeEntityKeyValues(entity, stream);
+void Doom3MapWriter::beginWriteBrush(const IBrushNodePtr& brush, std::ostream& stream)
+{
+	writeBrush(BrushSnapshot(brush->getIBrush()), stream);
+}
+
+void Doom3MapWriter::endWriteBrush(const IBrushNodePtr& brush, std::ostream& stream)
+{
+	// nothing
+}
+
+void Doom3MapWriter::beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream)
+{
+	writePatch(PatchSnapshot(patch->getPatch()), stream);
+}
+
+void Doom3MapWriter::endWritePatch(const IPatchNodePtr& patch, std::ostream& stream)
+{
+	// nothing
 }
 
-void Doom3MapWriter::writeEntityKeyValues(const IEntityNodePtr& entity, std::ostream& stream)
+void Doom3MapWriter::beginEntity(const EntitySnapshot& entity, std::ostream& stream)
 {
+	// Write out the entity number comment
+	stream << "// entity " << _entityCount++ << "\n";
+
+	// Entity opening brace
+	stream << "{\n";
+
 	// Export the entity key values
-    entity->getEntity().forEachKeyValue([&](const std::string& key, const std::string& value)
-    {
-        stream << "\"" << key << "\" \"" << value << "\"" << std::endl;
-    });
+	for (const auto& pair : entity.keyValues)
+	{
+		stream << "\"" << pair.first << "\" \"" << pair.second << "\"\n";
+	}
+
+	// Child brushes are moved on the fly, the scene is not touched
+	_primitiveTranslation = entity.primitiveTranslation;
 }
 
-void Doom3MapWriter::endWriteEntity(const IEntityNodePtr& entity, std::ostream& stream)
+void Doom3MapWriter::endEntity(std::ostream& stream)
 {
 	// Write the closing brace for the entity
-	stream << "}" << std::endl;
+	stream << "}\n";
 
 	// Reset the primitive count again
 	_primitiveCount = 0;
+	_primitiveTranslation = Vector3(0, 0, 0);
 }
 
-void Doom3MapWriter::beginWriteBrush(const IBrushNodePtr& brush, std::ostream& stream)
+void Doom3MapWriter::writeBrush(const BrushSnapshot& brush, std::ostream& stream)
 {
 	// Primitive count comment
-	stream << "// primitive " << _primitiveCount++ << std::endl;
+	stream << "// primitive " << _primitiveCount++ << "\n";
 
 	// Export brushDef3 definition to stream
-	BrushDef3Exporter::exportBrush(stream, brush);
+	BrushDef3Exporter::exportBrush(stream, brush, _primitiveTranslation);
 }
 
-void Doom3MapWriter::endWriteBrush(const IBrushNodePtr& brush, std::ostream& stream)
-{
-	// nothing
-}
-
-void Doom3MapWriter::beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream)
+void Doom3MapWriter::writePatch(const PatchSnapshot& patch, std::ostream& stream)
 {
 	// Primitive count comment
-	stream << "// primitive " << _primitiveCount++ << std::endl;
+	stream << "// primitive " << _primitiveCount++ << "\n";
 
 	// Export patch here _mapStream
 	PatchDefExporter::exportPatch(stream, patch);
 }
 
-void Doom3MapWriter::endWritePatch(const IPatchNodePtr& patch, std::ostream& stream)
+IMapWriterPtr Doom3MapWriter::createEntityWriter(std::size_t entityNum) const
 {
-	// nothing
+	std::shared_ptr<Doom3MapWriter> writer = createInstance();
+
+	// Continue the entity numbering, the primitive count starts at 0 for each entity
+	writer->_entityCount = entityNum;
+
+	return writer;
+}
+
+std::shared_ptr<Doom3MapWriter> Doom3MapWriter::createInstance() const
+{
+	return std::make_shared<Doom3MapWriter>();
 }
 
 } // namespace
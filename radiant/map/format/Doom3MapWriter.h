@@ -1,6 +1,8 @@
 #pragma once
 
 #include "imapformat.h"
+#include "math/Vector3.h"
+#include "ExportSnapshot.h"
 
 namespace map
 {
@@ -18,6 +20,9 @@ protected:
 	std::size_t _entityCount;
 	std::size_t _primitiveCount;
 
+	// Brushes of func_* entities are written relative to the entity origin
+	Vector3 _primitiveTranslation;
+
 public:
 	Doom3MapWriter();
 
@@ -36,8 +41,18 @@ public:
 	virtual void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
 	virtual void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
 
+	virtual IMapWriterPtr createEntityWriter(std::size_t entityNum) const override;
+
+	// The node methods above are passing copies of the node values to these,
+	// which can be called directly to write values taken from the scene earlier
+	virtual void beginEntity(const EntitySnapshot& entity, std::ostream& stream);
+	virtual void endEntity(std::ostream& stream);
+	virtual void writeBrush(const BrushSnapshot& brush, std::ostream& stream);
+	virtual void writePatch(const PatchSnapshot& patch, std::ostream& stream);
+
 protected:
-	void writeEntityKeyValues(const IEntityNodePtr& entity, std::ostream& stream);
+	// Returns a fresh instance of this writer type, subclasses need to override this
+	virtual std::shared_ptr<Doom3MapWriter> createInstance() const;
 };
 
 } // namespace
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "ientity.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "math/Vector3.h"
+#include "math/Plane3.h"
+#include "math/Matrix4.h"
+
+#include "../algorithm/ChildPrimitives.h"
+
+namespace map
+{
+
+/**
+ * Copies of the values the map writers are exporting, taken from the scene
+ * nodes. The writers are formatting these instead of the nodes themselves,
+ * so the values can be taken on the main thread and written by any thread
+ * later on, while the scene keeps changing.
+ */
+
+// The brush values written by the brushDef and brushDef3 exporters
+class BrushSnapshot
+{
+public:
+	struct Face
+	{
+		Plane3 plane;
+		Matrix4 texdef;
+		std::string shader;
+
+		// The first three winding points, the brushDef format is defining the plane with them
+		Vector3 points[3];
+	};
+
+	// Only faces with a valid winding, degenerate ones are not exported
+	std::vector<Face> faces;
+
+	IBrush::DetailFlag detailFlag;
+
+	explicit BrushSnapshot(const IBrush& brush) :
+		detailFlag(brush.getDetailFlag())
+	{
+		faces.reserve(brush.getNumFaces());
+
+		for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+		{
+			const IFace& face = brush.getFace(i);
+			const IWinding& winding = face.getWinding();
+
+			if (winding.size() <= 2)
+			{
+				continue;
+			}
+
+			faces.emplace_back(Face{ face.getPlane3(), face.getTexDefMatrix(), face.getShader(),
+				{ winding[0].vertex, winding[1].vertex, winding[2].vertex } });
+		}
+	}
+};
+
+// The patch values written by the patchDef2 and patchDef3 exporters
+class PatchSnapshot
+{
+public:
+	std::string shader;
+
+	std::size_t width;
+	std::size_t height;
+
+	bool subdivisionsFixed;
+	Subdivisions subdivisions;
+
+	// The control points, row by row
+	std::vector<PatchControl> controlPoints;
+
+	explicit PatchSnapshot(const IPatch& patch) :
+		shader(patch.getShader()),
+		width(patch.getWidth()),
+		height(patch.getHeight()),
+		subdivisionsFixed(patch.subdivisionsFixed()),
+		subdivisions(patch.getSubdivisions())
+	{
+		controlPoints.reserve(width * height);
+
+		for (std::size_t r = 0; r < height; ++r)
+		{
+			for (std::size_t c = 0; c < width; ++c)
+			{
+				controlPoints.push_back(patch.ctrlAt(r, c));
+			}
+		}
+	}
+
+	const PatchControl& ctrlAt(std::size_t row, std::size_t col) const
+	{
+		return controlPoints[row * width + col];
+	}
+};
+
+// The entity values written before its primitives
+class EntitySnapshot
+{
+public:
+	std::vector<std::pair<std::string, std::string>> keyValues;
+
+	// Child primitives are exported relative to the origin of func_* entities
+	Vector3 primitiveTranslation;
+
+	explicit EntitySnapshot(const IEntityNodePtr& entity) :
+		primitiveTranslation(getChildPrimitiveTranslation(entity))
+	{
+		entity->getEntity().forEachKeyValue([&](const std::string& key, const std::string& value)
+		{
+			keyValues.emplace_back(key, value);
+		});
+	}
+};
+
+} // namespace
@@ -0,0 +1,170 @@
+#include "MapFileScanner.h"
+
+#include <cstring>
+#include "parser/DefTokeniser.h"
+
+namespace map
+{
+
+MapFileScanner::MapFileScanner(const std::string& buffer) :
+	_buffer(buffer),
+	_header(0, 0)
+{}
+
+bool MapFileScanner::scan()
+{
+	_header = Range(0, _buffer.size());
+	_entities.clear();
+	_primitives.clear();
+
+	const std::size_t size = _buffer.size();
+
+	std::size_t depth = 0;
+	std::size_t keyValueStart = 0;
+	std::size_t primitiveStart = 0;
+
+	for (std::size_t pos = 0; pos < size;)
+	{
+		char c = _buffer[pos];
+
+		if (c == '/')
+		{
+			std::size_t commentEnd = skipComment(pos);
+
+			if (commentEnd != pos)
+			{
+				pos = commentEnd;
+				continue;
+			}
+		}
+
+		if (c == '"')
+		{
+			// Quoted strings are only expected in the header or within entities
+			if (depth == 0 && !_entities.empty())
+			{
+				return false;
+			}
+
+			pos = skipQuotedString(pos);
+			continue;
+		}
+
+		if (c == '{')
+		{
+			if (depth == 0)
+			{
+				// Start of a new entity
+				if (_entities.empty())
+				{
+					_header.end = pos;
+				}
+
+				_entities.push_back(Entity());
+				_entities.back().firstPrimitive = _primitives.size();
+				_entities.back().numPrimitives = 0;
+
+				keyValueStart = pos + 1;
+			}
+			else if (depth == 1)
+			{
+				// Start of a primitive block
+				_entities.back().keyValues.push_back(Range(keyValueStart, pos));
+				primitiveStart = pos + 1;
+			}
+
+			++depth;
+			++pos;
+			continue;
+		}
+
+		if (c == '}')
+		{
+			if (depth == 0)
+			{
+				return false; // unbalanced braces
+			}
+
+			--depth;
+
+			if (depth == 1)
+			{
+				// End of primitive, the closing brace is part of the range
+				_primitives.push_back(Range(primitiveStart, pos + 1));
+				_entities.back().numPrimitives++;
+
+				keyValueStart = pos + 1;
+			}
+			else if (depth == 0)
+			{
+				// End of entity
+				_entities.back().keyValues.push_back(Range(keyValueStart, pos));
+			}
+
+			++pos;
+			continue;
+		}
+
+		// Anything except whitespace between two entities is an error
+		if (depth == 0 && !_entities.empty() && std::strchr(parser::WHITESPACE, c) == nullptr)
+		{
+			return false;
+		}
+
+		++pos;
+	}
+
+	// All entities need to be closed
+	return depth == 0;
+}
+
+std::size_t MapFileScanner::skipQuotedString(std::size_t pos) const
+{
+	const std::size_t size = _buffer.size();
+
+	// Skip the opening quote
+	for (++pos; pos < size; ++pos)
+	{
+		if (_buffer[pos] == '\\')
+		{
+			// Escape sequence, skip the next character too
+			++pos;
+		}
+		else if (_buffer[pos] == '"')
+		{
+			return pos + 1;
+		}
+	}
+
+	return size;
+}
+
+std::size_t MapFileScanner::skipComment(std::size_t pos) const
+{
+	const std::size_t size = _buffer.size();
+
+	if (pos + 1 >= size)
+	{
+		return pos;
+	}
+
+	if (_buffer[pos + 1] == '/')
+	{
+		// Line comment, runs until the end of the line
+		std::size_t lineEnd = _buffer.find_first_of("\r\n", pos + 2);
+
+		return lineEnd != std::string::npos ? lineEnd + 1 : size;
+	}
+
+	if (_buffer[pos + 1] == '*')
+	{
+		// Delimited comment
+		std::size_t commentEnd = _buffer.find("*/", pos + 2);
+
+		return commentEnd != std::string::npos ? commentEnd + 2 : size;
+	}
+
+	return pos;
+}
+
+} // namespace map
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace map
+{
+
+/**
+ * A fast pre-pass over a map file held in memory, splitting it
+ * into the byte ranges of the version header, the entities and their
+ * primitive blocks. Only braces, quoted strings and comments are
+ * considered, which allows the primitive blocks to be handed to
+ * worker threads before any token is actually parsed.
+ *
+ * The scanner follows the same quoting and commenting rules as the
+ * parser::DefTokeniser, so each range can be fed to a tokeniser as is.
+ */
+class MapFileScanner
+{
+public:
+	// A range [begin, end) within the scanned buffer
+	struct Range
+	{
+		std::size_t begin;
+		std::size_t end;
+
+		Range(std::size_t begin_, std::size_t end_) :
+			begin(begin_),
+			end(end_)
+		{}
+	};
+
+	struct Entity
+	{
+		// The index of the first primitive of this entity in the primitive list
+		std::size_t firstPrimitive;
+
+		// The number of primitive blocks of this entity
+		std::size_t numPrimitives;
+
+		// The key/value text before each primitive, plus the text following
+		// the last primitive, so this holds numPrimitives + 1 ranges
+		std::vector<Range> keyValues;
+	};
+
+private:
+	const std::string& _buffer;
+
+	Range _header;
+
+	std::vector<Entity> _entities;
+
+	// All primitive blocks of all entities, each range starts right after
+	// the opening brace and includes the closing one
+	std::vector<Range> _primitives;
+
+public:
+	MapFileScanner(const std::string& buffer);
+
+	/**
+	 * Splits the buffer into the ranges above. Returns false if the structure
+	 * of the file is not what the map parser expects (unbalanced braces,
+	 * non-whitespace characters between entities, etc.), in which case
+	 * the ranges must not be used.
+	 */
+	bool scan();
+
+	// The text in front of the first entity
+	const Range& getHeader() const
+	{
+		return _header;
+	}
+
+	const std::vector<Entity>& getEntities() const
+	{
+		return _entities;
+	}
+
+	const std::vector<Range>& getPrimitives() const
+	{
+		return _primitives;
+	}
+
+private:
+	// Advances the position past the quoted string starting at pos
+	std::size_t skipQuotedString(std::size_t pos) const;
+
+	// Advances the position past the comment starting at pos,
+	// returns pos if there's no comment at this position
+	std::size_t skipComment(std::size_t pos) const;
+};
+
+} // namespace map
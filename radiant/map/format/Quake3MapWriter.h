@@ -18,26 +18,32 @@ public:
 	virtual void beginWriteMap(std::ostream& stream) override
 	{
 		// Write an empty line at the beginning of the file
-		stream << std::endl;
+		stream << "\n";
 	}
 
-	virtual void beginWriteBrush(const IBrushNodePtr& brush, std::ostream& stream) override
+	virtual void writeBrush(const BrushSnapshot& brush, std::ostream& stream) override
 	{
 		// Primitive count comment
-		stream << "// brush " << _primitiveCount++ << std::endl;
+		stream << "// brush " << _primitiveCount++ << "\n";
 
 		// Export brushDef definition to stream
-		BrushDefExporter::exportBrush(stream, brush);
+		BrushDefExporter::exportBrush(stream, brush, _primitiveTranslation);
 	}
 
-	virtual void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override
+	virtual void writePatch(const PatchSnapshot& patch, std::ostream& stream) override
 	{
 		// Primitive count comment, not a typo, patches also seem to have "brush" in their comments
-		stream << "// brush " << _primitiveCount++ << std::endl;
+		stream << "// brush " << _primitiveCount++ << "\n";
 
 		// Export patchDef2 to stream (patchDef3 is not supported)
 		PatchDefExporter::exportQ3PatchDef2(stream, patch);
 	}
+
+protected:
+	virtual std::shared_ptr<Doom3MapWriter> createInstance() const override
+	{
+		return std::make_shared<Quake3MapWriter>();
+	}
 };
 
 } // namespace
@@ -17,16 +17,22 @@ public:
 	virtual void beginWriteMap(std::ostream& stream) override
 	{
 		// Write the version tag
-		stream << "Version " << MAP_VERSION_Q4 << std::endl;
+		stream << "Version " << MAP_VERSION_Q4 << "\n";
 	}
 
-	virtual void beginWriteBrush(const IBrushNodePtr& brush, std::ostream& stream) override
+	virtual void writeBrush(const BrushSnapshot& brush, std::ostream& stream) override
 	{
 		// Primitive count comment
-		stream << "// primitive " << _primitiveCount++ << std::endl;
+		stream << "// primitive " << _primitiveCount++ << "\n";
 
 		// Export brushDef3 definition to stream, but without contents flags
-		BrushDef3Exporter::exportBrush(stream, brush, false);
+		BrushDef3Exporter::exportBrush(stream, brush, _primitiveTranslation, false);
+	}
+
+protected:
+	virtual std::shared_ptr<Doom3MapWriter> createInstance() const override
+	{
+		return std::make_shared<Quake4MapWriter>();
 	}
 };
 
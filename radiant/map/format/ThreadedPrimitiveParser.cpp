@@ -0,0 +1,150 @@
+#include "ThreadedPrimitiveParser.h"
+
+#include <algorithm>
+#include "ithread.h"
+#include "parser/DefTokeniser.h"
+
+namespace map
+{
+
+namespace
+{
+	// The number of primitives a worker processes in one go
+	const std::size_t BATCH_SIZE = 64;
+}
+
+ThreadedPrimitiveParser::ThreadedPrimitiveParser(const std::string& buffer,
+	const std::vector<MapFileScanner::Range>& primitives,
+	const PrimitiveParsers& parsers) :
+	_buffer(buffer),
+	_primitives(primitives),
+	_results(primitives.size()),
+	_batchPromises((primitives.size() + BATCH_SIZE - 1) / BATCH_SIZE),
+	_nextBatch(0),
+	_cancelled(false)
+{
+	// Look up the parsers now, the workers must not touch the (non-const) parser map
+	for (const auto& pair : parsers)
+	{
+		_keywords.insert(pair.first);
+
+		const ThreadSafePrimitiveParser* threadSafeParser =
+			dynamic_cast<const ThreadSafePrimitiveParser*>(pair.second.get());
+
+		if (threadSafeParser != nullptr)
+		{
+			_threadSafeParsers[pair.first] = threadSafeParser;
+		}
+	}
+
+	_batchesDone.reserve(_batchPromises.size());
+
+	for (std::promise<void>& promise : _batchPromises)
+	{
+		_batchesDone.push_back(promise.get_future());
+	}
+}
+
+ThreadedPrimitiveParser::~ThreadedPrimitiveParser()
+{
+	// The caller might be leaving early due to a parse error
+	_cancelled = true;
+
+	for (std::future<void>& worker : _workers)
+	{
+		worker.wait();
+	}
+}
+
+void ThreadedPrimitiveParser::start()
+{
+	// The main thread is busy creating the nodes, it only parses the
+	// batches the pool didn't get to yet
+	std::size_t numWorkers = std::min(GlobalThreadManager().getNumWorkers(), _batchPromises.size());
+
+	for (std::size_t i = 0; i < numWorkers; ++i)
+	{
+		_workers.emplace_back(GlobalThreadManager().submit([this]()
+		{
+			processBatches();
+		}, ThreadManager::Priority::High));
+	}
+}
+
+ThreadedPrimitiveParser::Result& ThreadedPrimitiveParser::waitForResult(std::size_t index)
+{
+	assert(index < _results.size());
+
+	std::future<void>& batchDone = _batchesDone[index / BATCH_SIZE];
+
+	// Don't wait for the workers if they are busy with something else
+	while (batchDone.wait_for(std::chrono::seconds(0)) != std::future_status::ready &&
+		processNextBatch())
+	{}
+
+	batchDone.wait();
+
+	return _results[index];
+}
+
+void ThreadedPrimitiveParser::processBatches()
+{
+	while (!_cancelled && processNextBatch())
+	{}
+}
+
+bool ThreadedPrimitiveParser::processNextBatch()
+{
+	std::size_t batch = _nextBatch++;
+
+	if (batch >= _batchPromises.size())
+	{
+		return false;
+	}
+
+	std::size_t end = std::min((batch + 1) * BATCH_SIZE, _primitives.size());
+
+	for (std::size_t i = batch * BATCH_SIZE; i < end; ++i)
+	{
+		parsePrimitive(i);
+	}
+
+	_batchPromises[batch].set_value();
+
+	return true;
+}
+
+void ThreadedPrimitiveParser::parsePrimitive(std::size_t index)
+{
+	const MapFileScanner::Range& range = _primitives[index];
+	Result& result = _results[index];
+
+	try
+	{
+		parser::BasicDefTokeniser<std::string_view> tok(std::string_view(_buffer).substr(range.begin, range.end - range.begin));
+
+		result.keyword = tok.nextToken();
+
+		auto found = _threadSafeParsers.find(result.keyword);
+
+		if (found == _threadSafeParsers.end())
+		{
+			result.status = _keywords.count(result.keyword) > 0 ?
+				Result::NotThreadSafe : Result::UnknownKeyword;
+			return;
+		}
+
+		result.primitive = found->second->parseData(tok);
+
+		// The parser is supposed to consume everything up to the closing brace
+		result.status = tok.hasMoreTokens() ? Result::TrailingTokens : Result::Parsed;
+	}
+	catch (...)
+	{
+		result.primitive.reset();
+		result.exception = std::current_exception();
+		result.status = Result::Failed;
+	}
+}
+
+} // namespace map
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <atomic>
+#include <future>
+#include <exception>
+#include "imapformat.h"
+
+#include "MapFileScanner.h"
+#include "primitiveparsers/ParsedPrimitive.h"
+
+namespace map
+{
+
+/**
+ * Parses the primitive blocks found by the MapFileScanner on
+ * the workers of the thread pool, such that the map reader can create the
+ * scene nodes on the main thread while the workers continue parsing
+ * the blocks further down the file.
+ *
+ * Primitives are processed in batches, in file order. Only the parsers
+ * deriving from ThreadSafePrimitiveParser are invoked by the workers,
+ * primitives of any other type are left to the caller.
+ */
+class ThreadedPrimitiveParser
+{
+public:
+	struct Result
+	{
+		enum Status
+		{
+			Parsed,			// primitive holds the parsed data
+			UnknownKeyword, // no parser registered for this keyword
+			NotThreadSafe,	// the parser needs to be run by the caller
+			Failed,			// the parser threw, see exception
+			TrailingTokens,	// the parser didn't consume the whole block
+		};
+
+		Status status;
+		std::string keyword;
+		ParsedPrimitivePtr primitive;
+		std::exception_ptr exception;
+	};
+
+	typedef std::map<std::string, PrimitiveParserPtr> PrimitiveParsers;
+
+private:
+	const std::string& _buffer;
+	const std::vector<MapFileScanner::Range>& _primitives;
+
+	std::map<std::string, const ThreadSafePrimitiveParser*> _threadSafeParsers;
+	std::set<std::string> _keywords;
+
+	std::vector<Result> _results;
+
+	// One promise per batch, fulfilled by the worker once it is done
+	std::vector<std::promise<void>> _batchPromises;
+	std::vector<std::future<void>> _batchesDone;
+
+	// The next batch to be picked by a worker
+	std::atomic<std::size_t> _nextBatch;
+
+	std::atomic<bool> _cancelled;
+
+	std::vector<std::future<void>> _workers;
+
+public:
+	ThreadedPrimitiveParser(const std::string& buffer,
+		const std::vector<MapFileScanner::Range>& primitives,
+		const PrimitiveParsers& parsers);
+
+	// Stops and joins all workers
+	~ThreadedPrimitiveParser();
+
+	// Queues the workers in the thread pool
+	void start();
+
+	// Blocks until the primitive with the given index has been processed.
+	// Batches not picked up by a worker yet are parsed by the calling thread.
+	Result& waitForResult(std::size_t index);
+
+private:
+	void processBatches();
+
+	// Claims and parses the next batch, returns false if there are none left
+	bool processNextBatch();
+	void parsePrimitive(std::size_t index);
+};
+
+} // namespace map
@@ -36,16 +36,12 @@ brushDef
 }
 }
 */
-scene::INodePtr BrushDefParser::parse(parser::DefTokeniser& tok) const
+ParsedPrimitivePtr BrushDefParser::parseData(parser::DefTokeniser& tok) const
 {
-	// Create a new brush
-	scene::INodePtr node = GlobalBrushCreator().createBrush();
-
-	// Cast the node, this must succeed
-	IBrushNodePtr brushNode = std::dynamic_pointer_cast<IBrushNode>(node);
-	assert(brushNode != NULL);
+	std::unique_ptr<ParsedBrush> brush(new ParsedBrush);
 
-	IBrush& brush = brushNode->getIBrush();
+	// brushDef has an implicit "textures/" not written to the map
+	brush->addTexturePrefix = true;
 
 	tok.assertNextToken("{");
 
@@ -85,11 +81,14 @@ scene::INodePtr BrushDefParser::parse(parser::DefTokeniser& tok) const
 
 			tok.assertNextToken(")");
 
+			brush->faces.push_back(ParsedBrush::Face());
+			ParsedBrush::Face& face = brush->faces.back();
+
 			// Construct the plane from the three points
-			Plane3 plane(p3, p2, p1);
+			face.plane = Plane3(p3, p2, p1);
 
 			// Parse TexDef
-			Matrix4 texdef;
+			Matrix4& texdef = face.texdef;
 			tok.assertNextToken("(");
 
 			tok.assertNextToken("(");
@@ -106,19 +105,16 @@ scene::INodePtr BrushDefParser::parse(parser::DefTokeniser& tok) const
 
 			tok.assertNextToken(")");
 
-			// Parse Shader, brushDef has an implicit "textures/" not written to the map
-			std::string shader = GlobalTexturePrefix_get() + tok.nextToken();
+			// Parse Shader, the texture prefix is added when the brush is created
+			face.shader = tok.nextToken();
 
 			// Parse Flags (usually each brush has all faces detail or all faces structural)
-			IBrush::DetailFlag flag = static_cast<IBrush::DetailFlag>(
+			brush->detailFlag = static_cast<IBrush::DetailFlag>(
 				string::convert<std::size_t>(tok.nextToken(), IBrush::Structural));
-			brush.setDetailFlag(flag);
+			brush->hasDetailFlag = true;
 
 			// Ignore the other two flags
 			tok.skipTokens(2);
-
-			// Finally, add the new face to the brush
-			/*IFace& face = */brush.addFace(plane, texdef, shader);
 		}
 		else
 		{
@@ -130,7 +126,7 @@ scene::INodePtr BrushDefParser::parse(parser::DefTokeniser& tok) const
 	// Final outer "}"
 	tok.assertNextToken("}");
 
-	return node;
+	return ParsedPrimitivePtr(brush.release());
 }
 
 // Legacy brushDef format
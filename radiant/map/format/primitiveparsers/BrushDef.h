@@ -1,6 +1,6 @@
 #pragma once
 
-#include "imapformat.h"
+#include "ParsedPrimitive.h"
 #include "math/Matrix4.h"
 
 namespace map
@@ -8,12 +8,12 @@ namespace map
 
 // A primitive parser for the "old" brushDef format
 class BrushDefParser :
-	public PrimitiveParser
+	public ThreadSafePrimitiveParser
 {
 public:
 	const std::string& getKeyword() const;
 
-    scene::INodePtr parse(parser::DefTokeniser& tok) const;
+    ParsedPrimitivePtr parseData(parser::DefTokeniser& tok) const;
 };
 typedef std::shared_ptr<BrushDefParser> BrushDefParserPtr;
 
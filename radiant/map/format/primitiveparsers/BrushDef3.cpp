@@ -44,16 +44,9 @@ brushDef3
 #pragma optimize( "", off )
 #endif
 
-scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
+ParsedPrimitivePtr BrushDef3Parser::parseData(parser::DefTokeniser& tok) const
 {
-	// Create a new brush
-	scene::INodePtr node = GlobalBrushCreator().createBrush();
-
-	// Cast the node, this must succeed
-	IBrushNodePtr brushNode = std::dynamic_pointer_cast<IBrushNode>(node);
-	assert(brushNode != NULL);
-
-	IBrush& brush = brushNode->getIBrush();
+	std::unique_ptr<ParsedBrush> brush(new ParsedBrush);
 
 	tok.assertNextToken("{");
 
@@ -69,8 +62,11 @@ scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
 		}
 		else if (token == "(") // FACE
 		{
+			brush->faces.push_back(ParsedBrush::Face());
+			ParsedBrush::Face& face = brush->faces.back();
+
 			// Construct a plane and parse its values
-			Plane3 plane;
+			Plane3& plane = face.plane;
 
 			plane.normal().x() = string::to_float(tok.nextToken());
 			plane.normal().y() = string::to_float(tok.nextToken());
@@ -80,7 +76,7 @@ scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
 			tok.assertNextToken(")");
 
 			// Parse TexDef
-			Matrix4 texdef;
+			Matrix4& texdef = face.texdef;
 			tok.assertNextToken("(");
 
 			tok.assertNextToken("(");
@@ -98,18 +94,15 @@ scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
 			tok.assertNextToken(")");
 
 			// Parse Shader
-			std::string shader = tok.nextToken();
+			face.shader = tok.nextToken();
 
 			// Parse Flags (usually each brush has all faces detail or all faces structural)
-			IBrush::DetailFlag flag = static_cast<IBrush::DetailFlag>(
+			brush->detailFlag = static_cast<IBrush::DetailFlag>(
 				string::convert<std::size_t>(tok.nextToken(), IBrush::Structural));
-			brush.setDetailFlag(flag);
+			brush->hasDetailFlag = true;
 
 			// Ignore the other two flags
 			tok.skipTokens(2);
-
-			// Finally, add the new face to the brush
-			/*IFace& face = */brush.addFace(plane, texdef, shader);
 		}
 		else {
 			std::string text = fmt::format(_("BrushDef3Parser: invalid token '{0}'"), token);
@@ -120,19 +113,12 @@ scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
 	// Final outer "}"
 	tok.assertNextToken("}");
 
-	return node;
+	return ParsedPrimitivePtr(brush.release());
 }
 
-scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
+ParsedPrimitivePtr BrushDef3ParserQuake4::parseData(parser::DefTokeniser& tok) const
 {
-	// Create a new brush
-	scene::INodePtr node = GlobalBrushCreator().createBrush();
-
-	// Cast the node, this must succeed
-	IBrushNodePtr brushNode = std::dynamic_pointer_cast<IBrushNode>(node);
-	assert(brushNode != NULL);
-
-	IBrush& brush = brushNode->getIBrush();
+	std::unique_ptr<ParsedBrush> brush(new ParsedBrush);
 
 	tok.assertNextToken("{");
 
@@ -148,8 +134,11 @@ scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
 		}
 		else if (token == "(") // FACE
 		{
+			brush->faces.push_back(ParsedBrush::Face());
+			ParsedBrush::Face& face = brush->faces.back();
+
 			// Construct a plane and parse its values
-			Plane3 plane;
+			Plane3& plane = face.plane;
 
 			plane.normal().x() = string::to_float(tok.nextToken());
 			plane.normal().y() = string::to_float(tok.nextToken());
@@ -159,7 +148,7 @@ scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
 			tok.assertNextToken(")");
 
 			// Parse TexDef
-			Matrix4 texdef;
+			Matrix4& texdef = face.texdef;
 			tok.assertNextToken("(");
 
 			tok.assertNextToken("(");
@@ -177,10 +166,7 @@ scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
 			tok.assertNextToken(")");
 
 			// Parse Shader
-			std::string shader = tok.nextToken();
-
-			// Finally, add the new face to the brush
-			/*IFace& face = */brush.addFace(plane, texdef, shader);
+			face.shader = tok.nextToken();
 		}
 		else {
 			std::string text = fmt::format(_("BrushDef3ParserQuake4: invalid token '{0}'"), token);
@@ -191,7 +177,7 @@ scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
 	// Final outer "}"
 	tok.assertNextToken("}");
 
-	return node;
+	return ParsedPrimitivePtr(brush.release());
 }
 
 #if _MSC_VER >= 1600
@@ -0,0 +1,78 @@
+#include "ParsedPrimitive.h"
+
+#include "shaderlib.h"
+
+namespace map
+{
+
+// Same as in the brushDef3 parser, switch off optimisations for the addFace() calls,
+// otherwise the planes might get wrong d values assigned
+#if _MSC_VER >= 1600
+#pragma optimize( "", off )
+#endif
+
+scene::INodePtr ParsedBrush::createNode() const
+{
+	// Create a new brush
+	scene::INodePtr node = GlobalBrushCreator().createBrush();
+
+	// Cast the node, this must succeed
+	IBrushNodePtr brushNode = std::dynamic_pointer_cast<IBrushNode>(node);
+	assert(brushNode != NULL);
+
+	IBrush& brush = brushNode->getIBrush();
+
+	if (hasDetailFlag)
+	{
+		brush.setDetailFlag(detailFlag);
+	}
+
+	std::string prefix = addTexturePrefix ? GlobalTexturePrefix_get() : std::string();
+
+	for (const Face& face : faces)
+	{
+		brush.addFace(face.plane, face.texdef, prefix + face.shader);
+	}
+
+	return node;
+}
+
+#if _MSC_VER >= 1600
+#pragma optimize( "", on )
+#endif
+
+scene::INodePtr ParsedPatch::createNode() const
+{
+	scene::INodePtr node = GlobalPatchCreator(type).createPatch();
+
+	IPatchNodePtr patchNode = std::dynamic_pointer_cast<IPatchNode>(node);
+	assert(patchNode != NULL);
+
+	IPatch& patch = patchNode->getPatch();
+
+	patch.setShader(addTexturePrefix ? GlobalTexturePrefix_get() + shader : shader);
+
+	patch.setDims(width, height);
+
+	if (fixedSubdivisions)
+	{
+		patch.setFixedSubdivisions(true, subdivisions);
+	}
+
+	// The control points are stored column by column
+	std::vector<PatchControl>::const_iterator ctrl = controlPoints.begin();
+
+	for (std::size_t c = 0; c < width; c++)
+	{
+		for (std::size_t r = 0; r < height; r++)
+		{
+			patch.ctrlAt(r, c) = *ctrl++;
+		}
+	}
+
+	patch.controlPointsChanged();
+
+	return node;
+}
+
+} // namespace map
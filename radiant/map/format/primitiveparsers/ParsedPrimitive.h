@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+#include "imapformat.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "math/Matrix4.h"
+#include "math/Plane3.h"
+
+namespace map
+{
+
+/**
+ * The values of a single map primitive as read from the token
+ * stream, stored in plain data structures without touching any module.
+ * The actual scene node is constructed in a second step by createNode(),
+ * which needs to be invoked on the main thread.
+ */
+class ParsedPrimitive
+{
+public:
+	virtual ~ParsedPrimitive() {}
+
+	// Creates the scene node from the parsed values
+	virtual scene::INodePtr createNode() const = 0;
+};
+typedef std::unique_ptr<ParsedPrimitive> ParsedPrimitivePtr;
+
+/**
+ * A primitive parser splitting its work into the two steps above.
+ * Since parseData() doesn't access any modules it is safe to call it
+ * from worker threads, which is what the Doom3MapReader is doing.
+ */
+class ThreadSafePrimitiveParser :
+	public PrimitiveParser
+{
+public:
+	// Reads the primitive from the given tokeniser, throws parser::ParseException on failure
+	virtual ParsedPrimitivePtr parseData(parser::DefTokeniser& tok) const = 0;
+
+	scene::INodePtr parse(parser::DefTokeniser& tok) const override
+	{
+		return parseData(tok)->createNode();
+	}
+};
+typedef std::shared_ptr<ThreadSafePrimitiveParser> ThreadSafePrimitiveParserPtr;
+
+// Brush data as parsed from brushDef and brushDef3 blocks
+class ParsedBrush :
+	public ParsedPrimitive
+{
+public:
+	struct Face
+	{
+		Plane3 plane;
+		Matrix4 texdef;
+		std::string shader;
+	};
+
+	std::vector<Face> faces;
+
+	// Whether any face carried the detail flag (Quake 4 brushes don't)
+	bool hasDetailFlag;
+
+	// The flag of the last face, which is what the brush ends up with
+	IBrush::DetailFlag detailFlag;
+
+	// Set this to prepend the global texture prefix to each shader name
+	bool addTexturePrefix;
+
+	ParsedBrush() :
+		hasDetailFlag(false),
+		detailFlag(IBrush::Structural),
+		addTexturePrefix(false)
+	{}
+
+	scene::INodePtr createNode() const override;
+};
+
+// Patch data as parsed from patchDef2 and patchDef3 blocks
+class ParsedPatch :
+	public ParsedPrimitive
+{
+public:
+	PatchDefType type;
+
+	std::string shader;
+
+	// Set this to prepend the global texture prefix to the shader name
+	bool addTexturePrefix;
+
+	std::size_t width;
+	std::size_t height;
+
+	// Fixed tesselation, patchDef3 only
+	bool fixedSubdivisions;
+	Subdivisions subdivisions;
+
+	// The control points, in the order they appear in the file (column by column)
+	std::vector<PatchControl> controlPoints;
+
+	ParsedPatch(PatchDefType type_) :
+		type(type_),
+		addTexturePrefix(false),
+		width(0),
+		height(0),
+		fixedSubdivisions(false),
+		subdivisions(0, 0)
+	{}
+
+	scene::INodePtr createNode() const override;
+};
+
+} // namespace map
@@ -5,32 +5,47 @@
 
 #include "string/convert.h"
 #include "parser/DefTokeniser.h"
+#include "patch/PatchConstants.h"
+#include <fmt/format.h>
 
 namespace map
 {
 
-void PatchParser::parseMatrix(parser::DefTokeniser& tok, IPatch& patch) const
+void PatchParser::parseMatrix(parser::DefTokeniser& tok, ParsedPatch& patch) const
 {
+	// The patch would silently change any dimensions it can't handle,
+	// leaving us with a matrix that doesn't match the parsed one
+	if (patch.width % 2 == 0 || patch.width < MIN_PATCH_WIDTH || patch.width > MAX_PATCH_WIDTH ||
+		patch.height < MIN_PATCH_HEIGHT || patch.height > MAX_PATCH_HEIGHT)
+	{
+		throw parser::ParseException(fmt::format("PatchParser: invalid patch dimensions {0}x{1}", 
+			patch.width, patch.height));
+	}
+
+	patch.controlPoints.resize(patch.width * patch.height);
+
+	std::vector<PatchControl>::iterator ctrl = patch.controlPoints.begin();
+
 	tok.assertNextToken("(");
 
 	// For each row
-	for (std::size_t c = 0; c < patch.getWidth(); c++)
+	for (std::size_t c = 0; c < patch.width; c++)
 	{
 		tok.assertNextToken("(");
 
 		// For each column
-		for (std::size_t r=0; r < patch.getHeight(); r++)
+		for (std::size_t r=0; r < patch.height; r++, ++ctrl)
 		{
 			tok.assertNextToken("(");
 
 			// Parse vertex coordinates
-			patch.ctrlAt(r, c).vertex[0] = string::to_float(tok.nextToken());
-			patch.ctrlAt(r, c).vertex[1] = string::to_float(tok.nextToken());
-			patch.ctrlAt(r, c).vertex[2] = string::to_float(tok.nextToken());
+			ctrl->vertex[0] = string::to_float(tok.nextToken());
+			ctrl->vertex[1] = string::to_float(tok.nextToken());
+			ctrl->vertex[2] = string::to_float(tok.nextToken());
 
 			// Parse texture coordinates
-			patch.ctrlAt(r, c).texcoord[0] = string::to_float(tok.nextToken());
-			patch.ctrlAt(r, c).texcoord[1] = string::to_float(tok.nextToken());
+			ctrl->texcoord[0] = string::to_float(tok.nextToken());
+			ctrl->texcoord[1] = string::to_float(tok.nextToken());
 
 			tok.assertNextToken(")");
 		}
@@ -1,19 +1,19 @@
 #ifndef Patch_h__
 #define Patch_h__
 
-#include "imapformat.h"
-#include "ipatch.h"
+#include "ParsedPrimitive.h"
 
 namespace map
 {
 
 // Common base class for PatchDef2Parser and PatchDef3Parser
 class PatchParser :
-	public PrimitiveParser
+	public ThreadSafePrimitiveParser
 {
 protected:
-	// Parses the control point matrix. The given patch must have its dimensions set before this call.
-	void parseMatrix(parser::DefTokeniser& tok, IPatch& patch) const;
+	// Parses the control point matrix. The given patch must have its dimensions set before this call,
+	// throws a ParseException if these are not within the valid range.
+	void parseMatrix(parser::DefTokeniser& tok, ParsedPatch& patch) const;
 };
 
 } // namespace map
@@ -11,10 +11,10 @@ class PatchDef2Parser :
 public:
 	const std::string& getKeyword() const;
 
-    scene::INodePtr parse(parser::DefTokeniser& tok) const;
+    ParsedPrimitivePtr parseData(parser::DefTokeniser& tok) const;
 
 protected:
-	virtual void setShader(IPatch& patch, const std::string& shader) const;
+	virtual void setShader(ParsedPatch& patch, const std::string& shader) const;
 };
 typedef std::shared_ptr<PatchDef2Parser> PatchDef2ParserPtr;
 
@@ -23,7 +23,7 @@ class PatchDef2ParserQ3 :
 	public PatchDef2Parser
 {
 protected:
-	virtual void setShader(IPatch& patch, const std::string& shader) const;
+	virtual void setShader(ParsedPatch& patch, const std::string& shader) const;
 };
 typedef std::shared_ptr<PatchDef2Parser> PatchDef2ParserPtr;
 
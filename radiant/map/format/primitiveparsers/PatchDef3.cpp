@@ -34,33 +34,27 @@ patchDef3
 }
 }
 */
-scene::INodePtr PatchDef3Parser::parse(parser::DefTokeniser& tok) const
+ParsedPrimitivePtr PatchDef3Parser::parseData(parser::DefTokeniser& tok) const
 {
-	scene::INodePtr node = GlobalPatchCreator(PatchDefType::Def3).createPatch();
-
-	IPatchNodePtr patchNode = std::dynamic_pointer_cast<IPatchNode>(node);
-	assert(patchNode != NULL);
-
-	IPatch& patch = patchNode->getPatch();
+	std::unique_ptr<ParsedPatch> patch(new ParsedPatch(PatchDefType::Def3));
 
 	tok.assertNextToken("{");
 
 	// Parse shader
-	patch.setShader(tok.nextToken());
+	patch->shader = tok.nextToken();
 
 	// Parse parameters
 	tok.assertNextToken("(");
 
-	std::size_t cols = string::convert<std::size_t>(tok.nextToken());
-	std::size_t rows = string::convert<std::size_t>(tok.nextToken());
-
-	patch.setDims(cols, rows);
+	patch->width = string::convert<std::size_t>(tok.nextToken());
+	patch->height = string::convert<std::size_t>(tok.nextToken());
 
 	// Parse fixed tesselation
 	std::size_t subdivX = string::convert<std::size_t>(tok.nextToken());
 	std::size_t subdivY = string::convert<std::size_t>(tok.nextToken());
 
-	patch.setFixedSubdivisions(true, Subdivisions(subdivX, subdivY));
+	patch->fixedSubdivisions = true;
+	patch->subdivisions = Subdivisions(subdivX, subdivY);
 
 	// ignore contents/flags values
 	tok.skipTokens(3);
@@ -68,15 +62,13 @@ scene::INodePtr PatchDef3Parser::parse(parser::DefTokeniser& tok) const
 	tok.assertNextToken(")");
 
 	// Parse Patch Matrix
-	parseMatrix(tok, patch);
+	parseMatrix(tok, *patch);
 
 	// Parse Footer
 	tok.assertNextToken("}");
 	tok.assertNextToken("}");
 
-	patch.controlPointsChanged();
-
-	return node;
+	return ParsedPrimitivePtr(patch.release());
 }
 
 } // namespace map
@@ -1,72 +1,46 @@
 #pragma once
 
-#include "ibrush.h"
-#include "math/Plane3.h"
-#include "math/Matrix4.h"
+#include "../ExportSnapshot.h"
+#include "ExportUtil.h"
 
 namespace map
 {
 
-namespace
-{
-	// Writes a double to the given stream and checks for NaN and infinity
-	inline void writeDoubleSafe(const double d, std::ostream& os)
-	{
-		if (isValid(d))
-		{
-			if (d == -0.0)
-			{
-				os << 0; // convert -0 to 0
-			}
-			else
-			{
-				os << d;
-			}
-		}
-		else
-		{
-			// Is infinity or NaN, write 0
-			os << "0";
-		}
-	}
-}
-
 class BrushDef3Exporter
 {
 public:
 
-	// Writes a brushDef3 definition from the given brush to the given stream
-	static void exportBrush(std::ostream& stream, const IBrushNodePtr& brushNode, bool writeContentsFlags = true)
+	// Writes a brushDef3 definition from the given brush to the given stream,
+	// the brush is moved by the given translation on the fly
+	static void exportBrush(std::ostream& stream, const BrushSnapshot& brush,
+		const Vector3& translation, bool writeContentsFlags = true)
 	{
-		const IBrush& brush = brushNode->getIBrush();
-
 		// Brush decl header
-		stream << "{" << std::endl;
-		stream << "brushDef3" << std::endl;
-		stream << "{" << std::endl;
+		stream << "{\n";
+		stream << "brushDef3\n";
+		stream << "{\n";
 
 		// Iterate over each brush face, exporting the tokens from all faces
-		for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+		for (const BrushSnapshot::Face& face : brush.faces)
 		{
-			writeFace(stream, brush.getFace(i), writeContentsFlags, brush.getDetailFlag());
+			writeFace(stream, face, translation, writeContentsFlags, brush.detailFlag);
 		}
 
 		// Close brush contents and header
-		stream << "}" << std::endl << "}" << std::endl;
+		stream << "}\n}\n";
 	}
 
 private:
 
-	static void writeFace(std::ostream& stream, const IFace& face, bool writeContentsFlags, IBrush::DetailFlag detailFlag)
+	static void writeFace(std::ostream& stream, const BrushSnapshot::Face& face, const Vector3& translation,
+		bool writeContentsFlags, IBrush::DetailFlag detailFlag)
 	{
-		// greebo: Don't export faces with degenerate or empty windings (they are "non-contributing")
-		if (face.getWinding().size() <= 2)
-		{
-			return;
-		}
+		// Write the plane equation, translated the same way FacePlane::translate() does
+		Plane3 plane = face.plane;
 
-		// Write the plane equation
-		const Plane3& plane = face.getPlane3();
+		plane.dist() = -plane.dist();
+		plane.translate(translation);
+		plane.dist() = -plane.dist();
 
 		stream << "( ";
 		writeDoubleSafe(plane.normal().x(), stream);
@@ -80,7 +54,7 @@ private:
 		stream << ") ";
 
 		// Write TexDef
-		Matrix4 texdef = face.getTexDefMatrix();
+		const Matrix4& texdef = face.texdef;
 		stream << "( ";
 
 		stream << "( ";
@@ -102,7 +76,7 @@ private:
 		stream << ") ";
 
 		// Write Shader
-		const std::string& shaderName = face.getShader();
+		const std::string& shaderName = face.shader;
 
 		if (shaderName.empty()) {
 			stream << "\"_default\" ";
@@ -117,7 +91,7 @@ private:
 			stream << detailFlag << " 0 0";
 		}
 
-		stream << std::endl;
+		stream << "\n";
 	}
 };
 
@@ -1,61 +1,35 @@
 #pragma once
 
-#include "ibrush.h"
-#include "math/Plane3.h"
-#include "math/Matrix4.h"
 #include "shaderlib.h"
+#include "../ExportSnapshot.h"
 
 #include "string/predicate.h"
+#include "ExportUtil.h"
 
 namespace map
 {
 
-namespace
-{
-	// Writes a double to the given stream and checks for NaN and infinity
-	inline void writeDoubleSafe(const double d, std::ostream& os)
-	{
-		if (isValid(d))
-		{
-			if (d == -0.0)
-			{
-				os << 0; // convert -0 to 0
-			}
-			else
-			{
-				os << d;
-			}
-		}
-		else
-		{
-			// Is infinity or NaN, write 0
-			os << "0";
-		}
-	}
-}
-
 class BrushDefExporter
 {
 public:
 
-	// Writes a Q3-style brushDef definition from the given brush to the given stream
-	static void exportBrush(std::ostream& stream, const IBrushNodePtr& brushNode)
+	// Writes a Q3-style brushDef definition from the given brush to the given stream,
+	// the brush is moved by the given translation on the fly
+	static void exportBrush(std::ostream& stream, const BrushSnapshot& brush, const Vector3& translation)
 	{
-		const IBrush& brush = brushNode->getIBrush();
-
 		// Brush decl header
-		stream << "{" << std::endl;
-		stream << "brushDef" << std::endl;
-		stream << "{" << std::endl;
+		stream << "{\n";
+		stream << "brushDef\n";
+		stream << "{\n";
 
 		// Iterate over each brush face, exporting the tokens from all faces
-		for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+		for (const BrushSnapshot::Face& face : brush.faces)
 		{
-			writeFace(stream, brush.getFace(i), brush.getDetailFlag());
+			writeFace(stream, face, translation, brush.detailFlag);
 		}
 
 		// Close brush contents and header
-		stream << "}" << std::endl << "}" << std::endl;
+		stream << "}\n}\n";
 	}
 
 	/* 
@@ -72,47 +46,40 @@ public:
 
 private:
 
-	static void writeFace(std::ostream& stream, const IFace& face, IBrush::DetailFlag detailFlag)
+	static void writeFace(std::ostream& stream, const BrushSnapshot::Face& face, const Vector3& translation, IBrush::DetailFlag detailFlag)
 	{
-		// greebo: Don't export faces with degenerate or empty windings (they are "non-contributing")
-		const IWinding& winding = face.getWinding();
-
-		if (winding.size() <= 2)
-		{
-			return;
-		}
-
 		// Each face plane is defined by three points
+		const Vector3* points = face.points;
 
 		stream << "( ";
-		writeDoubleSafe(winding[2].vertex.x(), stream);
+		writeDoubleSafe(points[2].x() + translation.x(), stream);
 		stream << " ";
-		writeDoubleSafe(winding[2].vertex.y(), stream);
+		writeDoubleSafe(points[2].y() + translation.y(), stream);
 		stream << " ";
-		writeDoubleSafe(winding[2].vertex.z(), stream);
+		writeDoubleSafe(points[2].z() + translation.z(), stream);
 		stream << " ";
 		stream << ") ";
 
 		stream << "( ";
-		writeDoubleSafe(winding[0].vertex.x(), stream);
+		writeDoubleSafe(points[0].x() + translation.x(), stream);
 		stream << " ";
-		writeDoubleSafe(winding[0].vertex.y(), stream);
+		writeDoubleSafe(points[0].y() + translation.y(), stream);
 		stream << " ";
-		writeDoubleSafe(winding[0].vertex.z(), stream);
+		writeDoubleSafe(points[0].z() + translation.z(), stream);
 		stream << " ";
 		stream << ") ";
 
 		stream << "( ";
-		writeDoubleSafe(winding[1].vertex.x(), stream);
+		writeDoubleSafe(points[1].x() + translation.x(), stream);
 		stream << " ";
-		writeDoubleSafe(winding[1].vertex.y(), stream);
+		writeDoubleSafe(points[1].y() + translation.y(), stream);
 		stream << " ";
-		writeDoubleSafe(winding[1].vertex.z(), stream);
+		writeDoubleSafe(points[1].z() + translation.z(), stream);
 		stream << " ";
 		stream << ") ";
 
 		// Write TexDef
-		Matrix4 texdef = face.getTexDefMatrix();
+		const Matrix4& texdef = face.texdef;
 		stream << "( ";
 
 		stream << "( ";
@@ -134,7 +101,7 @@ private:
 		stream << ") ";
 
 		// Write Shader (without quotes)
-		const std::string& shaderName = face.getShader();
+		const std::string& shaderName = face.shader;
 
 		if (shaderName.empty())
 		{
@@ -156,7 +123,7 @@ private:
 		// Export (dummy) contents/flags
 		stream << detailFlag << " 0 0";
 		
-		stream << std::endl;
+		stream << "\n";
 	}
 };
 
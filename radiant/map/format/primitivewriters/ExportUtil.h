@@ -0,0 +1,178 @@
+#pragma once
+
+#include <ostream>
+#include <cstdint>
+#include <cmath>
+#include "math/FloatTools.h"
+#include <fmt/format.h>
+
+namespace map
+{
+
+namespace detail
+{
+
+/**
+ * Formats the given finite, non-zero double the same way printf("%.*g")
+ * does, without calling into the C library. Only values which can be written
+ * exactly with the given number of significant digits are handled, that is
+ * integers and binary fractions like 0.5 or 0.015625 (which is what most of a
+ * map file is made of). Returns the number of characters written to the buffer
+ * (which needs to have room for 32 chars), or 0 if the value is not covered.
+ */
+inline std::size_t formatDoubleExact(double d, int precision, char* buffer)
+{
+	if (precision < 1 || precision > 17)
+	{
+		return 0;
+	}
+
+	int exponent;
+	double mantissa = std::frexp(std::fabs(d), &exponent);
+
+	// Split the value into an integer and a power of two: value = bits * 2^exponent
+	std::uint64_t bits = static_cast<std::uint64_t>(std::ldexp(mantissa, 53));
+	exponent -= 53;
+
+	if (bits == 0)
+	{
+		return 0;
+	}
+
+	while ((bits & 1) == 0)
+	{
+		bits >>= 1;
+		++exponent;
+	}
+
+	std::uint64_t integerPart;
+	std::uint64_t fraction = 0;
+	int fractionDigits = 0;
+
+	if (exponent >= 0)
+	{
+		if (exponent > 10) return 0; // 2^63 and above
+
+		integerPart = bits << exponent;
+	}
+	else
+	{
+		// Every binary fraction digit adds one decimal digit, 5^19 * 2^19 still fits
+		fractionDigits = -exponent;
+
+		if (fractionDigits > 19) return 0;
+
+		integerPart = bits >> fractionDigits;
+		fraction = bits & ((std::uint64_t(1) << fractionDigits) - 1);
+
+		// fraction / 2^n == fraction * 5^n / 10^n
+		for (int i = 0; i < fractionDigits; ++i)
+		{
+			fraction *= 5;
+		}
+	}
+
+	char digits[20];
+	int integerDigits = 0;
+
+	for (std::uint64_t rest = integerPart; rest > 0; rest /= 10)
+	{
+		digits[integerDigits++] = static_cast<char>('0' + rest % 10);
+	}
+
+	int significantDigits;
+	int decimalExponent;
+
+	if (integerPart > 0)
+	{
+		significantDigits = integerDigits + fractionDigits;
+		decimalExponent = integerDigits - 1;
+	}
+	else
+	{
+		// Count the leading zeros of the fraction
+		int fractionLength = 0;
+
+		for (std::uint64_t rest = fraction; rest > 0; rest /= 10)
+		{
+			++fractionLength;
+		}
+
+		significantDigits = fractionLength;
+		decimalExponent = fractionLength - fractionDigits - 1;
+	}
+
+	// Anything else would need rounding or the exponential notation
+	if (significantDigits > precision || decimalExponent < -4 || decimalExponent >= precision)
+	{
+		return 0;
+	}
+
+	char* out = buffer;
+
+	if (d < 0)
+	{
+		*out++ = '-';
+	}
+
+	if (integerDigits == 0)
+	{
+		*out++ = '0';
+	}
+
+	while (integerDigits > 0)
+	{
+		*out++ = digits[--integerDigits];
+	}
+
+	if (fractionDigits > 0)
+	{
+		*out++ = '.';
+
+		// The last fraction digit is always a 5, there are no trailing zeros
+		for (int i = fractionDigits - 1; i >= 0; --i)
+		{
+			out[i] = static_cast<char>('0' + fraction % 10);
+			fraction /= 10;
+		}
+
+		out += fractionDigits;
+	}
+
+	return out - buffer;
+}
+
+} // namespace detail
+
+/**
+ * Writes a double to the given stream and checks for NaN and infinity.
+ * The output is the same as the one of os << d, using the precision of the stream.
+ */
+inline void writeDoubleSafe(const double d, std::ostream& os)
+{
+	if (!isValid(d) || d == 0)
+	{
+		// Is infinity or NaN, write 0, also convert -0 to 0
+		os.put('0');
+		return;
+	}
+
+	// A negative precision is treated like the default one
+	int precision = os.precision() < 0 ? 6 : static_cast<int>(os.precision());
+
+	char buffer[32];
+	std::size_t length = detail::formatDoubleExact(d, precision, buffer);
+
+	if (length > 0)
+	{
+		os.write(buffer, length);
+		return;
+	}
+
+	// Format everything else the way the stream would do it
+	fmt::memory_buffer formatted;
+	fmt::format_to(formatted, "{:.{}g}", d, precision);
+	os.write(formatted.data(), formatted.size());
+}
+
+}
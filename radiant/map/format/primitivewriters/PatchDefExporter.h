@@ -1,46 +1,22 @@
 #pragma once
 
 #include "shaderlib.h"
-#include "ipatch.h"
+#include "../ExportSnapshot.h"
 
 #include "string/predicate.h"
+#include "ExportUtil.h"
 
 namespace map
 {
 
-namespace
-{
-	inline void writePatchDouble(const double d, std::ostream& os)
-	{
-		if (isValid(d))
-		{
-			if (d == -0.0)
-			{
-				os << 0; // convert -0 to 0
-			}
-			else
-			{
-				os << d;
-			}
-		}
-		else
-		{
-			// Is infinity or NaN, write 0
-			os << "0";
-		}
-	}
-}
-
 class PatchDefExporter
 {
 public:
 
 	// Writes a patchDef2/3 definition from the given patch to the given stream
-	static void exportPatch(std::ostream& stream, const IPatchNodePtr& patchNode)
+	static void exportPatch(std::ostream& stream, const PatchSnapshot& patch)
 	{
-		const IPatch& patch = patchNode->getPatch();
-
-		if (patch.subdivisionsFixed())
+		if (patch.subdivisionsFixed)
 		{
 			exportPatchDef3(stream, patch);
 		}
@@ -51,10 +27,8 @@ public:
 	}
 
 	// Export a patchDef2 declaration, Q3-style
-	static void exportQ3PatchDef2(std::ostream& stream, const IPatchNodePtr& patchNode)
+	static void exportQ3PatchDef2(std::ostream& stream, const PatchSnapshot& patch)
 	{
-		const IPatch& patch = patchNode->getPatch();
-
 		// Export patch declaration
 		stream << "{\n";
 		stream << "patchDef2\n";
@@ -64,8 +38,8 @@ public:
 
 		// Export patch dimension / parameters
 		stream << "( ";
-		stream << patch.getWidth() << " ";
-		stream << patch.getHeight() << " ";
+		stream << patch.width << " ";
+		stream << patch.height << " ";
 
 		// empty contents/flags
 		stream << "0 0 0 )\n";
@@ -77,7 +51,7 @@ public:
 
 private:
 	// Export a patchDef3 declaration (fixed subdivisions)
-	static void exportPatchDef3(std::ostream& stream, const IPatch& patch)
+	static void exportPatchDef3(std::ostream& stream, const PatchSnapshot& patch)
 	{
 		// Export patch declaration
 		stream << "{\n";
@@ -88,12 +62,12 @@ private:
 
 		// Export patch dimension / parameters
 		stream << "( ";
-		stream << patch.getWidth() << " ";
-		stream << patch.getHeight() << " ";
+		stream << patch.width << " ";
+		stream << patch.height << " ";
 
-		assert(patch.subdivisionsFixed());
+		assert(patch.subdivisionsFixed);
 
-		Subdivisions divisions = patch.getSubdivisions();
+		const Subdivisions& divisions = patch.subdivisions;
 		stream << divisions.x() << " ";
 		stream << divisions.y() << " ";
 
@@ -106,7 +80,7 @@ private:
 	}
 
 	// Export a patchDef2 declaration, D3-style
-	static void exportPatchDef2(std::ostream& stream, const IPatch& patch)
+	static void exportPatchDef2(std::ostream& stream, const PatchSnapshot& patch)
 	{
 		// Export patch declaration
 		stream << "{\n";
@@ -117,8 +91,8 @@ private:
 
 		// Export patch dimension / parameters
 		stream << "( ";
-		stream << patch.getWidth() << " ";
-		stream << patch.getHeight() << " ";
+		stream << patch.width << " ";
+		stream << patch.height << " ";
 
 		// empty contents/flags
 		stream << "0 0 0 )\n";
@@ -128,10 +102,10 @@ private:
 		stream << "}\n}\n";
 	}
 
-	static void exportShader(std::ostream& stream, const IPatch& patch)
+	static void exportShader(std::ostream& stream, const PatchSnapshot& patch)
 	{
 		// Export shader
-		const std::string& shaderName = patch.getShader();
+		const std::string& shaderName = patch.shader;
 
 		if (shaderName.empty())
 		{
@@ -145,10 +119,10 @@ private:
 	}
 
 	// Q3 shader declarations are missing their textures/ prefix and don't use quotes
-	static void exportQ3Shader(std::ostream& stream, const IPatch& patch)
+	static void exportQ3Shader(std::ostream& stream, const PatchSnapshot& patch)
 	{
 		// Export shader
-		const std::string& shaderName = patch.getShader();
+		const std::string& shaderName = patch.shader;
 
 		if (shaderName.empty())
 		{
@@ -169,27 +143,27 @@ private:
 		stream << "\n";
 	}
 
-	static void exportPatchControlMatrix(std::ostream& stream, const IPatch& patch)
+	static void exportPatchControlMatrix(std::ostream& stream, const PatchSnapshot& patch)
 	{
 		// Export the control point matrix
 		stream << "(\n";
 
-		for (std::size_t c = 0; c < patch.getWidth(); c++)
+		for (std::size_t c = 0; c < patch.width; c++)
 		{
 			stream << "( ";
 
-			for (std::size_t r = 0; r < patch.getHeight(); r++)
+			for (std::size_t r = 0; r < patch.height; r++)
 			{
 				stream << "( ";
-				writePatchDouble(patch.ctrlAt(r,c).vertex[0], stream);
+				writeDoubleSafe(patch.ctrlAt(r,c).vertex[0], stream);
 				stream << " ";
-				writePatchDouble(patch.ctrlAt(r,c).vertex[1], stream);
+				writeDoubleSafe(patch.ctrlAt(r,c).vertex[1], stream);
 				stream << " ";
-				writePatchDouble(patch.ctrlAt(r,c).vertex[2], stream);
+				writeDoubleSafe(patch.ctrlAt(r,c).vertex[2], stream);
 				stream << " ";
-				writePatchDouble(patch.ctrlAt(r,c).texcoord[0], stream);
+				writeDoubleSafe(patch.ctrlAt(r,c).texcoord[0], stream);
 				stream << " ";
-				writePatchDouble(patch.ctrlAt(r,c).texcoord[1], stream);
+				writeDoubleSafe(patch.ctrlAt(r,c).texcoord[1], stream);
 				stream << " ) ";
 			}
 
@@ -67,4 +67,10 @@ void MD5AnimationCache::shutdownModule()
 	_animations.clear();
 }
 
+bool MD5AnimationCache::isInitialisationThreadSafe() const
+{
+	// Nothing but our own state is touched during initialisation
+	return true;
+}
+
 } // namespace
@@ -25,6 +25,7 @@ public:
 	const StringSet& getDependencies() const;
 	void initialiseModule(const ApplicationContext& ctx);
 	void shutdownModule();
+	bool isInitialisationThreadSafe() const;
 };
 typedef std::shared_ptr<MD5AnimationCache> MD5AnimationCachePtr;
 
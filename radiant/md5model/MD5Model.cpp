@@ -33,9 +33,15 @@ MD5Model::MD5Model(const MD5Model& other) :
 		_surfaces[i].surface.reset(new MD5Surface(*other._surfaces[i].surface));
 		_surfaces[i].surface->setActiveMaterial(_surfaces[i].surface->getDefaultMaterial());
 
-		// Build the index array - this has to happen at least once
-		_surfaces[i].surface->buildIndexArray();
-		_surfaces[i].surface->updateToDefaultPose(_joints);
+		// Without animation the other surfaces are in the default pose already,
+		// keep their render data and vertex buffers (this is the case for the
+		// models in the ModelCache)
+		if (other._anim || _surfaces[i].surface->getNumVertices() == 0)
+		{
+			// Build the index array - this has to happen at least once
+			_surfaces[i].surface->buildIndexArray();
+			_surfaces[i].surface->updateToDefaultPose(_joints);
+		}
 	}
 
 	updateMaterialList();
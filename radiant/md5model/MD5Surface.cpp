@@ -17,24 +17,21 @@ inline VertexPointer vertexpointer_arbitrarymeshvertex(const ArbitraryMeshVertex
 // Constructor
 MD5Surface::MD5Surface() : 
 	_originalShaderName(""),
-	_mesh(new MD5Mesh),
-	_normalList(0),
-	_lightingList(0)
+	_mesh(new MD5Mesh)
 {}
 
 MD5Surface::MD5Surface(const MD5Surface& other) :
 	_aabb_local(other._aabb_local),
 	_originalShaderName(other._originalShaderName),
 	_mesh(other._mesh),
-	_normalList(0),
-	_lightingList(0)
+	_vertices(other._vertices),
+	_indices(other._indices),
+	_vertexBuffer(other._vertexBuffer)
 {}
 
-// Destructor
+// Destructor, the GL buffers are released along with the last surface using them
 MD5Surface::~MD5Surface()
-{
-    releaseDisplayLists();
-}
+{}
 
 // Update geometry
 void MD5Surface::updateGeometry()
@@ -65,93 +62,42 @@ void MD5Surface::updateGeometry()
 		i->bitangent.normalise();
 	}
 
-	// Build the display lists
-	createDisplayLists();
+	createVertexBuffer();
 }
 
 // Back-end render
 void MD5Surface::render(const RenderInfo& info) const
 {
-	if (info.checkFlag(RENDER_BUMP))
-    {
-		glCallList(_lightingList);
-	}
-	else
-    {
-		glCallList(_normalList);
-	}
+	if (!_vertexBuffer) return;
+
+	_vertexBuffer->render(info, false);
 }
 
-// Construct the display lists
-void MD5Surface::createDisplayLists()
+const OpenGLInstancedGeometry* MD5Surface::getInstancedGeometry() const
 {
-    // Release old display lists first
-    releaseDisplayLists();
-
-	// Create the list for lighting mode
-	_lightingList = glGenLists(1);
-	assert(_lightingList != 0);
-	glNewList(_lightingList, GL_COMPILE);
+	return _vertexBuffer.get();
+}
 
-	glBegin(GL_TRIANGLES);
-	for (Indices::const_iterator i = _indices.begin();
-		 i != _indices.end();
-		 ++i)
+void MD5Surface::createVertexBuffer()
+{
+	if (_vertices.empty() || _indices.empty())
 	{
-		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
-
-		// Submit the vertex attributes and coordinate
-		if (GLEW_ARB_vertex_program) {
-			// Submit the vertex attributes and coordinate
-			glVertexAttrib2dvARB(ATTR_TEXCOORD, v.texcoord);
-			glVertexAttrib3dvARB(ATTR_TANGENT, v.tangent);
-			glVertexAttrib3dvARB(ATTR_BITANGENT, v.bitangent);
-			glVertexAttrib3dvARB(ATTR_NORMAL, v.normal);
-		}
-		glVertex3dv(v.vertex);
+		_vertexBuffer.reset();
+		return;
 	}
-	glEnd();
 
-	glEndList();
+	VertexBuffer buffer;
+	buffer.addVertices(_vertices.begin(), _vertices.end());
+	buffer.addIndexBatch(_indices.begin(), _indices.size());
 
-	// Generate the list for flat-shaded (unlit) mode
-	_normalList = glGenLists(1);
-	assert(_normalList != 0);
-	glNewList(_normalList, GL_COMPILE);
-
-	glBegin(GL_TRIANGLES);
-	for (Indices::const_iterator i = _indices.begin();
-		 i != _indices.end();
-		 ++i)
+	if (!_vertexBuffer || _vertexBuffer.use_count() > 1)
 	{
-		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
-
-		// Submit attributes
-		glNormal3dv(v.normal);
-		glTexCoord2dv(v.texcoord);
-		glVertex3dv(v.vertex);
+		// Don't touch the buffers shared with other surfaces
+		_vertexBuffer = std::make_shared<VertexBuffer>();
 	}
-	glEnd();
 
-	glEndList();
-}
-
-void MD5Surface::releaseDisplayLists()
-{
-    // Release GL display lists if applicable
-    if (_normalList != 0)
-    {
-        glDeleteLists(_normalList, 1);
-        _normalList = 0;
-    }
-
-    if (_lightingList != 0)
-    {
-        glDeleteLists(_lightingList, 1);
-        _lightingList = 0;
-    }
+	// Animated surfaces end up here every frame, re-use the GL buffers
+	_vertexBuffer->replaceData(buffer);
 }
 
 // Selection test
@@ -2,6 +2,7 @@
 
 #include "irender.h"
 #include "render.h"
+#include "render/MeshVertexBuffer.h"
 #include "irenderable.h"
 #include "math/AABB.h"
 #include "math/Frustum.h"
@@ -44,17 +45,15 @@ private:
 	Vertices _vertices;
 	Indices _indices;
 
-	// The GL display lists for this surface's geometry
-	GLuint _normalList;
-	GLuint _lightingList;
+	// The vertex and index buffers holding the render data in single precision.
+	// Copies of this surface share the buffers until their geometry changes.
+	typedef render::MeshVertexBuffer VertexBuffer;
+	std::shared_ptr<VertexBuffer> _vertexBuffer;
 
 private:
 
-	// Create the display lists
-	void createDisplayLists();
-
-    // Frees any display list in use
-    void releaseDisplayLists();
+	// Writes the render data to the vertex buffer, it's uploaded on the next render
+	void createVertexBuffer();
 
 	// Re-calculate the normal vectors
 	void buildVertexNormals();
@@ -67,7 +66,9 @@ public:
 	MD5Surface();
 
 	/**
-	 * Copy constructor, re-uses the MD5Mesh of <other>.
+	 * Copy constructor, re-uses the MD5Mesh of <other>, and its render data
+	 * along with the vertex buffer. Call updateToDefaultPose() if <other>
+	 * might be in a different pose.
 	 */
 	MD5Surface(const MD5Surface& other);
 
@@ -80,7 +81,7 @@ public:
 	void setDefaultMaterial(const std::string& name);
 	
 	/**
-	 * Calculate the AABB and build the display lists for rendering.
+	 * Calculate the AABB and fill the vertex buffer for rendering.
 	 */
 	void updateGeometry();
 
@@ -97,6 +98,9 @@ public:
     // Back-end render function
     void render(const RenderInfo& info) const;
 
+    // The shared vertex buffer, all copies of the mesh are drawn at once
+    const OpenGLInstancedGeometry* getInstancedGeometry() const;
+
 	const AABB& localAABB() const;
 
 	// Test for selection
@@ -14,10 +14,7 @@ namespace model {
 // Constructor. Copy the provided picoSurface_t structure into this object
 RenderablePicoSurface::RenderablePicoSurface(picoSurface_t* surf,
 											 const std::string& fExt)
-: _defaultMaterial(""),
-  _dlRegular(0),
-  _dlProgramVcol(0),
-  _dlProgramNoVCol(0)
+: _defaultMaterial("")
 {
 	// Get the shader from the picomodel struct. If this is a LWO model, use
 	// the material name to select the shader, while for an ASE model the
@@ -90,8 +87,7 @@ RenderablePicoSurface::RenderablePicoSurface(picoSurface_t* surf,
 	// Calculate the tangent and bitangent vectors
 	calculateTangents();
 
-	// Construct the DLs
-	createDisplayLists();
+	createVertexBuffer();
 }
 
 RenderablePicoSurface::RenderablePicoSurface(const RenderablePicoSurface& other) :
@@ -100,12 +96,8 @@ RenderablePicoSurface::RenderablePicoSurface(const RenderablePicoSurface& other)
 	_indices(other._indices),
 	_nIndices(other._nIndices),
 	_localAABB(other._localAABB),
-	_dlRegular(0),
-	_dlProgramVcol(0),
-	_dlProgramNoVCol(0)
-{
-	createDisplayLists();
-}
+	_vertexBuffer(other._vertexBuffer) // same geometry, share the buffers
+{}
 
 std::string RenderablePicoSurface::cleanupShaderName(const std::string& inName)
 {
@@ -149,13 +141,9 @@ std::string RenderablePicoSurface::cleanupShaderName(const std::string& inName)
 	}
 }
 
-// Destructor. Release the GL display lists.
+// Destructor. The GL buffers are released along with the last surface using them.
 RenderablePicoSurface::~RenderablePicoSurface()
-{
-	glDeleteLists(_dlRegular, 1);
-	glDeleteLists(_dlProgramNoVCol, 1);
-	glDeleteLists(_dlProgramVcol, 1);
-}
+{}
 
 // Convert byte pointers to colour vector
 Vector3 RenderablePicoSurface::getColourVector(unsigned char* array) {
@@ -197,92 +185,38 @@ void RenderablePicoSurface::calculateTangents() {
 // Back-end render function
 void RenderablePicoSurface::render(const RenderInfo& info) const
 {
-	// Invoke appropriate display list
-	if (info.checkFlag(RENDER_PROGRAM))
-    {
-        if (info.checkFlag(RENDER_VERTEX_COLOUR))
-        {
-            glCallList(_dlProgramVcol);
-        }
-        else
-        {
-            glCallList(_dlProgramNoVCol);
-        }
-	}
-	else
-    {
-		glCallList(_dlRegular);
-	}
+	if (!_vertexBuffer) return;
+
+	// Vertex colours are only submitted to the GL programs
+	_vertexBuffer->render(info,
+		info.checkFlag(RENDER_PROGRAM) && info.checkFlag(RENDER_VERTEX_COLOUR));
 }
 
-// Construct a list for GLProgram mode, either with or without vertex colour
-GLuint RenderablePicoSurface::compileProgramList(bool includeColour)
+const OpenGLInstancedGeometry* RenderablePicoSurface::getInstancedGeometry() const
 {
-    GLuint list = glGenLists(1);
-	assert(list != 0); // check if we run out of display lists
-    glNewList(list, GL_COMPILE);
-
-	glBegin(GL_TRIANGLES);
-	for (Indices::const_iterator i = _indices.begin();
-		 i != _indices.end();
-		 ++i)
-	{
-		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
-
-		// Submit the vertex attributes and coordinate
-		if (GLEW_ARB_vertex_program)
-        {
-			glVertexAttrib2dvARB(ATTR_TEXCOORD, v.texcoord);
-			glVertexAttrib3dvARB(ATTR_TANGENT, v.tangent);
-			glVertexAttrib3dvARB(ATTR_BITANGENT, v.bitangent);
-			glVertexAttrib3dvARB(ATTR_NORMAL, v.normal);
-		}
-
-        // Optional vertex colour
-        if (includeColour)
-        {
-            glColor3dv(v.colour);
-        }
-
-        // Submit the vertex itself
-		glVertex3dv(v.vertex);
-	}
-	glEnd();
-
-	glEndList();
-
-    return list;
+	return _vertexBuffer.get();
 }
 
-// Construct the two display lists
-void RenderablePicoSurface::createDisplayLists()
+void RenderablePicoSurface::createVertexBuffer()
 {
-	// Generate the lists for lighting mode
-    _dlProgramNoVCol = compileProgramList(false);
-    _dlProgramVcol = compileProgramList(true);
+	if (_vertices.empty() || _indices.empty())
+	{
+		_vertexBuffer.reset();
+		return;
+	}
 
-	// Generate the list for flat-shaded (unlit) mode
-	_dlRegular = glGenLists(1);
-	assert(_dlRegular != 0); // check if we run out of display lists
-	glNewList(_dlRegular, GL_COMPILE);
+	VertexBuffer buffer;
+	buffer.addVertices(_vertices.begin(), _vertices.end());
+	buffer.addIndexBatch(_indices.begin(), _indices.size());
 
-	glBegin(GL_TRIANGLES);
-	for (Indices::const_iterator i = _indices.begin();
-		 i != _indices.end();
-		 ++i)
+	if (!_vertexBuffer || _vertexBuffer.use_count() > 1)
 	{
-		// Get the vertex for this index
-		ArbitraryMeshVertex& v = _vertices[*i];
-
-		// Submit attributes
-		glNormal3dv(v.normal);
-		glTexCoord2dv(v.texcoord);
-		glVertex3dv(v.vertex);
+		// Don't touch the buffers shared with other surfaces
+		_vertexBuffer = std::make_shared<VertexBuffer>();
 	}
-	glEnd();
 
-	glEndList();
+	// Re-uses the GL buffers if the size allows
+	_vertexBuffer->replaceData(buffer);
 }
 
 // Perform selection test for this surface
@@ -440,11 +374,8 @@ void RenderablePicoSurface::applyScale(const Vector3& scale, const RenderablePic
 
 	calculateTangents();
 
-	glDeleteLists(_dlRegular, 1);
-	glDeleteLists(_dlProgramNoVCol, 1);
-	glDeleteLists(_dlProgramVcol, 1);
-
-	createDisplayLists();
+	// The geometry is no longer the one of the original surface
+	createVertexBuffer();
 }
 
 } // namespace model
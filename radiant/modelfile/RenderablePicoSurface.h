@@ -3,6 +3,7 @@
 #include "GLProgramAttributes.h"
 #include "picomodel/picomodel.h"
 #include "render.h"
+#include "render/MeshVertexBuffer.h"
 #include "math/AABB.h"
 
 #include "ishaders.h"
@@ -51,10 +52,11 @@ class RenderablePicoSurface :
 	// The AABB containing this surface, in local object space.
 	AABB _localAABB;
 
-	// The GL display lists for this surface's geometry
-	GLuint _dlRegular;
-	GLuint _dlProgramVcol;
-    GLuint _dlProgramNoVCol;
+	// The vertex and index buffers holding this surface's geometry in single
+	// precision. Copies of this surface share the buffers until they change
+	// their geometry, so all instances of a model use the same GL objects.
+	typedef render::MeshVertexBuffer VertexBuffer;
+	std::shared_ptr<VertexBuffer> _vertexBuffer;
 
 private:
 
@@ -64,9 +66,9 @@ private:
 	// Calculate tangent and bitangent vectors for all vertices.
 	void calculateTangents();
 
-	// Create the display lists
-    GLuint compileProgramList(bool includeColour);
-	void createDisplayLists();
+	// Writes the current geometry to the vertex buffer, the upload
+	// happens when it's rendered the next time
+	void createVertexBuffer();
 
 	std::string cleanupShaderName(const std::string& mapName);
 
@@ -92,6 +94,11 @@ public:
 	 */
 	void render(const RenderInfo& info) const;
 
+	/**
+	 * The shared vertex buffer, all copies of the model are drawn at once
+	 */
+	const OpenGLInstancedGeometry* getInstancedGeometry() const;
+
 	/** Get the containing AABB for this surface.
 	 */
 	const AABB& getAABB() const {
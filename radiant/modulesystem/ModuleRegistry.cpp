@@ -2,9 +2,17 @@
 
 #include "i18n.h"
 #include "itextstream.h"
+#include "iprofiler.h"
+#include "ithread.h"
 #include <stdexcept>
 #include <iostream>
+#include <deque>
+#include <vector>
+#include <future>
+#include <condition_variable>
+#include <chrono>
 #include "ApplicationContextImpl.h"
+#include "debugging/ScopedDebugTimer.h"
 
 #include <wx/app.h>
 #include <fmt/format.h>
@@ -93,47 +101,229 @@ void ModuleRegistry::registerModule(const RegisterableModulePtr& module)
 	rMessage() << "Module registered: " << module->getName() << std::endl;
 }
 
-// Initialise the module (including dependencies, if necessary)
-void ModuleRegistry::initialiseModuleRecursive(const std::string& name)
+std::size_t ModuleRegistry::initialiseModule(const std::string& name, const RegisterableModulePtr& module)
 {
-	// Check if the module exists at all
-	if (_uninitialisedModules.find(name) == _uninitialisedModules.end())
-    {
-		throw std::logic_error("ModuleRegistry: Module doesn't exist: " + name);
+	// Tag this module as "ready" by inserting it into the initialised list.
+	{
+		std::lock_guard<std::mutex> lock(_initialisedModulesLock);
+		_initialisedModules.insert(ModulesMap::value_type(name, module));
 	}
 
-	// Check if the module is already initialised
-	if (_initialisedModules.find(name) != _initialisedModules.end())
-    {
-		return;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	{
+		profile::ScopedSpan span(name, "module");
+
+		// Initialise the module itself, now that the dependencies are ready
+		module->initialiseModule(*_context);
 	}
 
-	// Tag this module as "ready" by inserting it into the initialised list.
-	_initialisedModules.insert(ModulesMap::value_type(name, _uninitialisedModules[name]));
+	return static_cast<std::size_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - start).count());
+}
 
-	// Create a shortcut to the module
-	RegisterableModulePtr module = _uninitialisedModules[name];
-	const StringSet& dependencies = module->getDependencies();
+void ModuleRegistry::initialiseModules()
+{
+    wxASSERT(_context);
 
-    // Debug builds should ensure that the dependencies don't reference the
-    // module itself directly
-    assert(dependencies.find(name) == dependencies.end());
+	// Build the dependency graph: the number of dependencies each module
+	// is still waiting for and the modules depending on each module
+	std::map<std::string, std::size_t> pendingDependencies;
+	std::map<std::string, std::vector<std::string>> dependents;
 
-	// Initialise the dependencies first
-	for (const std::string& namedDependency : dependencies)
+	for (const ModulesMap::value_type& pair : _uninitialisedModules)
 	{
-        initialiseModuleRecursive(namedDependency);
+		const StringSet& dependencies = pair.second->getDependencies();
+
+		// Debug builds should ensure that the dependencies don't reference the
+		// module itself directly
+		assert(dependencies.find(pair.first) == dependencies.end());
+
+		for (const std::string& namedDependency : dependencies)
+		{
+			// Check if the module exists at all
+			if (_uninitialisedModules.find(namedDependency) == _uninitialisedModules.end())
+			{
+				throw std::logic_error("ModuleRegistry: Module doesn't exist: " + namedDependency);
+			}
+
+			dependents[namedDependency].push_back(pair.first);
+		}
+
+		pendingDependencies[pair.first] = dependencies.size();
 	}
 
-	_progress = 0.1f + (static_cast<float>(_initialisedModules.size())/_uninitialisedModules.size())*0.9f;
+	// A module initialised by a worker thread, handed back to the main thread
+	struct FinishedModule
+	{
+		std::string name;
+		std::size_t milliseconds;
+		std::exception_ptr exception;
+	};
 
-	_sigModuleInitialisationProgress.emit(
-		fmt::format(_("Initialising Module: {0}"), name),
-		_progress);
+	std::mutex finishedLock;
+	std::condition_variable moduleFinished;
+	std::deque<FinishedModule> finishedModules;
 
-	// Initialise the module itself, now that the dependencies are ready
-    wxASSERT(_context);
-	module->initialiseModule(*_context);
+	std::deque<std::string> readyModules;
+	std::vector<std::future<void>> workers;
+
+	// The thread-safe modules are handed to the pool once it is running,
+	// until then they are initialised on the main thread
+	ThreadManager* threadManager = nullptr;
+	std::size_t numRunning = 0;
+	std::size_t numInitialised = 0;
+
+	for (const std::map<std::string, std::size_t>::value_type& pair : pendingDependencies)
+	{
+		if (pair.second == 0)
+		{
+			// The profiler goes first, to record the initialisation of all the others
+			if (pair.first == MODULE_PROFILER)
+			{
+				readyModules.push_front(pair.first);
+			}
+			else
+			{
+				readyModules.push_back(pair.first);
+			}
+		}
+	}
+
+	auto onModuleInitialised = [&](const std::string& name, std::size_t milliseconds)
+	{
+		pendingDependencies.erase(name);
+		++numInitialised;
+
+		rMessage() << "ModuleRegistry: " << name << " initialised in " << milliseconds << " ms" << std::endl;
+
+		if (name == MODULE_THREADMANAGER)
+		{
+			threadManager = static_cast<ThreadManager*>(_uninitialisedModules[name].get());
+		}
+
+		_progress = 0.1f + (static_cast<float>(numInitialised)/_uninitialisedModules.size())*0.9f;
+
+		_sigModuleInitialisationProgress.emit(
+			fmt::format(_("Initialised Module: {0} ({1} ms)"), name, milliseconds),
+			_progress);
+
+		// The dependents waiting for this module might be ready now
+		for (const std::string& dependent : dependents[name])
+		{
+			std::map<std::string, std::size_t>::iterator found = pendingDependencies.find(dependent);
+
+			if (found != pendingDependencies.end() && --found->second == 0)
+			{
+				readyModules.push_back(dependent);
+			}
+		}
+	};
+
+	while (!pendingDependencies.empty())
+	{
+		// Pick up the modules done by the worker threads
+		std::deque<FinishedModule> finished;
+		{
+			std::lock_guard<std::mutex> lock(finishedLock);
+			finished.swap(finishedModules);
+		}
+
+		for (const FinishedModule& module : finished)
+		{
+			--numRunning;
+
+			if (module.exception)
+			{
+				// Let the other workers finish before passing the error on
+				for (std::future<void>& worker : workers)
+				{
+					worker.wait();
+				}
+
+				std::rethrow_exception(module.exception);
+			}
+
+			onModuleInitialised(module.name, module.milliseconds);
+		}
+
+		// Hand all ready thread-safe modules to the pool, keep the first other one
+		std::string mainThreadModule;
+
+		while (!readyModules.empty())
+		{
+			std::string name = readyModules.front();
+			readyModules.pop_front();
+
+			RegisterableModulePtr module = _uninitialisedModules[name];
+
+			_sigModuleInitialisationProgress.emit(
+				fmt::format(_("Initialising Module: {0}"), name),
+				_progress);
+
+			if (!module->isInitialisationThreadSafe() || threadManager == nullptr)
+			{
+				mainThreadModule = name;
+				break;
+			}
+
+			++numRunning;
+
+			workers.emplace_back(threadManager->submit([&, name, module]()
+			{
+				FinishedModule result;
+				result.name = name;
+				result.milliseconds = 0;
+
+				try
+				{
+					result.milliseconds = initialiseModule(name, module);
+				}
+				catch (...)
+				{
+					result.exception = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> lock(finishedLock);
+				finishedModules.emplace_back(std::move(result));
+				moduleFinished.notify_one();
+			}, ThreadManager::Priority::High));
+		}
+
+		if (!mainThreadModule.empty())
+		{
+			// The module is initialised right here, the workers go on meanwhile
+			onModuleInitialised(mainThreadModule,
+				initialiseModule(mainThreadModule, _uninitialisedModules[mainThreadModule]));
+			continue;
+		}
+
+		if (numRunning == 0)
+		{
+			if (pendingDependencies.empty()) break;
+
+			// Nothing is ready and nothing is running, the remaining modules depend
+			// on each other. Initialise the first one anyway, as the recursive
+			// depth-first initialisation used to do.
+			std::string name = pendingDependencies.begin()->first;
+
+			rWarning() << "ModuleRegistry: " << name << " is part of a dependency cycle" << std::endl;
+
+			pendingDependencies[name] = 0;
+			readyModules.push_back(name);
+			continue;
+		}
+
+		// Wait for a worker to finish
+		std::unique_lock<std::mutex> lock(finishedLock);
+		moduleFinished.wait(lock, [&]() { return !finishedModules.empty(); });
+	}
+
+	// The tasks might not have returned yet, they refer to the locals above
+	for (std::future<void>& worker : workers)
+	{
+		worker.wait();
+	}
 }
 
 // Initialise all registered modules
@@ -154,12 +344,17 @@ void ModuleRegistry::loadAndInitialiseModules()
 	_progress = 0.1f;
 	_sigModuleInitialisationProgress.emit(_("Initialising Modules"), _progress);
 
-	for (ModulesMap::iterator i = _uninitialisedModules.begin();
-		 i != _uninitialisedModules.end(); ++i)
+	ScopedDebugTimer timer("Modules initialised: ");
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Walk the dependency graph, initialising each module after its dependencies
+	initialiseModules();
+
+	profile::IProfiler* profiler = profile::findProfiler();
+
+	if (profiler)
 	{
-		// greebo: Dive into the recursion
-		// (this will return immediately if the module is already initialised).
-		initialiseModuleRecursive(i->first);
+		profiler->recordSpan("Module initialisation", "startup", start, std::chrono::steady_clock::now());
 	}
 
 	// Make sure this isn't called again
@@ -196,6 +391,7 @@ void ModuleRegistry::shutdownModules()
 bool ModuleRegistry::moduleExists(const std::string& name) const
 {
 	// Try to find the initialised module, uninitialised don't count as existing
+    std::lock_guard<std::mutex> lock(_initialisedModulesLock);
     return _initialisedModules.find(name) != _initialisedModules.end();
 }
 
@@ -206,11 +402,15 @@ RegisterableModulePtr ModuleRegistry::getModule(const std::string& name) const {
 	RegisterableModulePtr returnValue;
 
 	// Try to find the module
-	ModulesMap::const_iterator found = _initialisedModules.find(name);
+	{
+		std::lock_guard<std::mutex> lock(_initialisedModulesLock);
 
-	if (found != _initialisedModules.end())
-    {
-		returnValue = found->second;
+		ModulesMap::const_iterator found = _initialisedModules.find(name);
+
+		if (found != _initialisedModules.end())
+		{
+			returnValue = found->second;
+		}
 	}
 
 	if (!returnValue)
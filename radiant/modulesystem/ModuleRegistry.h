@@ -2,6 +2,7 @@
 
 #include <map>
 #include <list>
+#include <mutex>
 #include "imodule.h"
 
 #include "ModuleLoader.h"
@@ -24,6 +25,9 @@ private:
 	// After initialisiation, modules get enlisted here.
 	ModulesMap _initialisedModules;
 
+	// Guards _initialisedModules while modules are initialised on multiple threads
+	mutable std::mutex _initialisedModulesLock;
+
 	// Set to TRUE as soon as initialiseModules() is finished
 	bool _modulesInitialised;
 
@@ -94,8 +98,12 @@ private:
 	// is destructed - the shared_ptrs don't work anymore and are causing double-deletes.
 	void unloadModules();
 
-	// Initialises the module (including dependencies, recursively).
-	void initialiseModuleRecursive(const std::string& name);
+	// Initialises all modules along their dependency graph, the ones declaring
+	// themselves thread-safe are initialised concurrently by the thread pool.
+	void initialiseModules();
+
+	// Enlists the module as initialised and initialises it, returns the time it took (ms)
+	std::size_t initialiseModule(const std::string& name, const RegisterableModulePtr& module);
 
 }; // class Registry
 
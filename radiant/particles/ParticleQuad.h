@@ -8,15 +8,19 @@ namespace particles
  * Each particle stage consists of a bunch of quads.
  * A quad in turn consists of 4 vertices, each of them carrying
  * 3D coordinates, a normal vector, texture coords and a vertex colour.
+ *
+ * The vertices are stored in single precision, this is the format they are
+ * submitted to OpenGL in. The calculations are still done in double precision,
+ * the results are converted when they are assigned to the vertices.
  */
 struct ParticleQuad
 {
 	struct Vertex
 	{
-		Vector3 vertex;			// The 3D coordinates of the point
-		Vector2 texcoord;		// The UV coordinates
-		Vector3 normal;			// The normals
-		Vector4 colour;		// vertex colour
+		Vector3f vertex;		// The 3D coordinates of the point
+		Vector2f texcoord;		// The UV coordinates
+		Vector3f normal;		// The normals
+		Vector4f colour;		// vertex colour
 
 		Vertex()
 		{}
@@ -95,10 +99,12 @@ struct ParticleQuad
 
 	void assignColour(const Vector4& colour)
 	{
-		verts[0].colour = colour;
-		verts[1].colour = colour;
-		verts[2].colour = colour;
-		verts[3].colour = colour;
+		Vector4f colourf(colour);
+
+		verts[0].colour = colourf;
+		verts[1].colour = colourf;
+		verts[2].colour = colourf;
+		verts[3].colour = colourf;
 	}
 
 	// Sets the horizontal texture coordinates, the quad will use the interval [s0..s0+sWidth]
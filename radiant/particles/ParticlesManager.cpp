@@ -40,7 +40,7 @@ namespace
 }
 
 ParticlesManager::ParticlesManager() :
-    _defLoader(std::bind(&ParticlesManager::reloadParticleDefs, this))
+    _defLoader(std::bind(&ParticlesManager::reloadParticleDefs, this), "Particle definitions")
 {}
 
 sigc::signal<void> ParticlesManager::signal_particlesReloaded() const
@@ -154,7 +154,8 @@ void ParticlesManager::ensureDefsLoaded()
 void ParticlesManager::parseStream(std::istream& contents, const std::string& filename)
 {
 	// Usual ritual, get a parser::DefTokeniser and start tokenising the DEFs
-	parser::BasicDefTokeniser<std::istream> tok(contents);
+	std::string buffer((std::istreambuf_iterator<char>(contents)), std::istreambuf_iterator<char>());
+	parser::BasicDefTokeniser<std::string_view> tok(buffer);
 
 	while (tok.hasMoreTokens())
 	{
@@ -220,6 +221,7 @@ const StringSet& ParticlesManager::getDependencies() const
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
 		_dependencies.insert(MODULE_EVENTMANAGER);
+		_dependencies.insert(MODULE_THREADMANAGER);
 	}
 
 	return _dependencies;
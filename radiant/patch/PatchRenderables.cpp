@@ -15,9 +15,13 @@ void RenderablePatchWireframe::render(const RenderInfo& info) const
     {
         _needsUpdate = false;
 
-        // Create a VBO and add the vertex data
+        // Create a VBO and add the vertex positions
         VertexBuffer_T currentVBuf;
-        currentVBuf.addVertices(_tess.vertices.begin(), _tess.vertices.end());
+
+        for (const ArbitraryMeshVertex& v : _tess.vertices)
+        {
+            currentVBuf.addVertex(Vector3f(v.vertex));
+        }
 
         // Submit index batches
         const RenderIndex* strip_indices = &_tess.indices.front();
@@ -10,6 +10,7 @@
 
 #include "render/VertexBuffer.h"
 #include "render/IndexedVertexBuffer.h"
+#include "render/MeshVertexf.h"
 
 /// Helper class to render a PatchTesselation in wireframe mode
 class RenderablePatchWireframe :
@@ -19,8 +20,8 @@ protected:
 	// Geometry source
 	const PatchTesselation& _tess;
 
-	// VertexBuffer for rendering
-	typedef render::IndexedVertexBuffer<Vertex3f> VertexBuffer_T;
+	// VertexBuffer for rendering, holding single-precision copies of the tesselation
+	typedef render::IndexedVertexBuffer<Vector3f> VertexBuffer_T;
 	mutable VertexBuffer_T _vertexBuf;
 
 	mutable bool _needsUpdate;
@@ -55,8 +56,8 @@ class RenderablePatchSolid :
     // Geometry source
 	PatchTesselation& _tess;
 
-    // VertexBuffer for rendering
-    typedef render::IndexedVertexBuffer<ArbitraryMeshVertex> VertexBuffer_T;
+    // VertexBuffer for rendering, holding single-precision copies of the tesselation
+    typedef render::IndexedVertexBuffer<MeshVertexf> VertexBuffer_T;
     mutable VertexBuffer_T _vertexBuf;
 
     mutable bool _needsUpdate;
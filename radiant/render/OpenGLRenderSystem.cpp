@@ -3,9 +3,13 @@
 #include "ishaders.h"
 #include "igl.h"
 #include "itextstream.h"
+#include "iregistry.h"
+#include "registry/registry.h"
 #include "math/Matrix4.h"
 #include "modulesystem/StaticModule.h"
 #include "backend/GLProgramFactory.h"
+#include "backend/OpenGLRenderStream.h"
+#include "backend/OpenGLInstancedRenderer.h"
 #include "debugging/debugging.h"
 
 #include <functional>
@@ -13,6 +17,8 @@
 namespace render {
 
 namespace {
+	const char* const RKEY_BATCHED_SUBMISSION = "user/ui/renderSystem/batchedSubmission";
+
 	// Polygon stipple pattern
 	const GLubyte POLYGON_STIPPLE_PATTERN[132] = {
 	      0xAA, 0xAA, 0xAA, 0xAA, 0x55, 0x55, 0x55, 0x55,
@@ -512,6 +518,22 @@ void OpenGLRenderSystem::forEachRenderable(const RenderableCallback& callback) c
 	m_traverseRenderablesMutex = false;
 }
 
+void OpenGLRenderSystem::toggleBatchedSubmission(const cmd::ArgumentList& args)
+{
+	registry::setValue(RKEY_BATCHED_SUBMISSION, !registry::getValue<bool>(RKEY_BATCHED_SUBMISSION));
+
+	rMessage() << "Batched draw submission is now " <<
+		(OpenGLRenderStream::Instance().isEnabled() ? "enabled" : "disabled") << std::endl;
+}
+
+void OpenGLRenderSystem::batchedSubmissionKeyChanged()
+{
+	bool batched = registry::getValue<bool>(RKEY_BATCHED_SUBMISSION);
+
+	OpenGLRenderStream::Instance().setEnabled(batched);
+	OpenGLInstancedRenderer::Instance().setEnabled(batched);
+}
+
 // RegisterableModule implementation
 const std::string& OpenGLRenderSystem::getName() const
 {
@@ -527,6 +549,8 @@ const StringSet& OpenGLRenderSystem::getDependencies() const
 	{
 		_dependencies.insert(MODULE_SHADERSYSTEM);
 		_dependencies.insert(MODULE_OPENGL);
+		_dependencies.insert(MODULE_XMLREGISTRY);
+		_dependencies.insert(MODULE_COMMANDSYSTEM);
 	}
 
 	return _dependencies;
@@ -546,6 +570,15 @@ void OpenGLRenderSystem::initialiseModule(const ApplicationContext& ctx)
 		realise();
 	}
 
+	batchedSubmissionKeyChanged();
+
+	GlobalRegistry().signalForKey(RKEY_BATCHED_SUBMISSION).connect(
+		sigc::mem_fun(this, &OpenGLRenderSystem::batchedSubmissionKeyChanged)
+	);
+
+	GlobalCommandSystem().addCommand("ToggleBatchedRendering",
+		std::bind(&OpenGLRenderSystem::toggleBatchedSubmission, this, std::placeholders::_1));
+
 	// greebo: Don't realise the module yet, this must wait
 	// until the shared GL context has been created (this
 	// happens as soon as the first GL widget has been realised).
@@ -4,6 +4,7 @@
 #include <sigc++/connection.h>
 #include <map>
 #include "imodule.h"
+#include "icommandsystem.h"
 #include "backend/OpenGLStateManager.h"
 #include "backend/OpenGLShader.h"
 #include "LinearLightList.h"
@@ -57,6 +58,11 @@ private:
 private:
 	void propagateLightChangedFlagToAllLights();
 
+	// Switches the batched draw submission (streamed geometry, instanced
+	// models) of the shader passes on and off
+	void toggleBatchedSubmission(const cmd::ArgumentList& args);
+	void batchedSubmissionKeyChanged();
+
 public:
 
 	/**
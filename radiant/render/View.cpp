@@ -7,11 +7,13 @@
 #if defined(DEBUG_CULLING)
 
 #include <fmt/format.h>
+#include <atomic>
 
-int g_count_planes;
-int g_count_oriented_planes;
-int g_count_bboxs;
-int g_count_oriented_bboxs;
+// The scenegraph might cull the scene on multiple threads
+std::atomic<int> g_count_planes;
+std::atomic<int> g_count_oriented_planes;
+std::atomic<int> g_count_bboxs;
+std::atomic<int> g_count_oriented_bboxs;
 
 #endif
 
@@ -175,8 +177,8 @@ const std::string& View::getCullStats()
 
 #if defined(DEBUG_CULLING)
 	stats = fmt::format("planes {0:d} + {1:d} | bboxs {2:d} + {3:d}",
-		g_count_planes, g_count_oriented_planes, 
-		g_count_bboxs, g_count_oriented_bboxs);
+		g_count_planes.load(), g_count_oriented_planes.load(), 
+		g_count_bboxs.load(), g_count_oriented_bboxs.load());
 #endif
 
 	return stats;
@@ -9,6 +9,7 @@
 #include "itextstream.h"
 #include "iregistry.h"
 #include "imodule.h"
+#include "GLProgramAttributes.h"
 #include "os/file.h"
 #include "string/convert.h"
 #include "debugging/debugging.h"
@@ -239,6 +240,35 @@ GLuint GLProgramFactory::createGLSLProgram(const std::string& vFile,
     return program;
 }
 
+GLuint GLProgramFactory::createGLSLProgram(const std::string& vFile)
+{
+    GLuint program = glCreateProgram();
+    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+
+    CharBufPtr vertexSrc = getFileAsBuffer(vFile, true);
+    const char* csVertex = &vertexSrc->front();
+
+    glShaderSource(vertexShader, 1, &csVertex, NULL);
+    debug::assertNoGlErrors();
+
+    glCompileShader(vertexShader);
+    assertShaderCompiled(vertexShader);
+
+    // Without a fragment shader, the fixed-function pipeline is used for
+    // the fragment processing
+    glAttachShader(program, vertexShader);
+    debug::assertNoGlErrors();
+
+    // Bind the attribute explicitly, the locations assigned by the linker
+    // might alias the built-in vertex attributes
+    glBindAttribLocation(program, ATTR_INSTANCE_TRANSFORM, "attr_InstanceTransform");
+
+    glLinkProgram(program);
+    assertProgramLinked(program);
+
+    return program;
+}
+
 GLuint GLProgramFactory::createARBProgram(const std::string& filename,
                                           GLenum type)
 {
@@ -102,6 +102,14 @@ public:
      */
     static GLuint createGLSLProgram(const std::string& vFile, const std::string& fFile);
 
+    /**
+     * \brief
+     * Create a GLSL program consisting of a vertex shader only, the fragments
+     * are processed by the fixed-function pipeline. The instance transform
+     * attribute is bound to ATTR_INSTANCE_TRANSFORM, and the program is linked.
+     */
+    static GLuint createGLSLProgram(const std::string& vFile);
+
 	/**
      * Create a GL Program from the contents of a file.
      *
@@ -0,0 +1,154 @@
+#include "OpenGLInstancedRenderer.h"
+
+#include "GLProgramFactory.h"
+#include "GLProgramAttributes.h"
+#include "itextstream.h"
+#include "math/Matrix4.h"
+
+#include <stdexcept>
+
+namespace render
+{
+
+namespace
+{
+	const char* const INSTANCE_VP_FILENAME = "instance_vp.glsl";
+
+	const std::size_t FLOATS_PER_TRANSFORM = 16;
+
+	inline const GLvoid* attributeOffset(std::size_t offset)
+	{
+		return reinterpret_cast<const GLvoid*>(offset);
+	}
+}
+
+OpenGLInstancedRenderer::OpenGLInstancedRenderer() :
+	_enabled(true),
+	_initialised(false),
+	_program(0),
+	_lightingUniform(-1),
+	_buffer(0)
+{}
+
+void OpenGLInstancedRenderer::setEnabled(bool enabled)
+{
+	_enabled = enabled;
+}
+
+bool OpenGLInstancedRenderer::isEnabled()
+{
+	if (!_enabled) return false;
+
+	if (!_initialised)
+	{
+		initialise();
+	}
+
+	return _program != 0;
+}
+
+void OpenGLInstancedRenderer::initialise()
+{
+	_initialised = true;
+
+	if (!GLEW_VERSION_2_0 || !GLEW_ARB_draw_instanced || !GLEW_ARB_instanced_arrays)
+	{
+		rConsole() << "[renderer] Instanced drawing is not available." << std::endl;
+		return;
+	}
+
+	try
+	{
+		_program = GLProgramFactory::createGLSLProgram(INSTANCE_VP_FILENAME);
+	}
+	catch (std::runtime_error& ex)
+	{
+		rError() << "[renderer] Failed to create the instancing program: "
+			<< ex.what() << std::endl;
+		_program = 0;
+		return;
+	}
+
+	_lightingUniform = glGetUniformLocation(_program, "u_lighting");
+
+	glGenBuffers(1, &_buffer);
+
+	debug::assertNoGlErrors();
+}
+
+void OpenGLInstancedRenderer::render(const RenderInfo& info,
+	const OpenGLInstancedGeometry& geometry, const std::vector<const Matrix4*>& transforms)
+{
+	if (transforms.empty()) return;
+
+	// Convert the transforms, the attributes are submitted as GL_FLOAT
+	_transforms.resize(transforms.size() * FLOATS_PER_TRANSFORM);
+
+	float* transform = &_transforms.front();
+
+	for (const Matrix4* matrix : transforms)
+	{
+		const double* elements = *matrix;
+
+		for (std::size_t i = 0; i < FLOATS_PER_TRANSFORM; ++i)
+		{
+			*transform++ = static_cast<float>(elements[i]);
+		}
+	}
+
+	// Orphan the previous contents, the draws using them might still be pending
+	glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+	glBufferData(GL_ARRAY_BUFFER, _transforms.size() * sizeof(float),
+		&_transforms.front(), GL_STREAM_DRAW);
+
+	// A mat4 attribute takes four locations, one per column
+	const GLsizei stride = FLOATS_PER_TRANSFORM * sizeof(float);
+
+	for (GLuint column = 0; column < 4; ++column)
+	{
+		GLuint location = ATTR_INSTANCE_TRANSFORM + column;
+
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride,
+			attributeOffset(column * 4 * sizeof(float)));
+		glVertexAttribDivisorARB(location, 1);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Determine the face direction, like for the renderables drawn one by one
+	if (info.checkFlag(RENDER_CULLFACE) &&
+		transforms.front()->getHandedness() == Matrix4::RIGHTHANDED)
+	{
+		glFrontFace(GL_CW);
+	}
+	else
+	{
+		glFrontFace(GL_CCW);
+	}
+
+	glUseProgram(_program);
+	glUniform1i(_lightingUniform, info.checkFlag(RENDER_LIGHTING) ? 1 : 0);
+
+	geometry.renderInstances(info, transforms.size());
+
+	glUseProgram(0);
+
+	for (GLuint column = 0; column < 4; ++column)
+	{
+		GLuint location = ATTR_INSTANCE_TRANSFORM + column;
+
+		glVertexAttribDivisorARB(location, 0);
+		glDisableVertexAttribArray(location);
+	}
+
+	debug::assertNoGlErrors();
+}
+
+OpenGLInstancedRenderer& OpenGLInstancedRenderer::Instance()
+{
+	static OpenGLInstancedRenderer _instance;
+	return _instance;
+}
+
+}
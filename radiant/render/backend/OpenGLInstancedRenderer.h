@@ -0,0 +1,65 @@
+#pragma once
+
+#include "irender.h"
+#include "igl.h"
+#include "util/Noncopyable.h"
+
+#include <vector>
+
+class Matrix4;
+
+namespace render
+{
+
+/**
+ * Draws the OpenGLInstancedGeometry shared by many renderables of a
+ * shader pass (usually the surfaces of the copies of a model) with a single
+ * instanced call per geometry.
+ *
+ * The transforms of the instances are uploaded to a buffer object and passed
+ * to a vertex program as per-instance attribute, bound to the locations
+ * starting at ATTR_INSTANCE_TRANSFORM. The program doesn't have a fragment
+ * stage, texturing is done by the fixed-function pipeline, so it can only be
+ * used by passes not using GL programs themselves.
+ *
+ * Requires ARB_draw_instanced and ARB_instanced_arrays, the renderer is shared
+ * by all render systems and follows the ToggleBatchedRendering command.
+ */
+class OpenGLInstancedRenderer :
+	public util::Noncopyable
+{
+private:
+	bool _enabled;
+
+	// The program is created on first use, which needs a valid GL context
+	bool _initialised;
+
+	GLuint _program;
+
+	GLint _lightingUniform;
+
+	GLuint _buffer;
+
+	// The transforms of the current draw, in single precision
+	std::vector<float> _transforms;
+
+public:
+	OpenGLInstancedRenderer();
+
+	// True if instanced drawing is enabled and supported by the GL
+	bool isEnabled();
+
+	void setEnabled(bool enabled);
+
+	// Draws the geometry once for each of the given object transforms, all of
+	// which must have the same handedness. Sets up the face direction if culling.
+	void render(const RenderInfo& info, const OpenGLInstancedGeometry& geometry,
+		const std::vector<const Matrix4*>& transforms);
+
+	static OpenGLInstancedRenderer& Instance();
+
+private:
+	void initialise();
+};
+
+}
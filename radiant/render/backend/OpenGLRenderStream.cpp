@@ -0,0 +1,263 @@
+#include "OpenGLRenderStream.h"
+
+#include "GLProgramAttributes.h"
+
+#include <cstddef>
+
+namespace render
+{
+
+namespace
+{
+	// The initial size of the ring buffer, in bytes
+	const std::size_t MIN_BUFFER_SIZE = 4 << 20;
+
+	inline const GLvoid* attributeOffset(std::size_t offset)
+	{
+		return reinterpret_cast<const GLvoid*>(offset);
+	}
+
+	// True for the modes which can be drawn as one range, no matter how many primitives
+	inline bool isIndependentMode(GLenum mode)
+	{
+		return mode == GL_POINTS || mode == GL_LINES || mode == GL_TRIANGLES || mode == GL_QUADS;
+	}
+}
+
+OpenGLRenderStream::OpenGLRenderStream() :
+	_enabled(true),
+	_numRuns(0),
+	_buffer(0),
+	_bufferSize(0),
+	_writePosition(0),
+	_texcoordsEnabled(false)
+{}
+
+void OpenGLRenderStream::setEnabled(bool enabled)
+{
+	_enabled = enabled;
+}
+
+RenderStream::Vertex* OpenGLRenderStream::addPrimitive(unsigned int mode, std::size_t numVertices, bool useColours)
+{
+	GLint first = static_cast<GLint>(_vertices.size());
+	_vertices.resize(_vertices.size() + numVertices);
+
+	addToRun(mode, false, useColours, first, numVertices);
+
+	return &_vertices[first];
+}
+
+RenderStream::FullVertex* OpenGLRenderStream::addFullPrimitive(unsigned int mode, std::size_t numVertices, bool useColours)
+{
+	GLint first = static_cast<GLint>(_fullVertices.size());
+	_fullVertices.resize(_fullVertices.size() + numVertices);
+
+	addToRun(mode, true, useColours, first, numVertices);
+
+	return &_fullVertices[first];
+}
+
+void OpenGLRenderStream::addToRun(GLenum mode, bool fullVertices, bool useColours,
+	GLint first, std::size_t numVertices)
+{
+	Run* run = _numRuns > 0 ? &_runs[_numRuns - 1] : nullptr;
+
+	if (run == nullptr || run->mode != mode || run->fullVertices != fullVertices ||
+		run->useColours != useColours)
+	{
+		if (_numRuns == _runs.size())
+		{
+			_runs.emplace_back();
+		}
+
+		run = &_runs[_numRuns++];
+		run->mode = mode;
+		run->fullVertices = fullVertices;
+		run->useColours = useColours;
+		run->firsts.clear();
+		run->counts.clear();
+	}
+
+	if (isIndependentMode(mode) && !run->counts.empty())
+	{
+		// Just extend the range, the vertices are adjacent to the previous ones
+		run->counts.back() += static_cast<GLsizei>(numVertices);
+	}
+	else
+	{
+		run->firsts.push_back(first);
+		run->counts.push_back(static_cast<GLsizei>(numVertices));
+	}
+}
+
+std::size_t OpenGLRenderStream::allocate(std::size_t size)
+{
+	if (_buffer == 0)
+	{
+		glGenBuffers(1, &_buffer);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, _buffer);
+
+	if (size > _bufferSize)
+	{
+		// Grow the ring buffer to fit everything
+		std::size_t bufferSize = _bufferSize > 0 ? _bufferSize : MIN_BUFFER_SIZE;
+
+		while (bufferSize < size)
+		{
+			bufferSize <<= 1;
+		}
+
+		_bufferSize = bufferSize;
+		_writePosition = _bufferSize; // allocated below
+	}
+
+	if (_writePosition + size > _bufferSize)
+	{
+		// Orphan the storage and start over at the front
+		glBufferData(GL_ARRAY_BUFFER, _bufferSize, nullptr, GL_STREAM_DRAW);
+		_writePosition = 0;
+	}
+
+	std::size_t offset = _writePosition;
+	_writePosition += size;
+
+	return offset;
+}
+
+void OpenGLRenderStream::setVertexPointers(const RenderInfo& info, bool fullVertices, std::size_t offset)
+{
+	if (!fullVertices)
+	{
+		const GLsizei stride = sizeof(Vertex);
+
+		glVertexPointer(3, GL_FLOAT, stride, attributeOffset(offset + offsetof(Vertex, vertex)));
+		glColorPointer(4, GL_UNSIGNED_BYTE, stride, attributeOffset(offset + offsetof(Vertex, colour)));
+
+		if (info.checkFlag(RENDER_TEXTURE_CUBEMAP))
+		{
+			// In cube-map mode, we submit the vertex coordinate as the texture coordinate
+			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+			glTexCoordPointer(3, GL_FLOAT, stride, attributeOffset(offset + offsetof(Vertex, vertex)));
+			_texcoordsEnabled = true;
+		}
+
+		return;
+	}
+
+	const GLsizei stride = sizeof(FullVertex);
+
+	glVertexPointer(3, GL_FLOAT, stride, attributeOffset(offset + offsetof(FullVertex, vertex)));
+	glColorPointer(4, GL_UNSIGNED_BYTE, stride, attributeOffset(offset + offsetof(FullVertex, colour)));
+
+	// Check render flags. Multiple flags may be set, so the order matters.
+	if (info.checkFlag(RENDER_TEXTURE_CUBEMAP))
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(3, GL_FLOAT, stride, attributeOffset(offset + offsetof(FullVertex, vertex)));
+		_texcoordsEnabled = true;
+	}
+	else if (info.checkFlag(RENDER_BUMP))
+	{
+		glVertexAttribPointer(ATTR_NORMAL, 3, GL_FLOAT, 0, stride, attributeOffset(offset + offsetof(FullVertex, normal)));
+		glVertexAttribPointer(ATTR_TEXCOORD, 2, GL_FLOAT, 0, stride, attributeOffset(offset + offsetof(FullVertex, texcoord)));
+		glVertexAttribPointer(ATTR_TANGENT, 3, GL_FLOAT, 0, stride, attributeOffset(offset + offsetof(FullVertex, tangent)));
+		glVertexAttribPointer(ATTR_BITANGENT, 3, GL_FLOAT, 0, stride, attributeOffset(offset + offsetof(FullVertex, bitangent)));
+	}
+	else
+	{
+		if (info.checkFlag(RENDER_LIGHTING))
+		{
+			glNormalPointer(GL_FLOAT, stride, attributeOffset(offset + offsetof(FullVertex, normal)));
+		}
+
+		if (info.checkFlag(RENDER_TEXTURE_2D))
+		{
+			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+			glTexCoordPointer(2, GL_FLOAT, stride, attributeOffset(offset + offsetof(FullVertex, texcoord)));
+			_texcoordsEnabled = true;
+		}
+	}
+}
+
+void OpenGLRenderStream::disableVertexPointers()
+{
+	if (_texcoordsEnabled)
+	{
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		_texcoordsEnabled = false;
+	}
+}
+
+void OpenGLRenderStream::flush(const RenderInfo& info)
+{
+	if (_numRuns == 0) return;
+
+	// Both vertex arrays go to the ring buffer in one piece, so they don't
+	// end up in different storage when it is orphaned
+	std::size_t size = _vertices.size() * sizeof(Vertex);
+	std::size_t fullSize = _fullVertices.size() * sizeof(FullVertex);
+
+	std::size_t offset = allocate(size + fullSize);
+	std::size_t fullOffset = offset + size;
+
+	if (size > 0)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, offset, size, &_vertices.front());
+	}
+
+	if (fullSize > 0)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, fullOffset, fullSize, &_fullVertices.front());
+	}
+
+	for (std::size_t i = 0; i < _numRuns; ++i)
+	{
+		const Run& run = _runs[i];
+
+		// The firsts are relative to the vertex array of the run's format
+		if (i == 0 || run.fullVertices != _runs[i - 1].fullVertices)
+		{
+			disableVertexPointers();
+			setVertexPointers(info, run.fullVertices, run.fullVertices ? fullOffset : offset);
+		}
+
+		if (run.useColours)
+		{
+			glEnableClientState(GL_COLOR_ARRAY);
+		}
+
+		if (run.firsts.size() == 1)
+		{
+			glDrawArrays(run.mode, run.firsts.front(), run.counts.front());
+		}
+		else
+		{
+			glMultiDrawArrays(run.mode, &run.firsts.front(), &run.counts.front(),
+				static_cast<GLsizei>(run.firsts.size()));
+		}
+
+		if (run.useColours)
+		{
+			glDisableClientState(GL_COLOR_ARRAY);
+		}
+	}
+
+	disableVertexPointers();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	_vertices.clear();
+	_fullVertices.clear();
+	_numRuns = 0;
+}
+
+OpenGLRenderStream& OpenGLRenderStream::Instance()
+{
+	static OpenGLRenderStream _instance;
+	return _instance;
+}
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "irender.h"
+#include "igl.h"
+#include "util/Noncopyable.h"
+
+#include <vector>
+
+namespace render
+{
+
+/**
+ * Collects the geometry written by the OpenGLRenderables of a shader
+ * pass and draws it in as few calls as possible. Consecutive primitives of
+ * the same mode are drawn with a single glMultiDrawArrays call, primitives of
+ * the independent modes (GL_LINES, GL_TRIANGLES etc.) are merged to a single
+ * range right away.
+ *
+ * Positions and colours are streamed in the compact vertex format, the full
+ * one is only used by passes needing texture coordinates or normals.
+ *
+ * The vertices of all flushes end up in one ring buffer. When it is full, its
+ * storage is orphaned and writing starts over at the front, so the driver
+ * doesn't have to wait for the draws still using the old contents.
+ *
+ * The stream is shared by all render systems, batching can be switched on
+ * and off at runtime (see the ToggleBatchedRendering command).
+ */
+class OpenGLRenderStream :
+	public RenderStream,
+	public util::Noncopyable
+{
+private:
+	bool _enabled;
+
+	std::vector<Vertex> _vertices;
+	std::vector<FullVertex> _fullVertices;
+
+	// A sequence of primitives of the same mode, vertex format and colour usage.
+	// The firsts are indices into the vertex array of the format.
+	struct Run
+	{
+		GLenum mode;
+		bool fullVertices;
+		bool useColours;
+		std::vector<GLint> firsts;
+		std::vector<GLsizei> counts;
+	};
+	std::vector<Run> _runs;
+
+	// The number of runs in use, the others are kept to save allocations
+	std::size_t _numRuns;
+
+	GLuint _buffer;
+
+	// Size and write position of the ring buffer, in bytes
+	std::size_t _bufferSize;
+	std::size_t _writePosition;
+
+	// Whether the texture coordinate array has been enabled by setVertexPointers()
+	bool _texcoordsEnabled;
+
+public:
+	OpenGLRenderStream();
+
+	bool isEnabled() const
+	{
+		return _enabled;
+	}
+
+	void setEnabled(bool enabled);
+
+	bool empty() const
+	{
+		return _numRuns == 0;
+	}
+
+	// RenderStream implementation
+	Vertex* addPrimitive(unsigned int mode, std::size_t numVertices, bool useColours) override;
+	FullVertex* addFullPrimitive(unsigned int mode, std::size_t numVertices, bool useColours) override;
+
+	// Draws and removes everything written so far, using the given render flags
+	void flush(const RenderInfo& info);
+
+	static OpenGLRenderStream& Instance();
+
+private:
+	// Appends a primitive to the current run or starts a new one
+	void addToRun(GLenum mode, bool fullVertices, bool useColours, GLint first, std::size_t numVertices);
+
+	// Reserves the given number of bytes in the ring buffer, returns their offset
+	std::size_t allocate(std::size_t size);
+
+	// Sets up the arrays of the given vertex format, stored at the given offset
+	void setVertexPointers(const RenderInfo& info, bool fullVertices, std::size_t offset);
+	void disableVertexPointers();
+};
+
+}
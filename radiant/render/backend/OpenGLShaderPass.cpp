@@ -9,6 +9,10 @@
 #include "iglprogram.h"
 
 #include "debugging/render.h"
+#include "OpenGLRenderStream.h"
+#include "OpenGLInstancedRenderer.h"
+
+#include <algorithm>
 
 namespace render
 {
@@ -16,6 +20,9 @@ namespace render
 namespace
 {
 
+// Renderables sharing their geometry with fewer others are drawn one by one
+const std::size_t MIN_INSTANCES = 2;
+
 // Bind the given texture to the texture unit, if it is different from the
 // current state, then set the current state to the new texture.
 inline void setTextureState(GLint& current,
@@ -604,6 +611,12 @@ void OpenGLShaderPass::render(OpenGLState& current,
     // Apply our state to the current state object
     applyState(current, flagsMask, viewer, time, NULL);
 
+    // Draw the copies of the same model first, all of them at once
+    if (canRenderInstanced(current))
+    {
+        renderInstances(current, viewer);
+    }
+
     if (!_renderablesWithoutEntity.empty())
     {
         renderAllContained(_renderablesWithoutEntity, current, viewer, time);
@@ -613,6 +626,11 @@ void OpenGLShaderPass::render(OpenGLState& current,
          i != _renderables.end();
          ++i)
     {
+        if (i->second.empty())
+        {
+            continue; // all drawn instanced
+        }
+
         // Apply our state to the current state object
         applyState(current, flagsMask, viewer, time, i->first);
 
@@ -626,6 +644,97 @@ void OpenGLShaderPass::render(OpenGLState& current,
 
     _renderablesWithoutEntity.clear();
     _renderables.clear();
+    _instances.clear();
+}
+
+bool OpenGLShaderPass::canRenderInstanced(const OpenGLState& current) const
+{
+    // The instancing program takes over the vertex processing, which rules out
+    // the passes using GL programs or texgen. Stage expressions may differ per
+    // entity, and highlighted (selected) renderables are drawn one by one.
+    return current.glProgram == NULL &&
+           !current.testRenderFlag(RENDER_TEXTURE_CUBEMAP) &&
+           current.cubeMapMode == ShaderLayer::CUBE_MAP_NONE &&
+           !_glState.testRenderFlag(RENDER_OVERRIDE) &&
+           !_glState.stage0 && !_glState.stage1 && !_glState.stage2 &&
+           !_glState.stage3 && !_glState.stage4 &&
+           OpenGLInstancedRenderer::Instance().isEnabled();
+}
+
+void OpenGLShaderPass::collectInstances(const Renderables& renderables)
+{
+    for (const TransformedRenderable& r : renderables)
+    {
+        const OpenGLInstancedGeometry* geometry = r.renderable->getInstancedGeometry();
+
+        if (geometry != nullptr)
+        {
+            bool rightHanded = r.transform->getHandedness() == Matrix4::RIGHTHANDED;
+            _instances[InstanceKey(geometry, rightHanded)].push_back(r.transform);
+        }
+    }
+}
+
+bool OpenGLShaderPass::isRenderedInstanced(const TransformedRenderable& r) const
+{
+    const OpenGLInstancedGeometry* geometry = r.renderable->getInstancedGeometry();
+
+    if (geometry == nullptr)
+    {
+        return false;
+    }
+
+    bool rightHanded = r.transform->getHandedness() == Matrix4::RIGHTHANDED;
+    Instances::const_iterator found = _instances.find(InstanceKey(geometry, rightHanded));
+
+    return found != _instances.end() && found->second.size() >= MIN_INSTANCES;
+}
+
+void OpenGLShaderPass::renderInstances(OpenGLState& current, const Vector3& viewer)
+{
+    collectInstances(_renderablesWithoutEntity);
+
+    for (RenderablesByEntity::const_iterator i = _renderables.begin();
+         i != _renderables.end();
+         ++i)
+    {
+        collectInstances(i->second);
+    }
+
+    OpenGLInstancedRenderer& renderer = OpenGLInstancedRenderer::Instance();
+    RenderInfo info(current.getRenderFlags(), viewer, current.cubeMapMode);
+
+    bool renderedInstances = false;
+
+    for (Instances::const_iterator i = _instances.begin(); i != _instances.end(); ++i)
+    {
+        if (i->second.size() >= MIN_INSTANCES)
+        {
+            renderer.render(info, *i->first.first, i->second);
+            renderedInstances = true;
+        }
+    }
+
+    if (!renderedInstances)
+    {
+        return;
+    }
+
+    // Remove what has been drawn from the regular path
+    auto isInstanced = [this](const TransformedRenderable& r)
+    {
+        return isRenderedInstanced(r);
+    };
+
+    _renderablesWithoutEntity.erase(
+        std::remove_if(_renderablesWithoutEntity.begin(), _renderablesWithoutEntity.end(), isInstanced),
+        _renderablesWithoutEntity.end());
+
+    for (RenderablesByEntity::iterator i = _renderables.begin(); i != _renderables.end(); ++i)
+    {
+        i->second.erase(std::remove_if(i->second.begin(), i->second.end(), isInstanced),
+                        i->second.end());
+    }
 }
 
 bool OpenGLShaderPass::stateIsActive()
@@ -698,17 +807,29 @@ void OpenGLShaderPass::renderAllContained(const Renderables& renderables,
 {
     // Keep a pointer to the last transform matrix and render entity used
     const Matrix4* transform = 0;
+    const RendererLight* lastLight = nullptr;
+
+    // The geometry of streamable renderables is collected and drawn at once,
+    // right before anything which would affect it (transform, light, other renderables)
+    OpenGLRenderStream& stream = OpenGLRenderStream::Instance();
+    bool useStream = stream.isEnabled();
+
+    RenderInfo info(current.getRenderFlags(), viewer, current.cubeMapMode);
 
     glPushMatrix();
 
     // Iterate over each transformed renderable in the vector
-    for (const TransformedRenderable& r : renderables)
+    for (Renderables::const_iterator i = renderables.begin(); i != renderables.end(); ++i)
     {
+        const TransformedRenderable& r = *i;
+
         // If the current iteration's transform matrix was different from the
         // last, apply it and store for the next iteration
         if (transform == NULL ||
             (transform != r.transform && !transform->isAffineEqual(*r.transform)))
         {
+            stream.flush(info);
+
             transform = r.transform;
             glPopMatrix();
             glPushMatrix();
@@ -731,14 +852,52 @@ void OpenGLShaderPass::renderAllContained(const Renderables& renderables,
         const RendererLight* light = r.light;
         if (current.glProgram && light)
         {
+            if (light != lastLight)
+            {
+                stream.flush(info);
+            }
+
             setUpLightingCalculation(current, light, viewer, *transform, time);
         }
+        lastLight = light;
+
+        if (useStream && r.renderable->writeToStream(info, stream))
+        {
+            continue;
+        }
+
+        // Everything streamed so far needs to be drawn before this one
+        stream.flush(info);
+
+        // Batches are switched off together with the stream
+        const OpenGLRenderBatch* batch = useStream ? r.renderable->getRenderBatch() : nullptr;
 
-        // Render the renderable
-        RenderInfo info(current.getRenderFlags(), viewer, current.cubeMapMode);
-        r.renderable->render(info);
+        if (batch == nullptr)
+        {
+            // Render the renderable
+            r.renderable->render(info);
+            continue;
+        }
+
+        // Hand the renderable to its batch, together with the ones following it
+        // which share the batch and need no change of transform or light
+        _batchedRenderables.clear();
+        _batchedRenderables.push_back(r.renderable);
+
+        while (i + 1 != renderables.end() &&
+               (i + 1)->renderable->getRenderBatch() == batch &&
+               (i + 1)->light == light &&
+               ((i + 1)->transform == transform || (i + 1)->transform->isAffineEqual(*transform)))
+        {
+            ++i;
+            _batchedRenderables.push_back(i->renderable);
+        }
+
+        batch->renderBatch(info, _batchedRenderables);
     }
 
+    stream.flush(info);
+
     // Cleanup
     glPopMatrix();
 }
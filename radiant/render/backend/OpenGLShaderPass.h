@@ -9,6 +9,7 @@
 /* FORWARD DECLS */
 class Matrix4;
 class OpenGLRenderable;
+class OpenGLInstancedGeometry;
 class RendererLight;
 
 namespace render
@@ -69,6 +70,15 @@ class OpenGLShaderPass
 
 	RenderablesByEntity _renderables;
 
+	// Buffer for the runs of renderables handed to an OpenGLRenderBatch
+	std::vector<const OpenGLRenderable*> _batchedRenderables;
+
+	// The transforms of the renderables sharing an OpenGLInstancedGeometry,
+	// grouped by geometry and handedness (right-handed = true)
+	typedef std::pair<const OpenGLInstancedGeometry*, bool> InstanceKey;
+	typedef std::map<InstanceKey, std::vector<const Matrix4*>> Instances;
+	Instances _instances;
+
 private:
 
 	// Apply own state to the "current" state object passed in as a reference,
@@ -85,6 +95,19 @@ private:
 
 	void setupTextureMatrix(GLenum textureUnit, const ShaderLayerPtr& stage);
 
+	// True if the renderables can be drawn instanced in the current state
+	bool canRenderInstanced(const OpenGLState& current) const;
+
+	// Groups the renderables by their instanced geometry
+	void collectInstances(const Renderables& renderables);
+
+	// True if the renderable is part of a group drawn by renderInstances()
+	bool isRenderedInstanced(const TransformedRenderable& renderable) const;
+
+	// Draws the renderables sharing their geometry with others, one call per
+	// geometry, and removes them from the renderables to be drawn one by one
+	void renderInstances(OpenGLState& current, const Vector3& viewer);
+
 	// Render all of the given TransformedRenderables
 	void renderAllContained(const Renderables& renderables,
 							OpenGLState& current,
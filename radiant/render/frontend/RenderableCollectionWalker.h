@@ -111,6 +111,28 @@ public:
         // Submit renderables from scene graph
         GlobalSceneGraph().foreachVisibleNodeInVolume(volume, renderHighlightWalker);
 
+        CollectAttachedRenderables(collector, volume);
+    }
+
+    /**
+     * \brief
+     * Same as above, but the scene nodes are taken from the given visible set
+     * cache, which is only re-evaluated for the nodes changed since the last call.
+     */
+    static void CollectRenderablesInScene(RenderableCollector& collector, const VolumeTest& volume,
+                                          scene::IVisibleSetCache& visibleSet)
+    {
+        RenderableCollectionWalker renderHighlightWalker(collector, volume);
+
+        GlobalSceneGraph().foreachVisibleNodeInVolume(volume, visibleSet,
+            [&](const scene::INodePtr& node) { return renderHighlightWalker.visit(node); });
+
+        CollectAttachedRenderables(collector, volume);
+    }
+
+private:
+    static void CollectAttachedRenderables(RenderableCollector& collector, const VolumeTest& volume)
+    {
         // Submit any renderables that have been directly attached to the RenderSystem
 		// without belonging to an actual scene object
         RenderableCollectionWalker walker(collector, volume);
@@ -0,0 +1,124 @@
+#include "FlatOctree.h"
+
+#include "inode.h"
+
+#include "FlatOctreeNode.h"
+
+namespace scene
+{
+
+namespace
+{
+	const float START_SIZE = 512.0f;
+	const float MAX_WORLD_COORD = 65536;
+
+	const AABB START_AABB(Vector3(0,0,0), Vector3(START_SIZE, START_SIZE, START_SIZE));
+}
+
+FlatOctree::FlatOctree()
+{
+	_root = std::make_shared<FlatOctreeNode>(*this, START_AABB);
+}
+
+FlatOctree::~FlatOctree()
+{
+	_root.reset();
+}
+
+void FlatOctree::link(const scene::INodePtr& sceneNode)
+{
+	// Make sure we don't do double-links
+	assert(sceneNode->getSpacePartitionSlot().owner != this);
+
+	ensureRootSize(sceneNode);
+
+	_root->linkRecursively(sceneNode);
+}
+
+bool FlatOctree::unlink(const scene::INodePtr& sceneNode)
+{
+	SpacePartitionSlot& slot = sceneNode->getSpacePartitionSlot();
+
+	if (slot.owner != this)
+	{
+		return false; // not linked into this tree
+	}
+
+	static_cast<FlatOctreeNode*>(slot.node)->removeMember(slot.index);
+	return true;
+}
+
+ISPNodePtr FlatOctree::getRoot() const
+{
+	return _root;
+}
+
+ISPNodePtr FlatOctree::getLinkedNode(const scene::INodePtr& sceneNode) const
+{
+	const SpacePartitionSlot& slot = sceneNode->getSpacePartitionSlot();
+
+	if (slot.owner != this)
+	{
+		return ISPNodePtr();
+	}
+
+	return static_cast<FlatOctreeNode*>(slot.node)->shared_from_this();
+}
+
+void FlatOctree::ensureRootSize(const scene::INodePtr& sceneNode)
+{
+	const AABB& aabb = sceneNode->worldAABB();
+
+	if (!aabb.isValid()) return; // skip this for invalid bounds
+
+	while (!_root->getBounds().contains(aabb))
+	{
+		AABB newBounds = _root->getBounds();
+		newBounds.extents *= 2;
+
+		// Don't go beyond the map limits
+		if (newBounds.extents.x() > MAX_WORLD_COORD)
+		{
+			break;
+		}
+
+		FlatOctreeNodePtr newRootPtr = std::make_shared<FlatOctreeNode>(*this, newBounds);
+
+		FlatOctreeNode& newRoot = *newRootPtr;
+		FlatOctreeNode& oldRoot = *_root;
+
+		// Same as in the regular Octree: the members of the old root stay in the
+		// new root, to avoid re-entering evaluateBounds() by calling link again.
+		oldRoot.relocateMembersTo(newRoot);
+
+		newRoot.subdivide();
+
+		if (!oldRoot.isLeaf())
+		{
+			// Each octant of the old root ends up as grandchild of the new root
+			for (std::size_t i = 0; i < 8; ++i)
+			{
+				newRoot[i].subdivide();
+
+				for (std::size_t j = 0; j < 8; ++j)
+				{
+					for (std::size_t old = 0; old < 8; ++old)
+					{
+						FlatOctreeNode& newNode = newRoot[i][j];
+
+						if (newNode.getBounds() == oldRoot[old].getBounds())
+						{
+							oldRoot[old].relocateMembersTo(newNode);
+							oldRoot[old].relocateChildrenTo(newNode);
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		_root = newRootPtr;
+	}
+}
+
+} // namespace scene
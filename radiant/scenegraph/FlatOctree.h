@@ -0,0 +1,56 @@
+#pragma once
+
+#include "ispacepartition.h"
+
+namespace scene
+{
+
+class FlatOctreeNode;
+typedef std::shared_ptr<FlatOctreeNode> FlatOctreeNodePtr;
+
+/**
+ * The FlatOctree is an alternative to the regular Octree, using
+ * the same subdivision rules (same start size, subdivision threshold and
+ * minimum octant size), but a different member storage.
+ *
+ * Each octant keeps its members in a contiguous array, and each linked
+ * scene::INode stores the octant and the array index it has been assigned
+ * to in its SpacePartitionSlot. This way unlink() doesn't need any lookup
+ * table or linear search: the member is removed from the array by moving
+ * the last member into its place (swap-remove), after which the moved
+ * member's slot index is updated.
+ *
+ * As a consequence, the order of members within an octant is not stable
+ * across unlink() calls, which is fine since the scenegraph doesn't make
+ * any assumptions about that order.
+ */
+class FlatOctree :
+	public ISpacePartitionSystem
+{
+private:
+	// The root node of this SP
+	FlatOctreeNodePtr _root;
+
+public:
+	FlatOctree();
+
+	~FlatOctree();
+
+	// Links this node into the SP tree.
+	void link(const scene::INodePtr& sceneNode) override;
+
+	// Unlink this node from the SP tree, returns true if it had been linked
+	bool unlink(const scene::INodePtr& sceneNode) override;
+
+	// Returns the root node of this SP tree
+	ISPNodePtr getRoot() const override;
+
+	// Returns the octant the given scene node is linked to, using the node's slot
+	ISPNodePtr getLinkedNode(const scene::INodePtr& sceneNode) const override;
+
+private:
+	// Extends the root node until it is large enough to encompass the scenenode's bounds
+	void ensureRootSize(const scene::INodePtr& sceneNode);
+};
+
+} // namespace scene
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "inode.h"
+#include "ispacepartition.h"
+#include "math/AABB.h"
+
+#include "FlatOctree.h"
+#include "OctreeNode.h"
+
+namespace scene
+{
+
+/**
+ * An octant of the FlatOctree. Subdivision works exactly like
+ * in the regular OctreeNode, but the members are held in a plain array
+ * and each member knows its own position in that array through
+ * the SpacePartitionSlot it carries around.
+ */
+class FlatOctreeNode :
+	public ISPNode,
+	public std::enable_shared_from_this<FlatOctreeNode>
+{
+private:
+	// The owning tree
+	const FlatOctree& _owner;
+
+	// Our bounds (which should be valid at all times)
+	AABB _bounds;
+
+	// The parent node
+	ISPNodeWeakPtr _parent;
+
+	// The child nodes (8 or 0)
+	NodeList _children;
+
+	// The members, each of them knows its index in this array
+	MemberList _members;
+
+public:
+	FlatOctreeNode(const FlatOctree& owner, const AABB& bounds,
+				   const FlatOctreeNodePtr& parent = FlatOctreeNodePtr()) :
+		_owner(owner),
+		_bounds(bounds),
+		_parent(parent)
+	{
+		assert(_bounds.isValid()); // require valid bounds
+	}
+
+	~FlatOctreeNode()
+	{
+		// Don't leave any dangling slot references behind
+		for (const INodePtr& member : _members)
+		{
+			SpacePartitionSlot& slot = member->getSpacePartitionSlot();
+
+			if (slot.node == this)
+			{
+				slot.clear();
+			}
+		}
+	}
+
+	ISPNodePtr getParent() const override
+	{
+		return _parent.lock();
+	}
+
+	const AABB& getBounds() const override
+	{
+		return _bounds;
+	}
+
+	const NodeList& getChildNodes() const override
+	{
+		return _children;
+	}
+
+	const MemberList& getMembers() const override
+	{
+		return _members;
+	}
+
+	bool isLeaf() const override
+	{
+		return _children.empty();
+	}
+
+	// Subdivide this node (adding 8 child nodes of half the size)
+	void subdivide()
+	{
+		_children.resize(8);
+
+		Vector3 childExtents = _bounds.extents * 0.5;
+
+		// Construct delta-vectors, pointing in each room direction
+		Vector3 x(childExtents.x(), 0, 0);
+		Vector3 y(0, childExtents.y(), 0);
+		Vector3 z(0, 0, childExtents.z());
+
+		Vector3 baseUpper = _bounds.origin + z;
+		Vector3 baseLower = _bounds.origin - z;
+
+		// Use the same octant ordering as the regular OctreeNode
+		_children[0] = createChild(baseUpper + x + y, childExtents);
+		_children[1] = createChild(baseUpper + x - y, childExtents);
+		_children[2] = createChild(baseUpper - x - y, childExtents);
+		_children[3] = createChild(baseUpper - x + y, childExtents);
+
+		_children[4] = createChild(baseLower + x + y, childExtents);
+		_children[5] = createChild(baseLower + x - y, childExtents);
+		_children[6] = createChild(baseLower - x - y, childExtents);
+		_children[7] = createChild(baseLower - x + y, childExtents);
+	}
+
+	// Indexing operator to retrieve a certain child
+	FlatOctreeNode& operator[](std::size_t index)
+	{
+		assert(index <= 7);
+		assert(!_children.empty());
+
+		return static_cast<FlatOctreeNode&>(*_children[index]);
+	}
+
+	// Moves all members of this node to the given target node
+	void relocateMembersTo(FlatOctreeNode& target)
+	{
+		target._members.reserve(target._members.size() + _members.size());
+
+		for (const INodePtr& member : _members)
+		{
+			target.addMember(member);
+		}
+
+		_members.clear();
+	}
+
+	// Moves all children of this node to the given target node, which must be a leaf
+	void relocateChildrenTo(FlatOctreeNode& target)
+	{
+		assert(isLeaf() || target.isLeaf());
+
+		target._children.swap(_children);
+		_children.clear();
+
+		target.reparentChildren();
+	}
+
+	void addMember(const INodePtr& sceneNode)
+	{
+		SpacePartitionSlot& slot = sceneNode->getSpacePartitionSlot();
+
+		slot.owner = &_owner;
+		slot.node = this;
+		slot.index = _members.size();
+
+		_members.push_back(sceneNode);
+	}
+
+	// Removes the member at the given index by moving the last member into its place
+	void removeMember(std::size_t index)
+	{
+		assert(index < _members.size());
+
+		_members[index]->getSpacePartitionSlot().clear();
+
+		if (index + 1 < _members.size())
+		{
+			_members[index] = std::move(_members.back());
+			_members[index]->getSpacePartitionSlot().index = index;
+		}
+
+		_members.pop_back();
+	}
+
+	// Links the given scene object into the smallest octant able to hold it
+	void linkRecursively(const INodePtr& sceneNode)
+	{
+		const AABB& bounds = sceneNode->worldAABB();
+
+		// If the AABB is not valid, just link it here
+		if (!bounds.isValid())
+		{
+			addMember(sceneNode);
+			return;
+		}
+
+		for (const ISPNodePtr& childPtr : _children)
+		{
+			FlatOctreeNode& child = static_cast<FlatOctreeNode&>(*childPtr);
+
+			if (child.getBounds().contains(bounds))
+			{
+				child.linkRecursively(sceneNode);
+				return;
+			}
+		}
+
+		// Node didn't fit into any of the children, link it here
+		addMember(sceneNode);
+
+		if (isLeaf() &&
+			_members.size() >= SUBDIVISION_THRESHOLD &&
+			_bounds.extents.x() > MIN_NODE_EXTENTS)
+		{
+			subdivide();
+
+			// Evaluate all member bounds before re-distributing them, this might
+			// cause some of them to re-link themselves, hence the copy.
+			{
+				MemberList temp = _members;
+
+				for (const INodePtr& member : temp)
+				{
+					member->worldAABB();
+				}
+			}
+
+			MemberList oldList;
+			oldList.swap(_members);
+
+			for (const INodePtr& member : oldList)
+			{
+				member->getSpacePartitionSlot().clear();
+
+				// We have 8 children now, so this won't end up in this branch again
+				linkRecursively(member);
+			}
+		}
+	}
+
+private:
+	ISPNodePtr createChild(const Vector3& origin, const Vector3& extents)
+	{
+		return std::make_shared<FlatOctreeNode>(_owner, AABB(origin, extents), shared_from_this());
+	}
+
+	// Tells each children who their parent is
+	void reparentChildren()
+	{
+		ISPNodePtr self = shared_from_this();
+
+		for (const ISPNodePtr& child : _children)
+		{
+			static_cast<FlatOctreeNode&>(*child)._parent = self;
+		}
+	}
+};
+
+} // namespace scene
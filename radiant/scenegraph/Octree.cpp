@@ -126,6 +126,13 @@ ISPNodePtr Octree::getRoot() const
 	return _root;
 }
 
+ISPNodePtr Octree::getLinkedNode(const scene::INodePtr& sceneNode) const
+{
+	NodeMapping::const_iterator found = _nodeMapping.find(sceneNode);
+
+	return found != _nodeMapping.end() ? found->second->shared_from_this() : ISPNodePtr();
+}
+
 void Octree::notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node)
 {
 	std::pair<NodeMapping::iterator, bool> result =
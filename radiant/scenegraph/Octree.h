@@ -63,6 +63,9 @@ public:
 	// Returns the root node of this SP tree
 	ISPNodePtr getRoot() const;
 
+	// Returns the octree node the given scene node is linked to
+	ISPNodePtr getLinkedNode(const scene::INodePtr& sceneNode) const;
+
 	// Callback used by the OctreeNodes to let the tree update its caching structures
 	void notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node);
 	void notifyUnlink(const scene::INodePtr& sceneNode, OctreeNode* node);
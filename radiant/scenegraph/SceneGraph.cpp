@@ -2,24 +2,102 @@
 
 #include "ivolumetest.h"
 #include "itextstream.h"
+#include "iregistry.h"
+#include "ithread.h"
 
 #include "scene/InstanceWalkers.h"
 #include "debugging/debugging.h"
 
 #include "math/AABB.h"
 #include "Octree.h"
+#include "FlatOctree.h"
 #include "SceneGraphFactory.h"
 #include "util/ScopedBoolLock.h"
 #include "modulesystem/StaticModule.h"
 
+
 namespace scene
 {
 
+namespace
+{
+	// Selects the space partition implementation, valid values are "octree" (default) and "flatoctree"
+	const char* const RKEY_SPACE_PARTITION_TYPE = "debug/scenegraph/spacePartition";
+
+	// Set this to 1 to cull the space partition on multiple threads
+	const char* const RKEY_PARALLEL_TRAVERSAL = "debug/scenegraph/parallelTraversal";
+
+	// The depth at which the space partition is split into work items for the parallel traversal
+	const std::size_t PARALLEL_SPLIT_DEPTH = 2;
+
+	// A portion of the parallel traversal. Nodes above the split depth just
+	// contribute their members, the ones at the split depth are culled
+	// including all their descendants.
+	struct TraversalWorkItem
+	{
+		const ISPNode* node;
+		bool includeChildren;
+
+		// The members of the visible octants, in traversal order
+		// Pointers remain valid since the partition is not changing during traversal
+		std::vector<const INodePtr*> members;
+
+		TraversalWorkItem(const ISPNode* node_, bool includeChildren_) :
+			node(node_),
+			includeChildren(includeChildren_)
+		{}
+	};
+
+	void collectVisibleMembers(const ISPNode& node, const VolumeTest& volume,
+							   std::vector<const INodePtr*>& result, bool includeChildren, bool visitHidden)
+	{
+		for (const INodePtr& member : node.getMembers())
+		{
+			if (visitHidden || member->visible())
+			{
+				result.push_back(&member);
+			}
+		}
+
+		if (!includeChildren) return;
+
+		for (const ISPNodePtr& child : node.getChildNodes())
+		{
+			if (volume.TestAABB(child->getBounds()) != VOLUME_OUTSIDE)
+			{
+				collectVisibleMembers(*child, volume, result, true, visitHidden);
+			}
+		}
+	}
+
+	// Splits the partition into work items, culling the octants above the split depth right away
+	void createWorkItems(const ISPNode& node, const VolumeTest& volume,
+						 std::vector<TraversalWorkItem>& items, std::size_t depth)
+	{
+		if (depth == PARALLEL_SPLIT_DEPTH || node.isLeaf())
+		{
+			items.emplace_back(&node, true);
+			return;
+		}
+
+		items.emplace_back(&node, false);
+
+		for (const ISPNodePtr& child : node.getChildNodes())
+		{
+			if (volume.TestAABB(child->getBounds()) != VOLUME_OUTSIDE)
+			{
+				createWorkItems(*child, volume, items, depth + 1);
+			}
+		}
+	}
+}
+
 SceneGraph::SceneGraph() :
 	_spacePartition(new Octree),
 	_visitedSPNodes(0),
 	_skippedSPNodes(0),
-    _traversalOngoing(false)
+    _traversalOngoing(false),
+    _parallelTraversal(false)
 {}
 
 SceneGraph::~SceneGraph()
@@ -86,7 +164,14 @@ void SceneGraph::setRoot(const IMapRootNodePtr& newRoot)
 	_root = newRoot;
 
 	// Refresh the space partition class
-	_spacePartition = ISpacePartitionSystemPtr(new Octree);
+	_spacePartition = createSpacePartition();
+
+	foreachVisibleSetCache([](VisibleSetCache& cache) { cache.invalidate(); });
+
+	if (module::GlobalModuleRegistry().moduleExists(MODULE_XMLREGISTRY))
+	{
+		_parallelTraversal = GlobalRegistry().get(RKEY_PARALLEL_TRAVERSAL) == "1";
+	}
 
 	if (_root)
 	{
@@ -121,6 +206,8 @@ void SceneGraph::insert(const INodePtr& node)
 	// Insert this node into our SP tree
 	_spacePartition->link(node);
 
+	foreachVisibleSetCache([&](VisibleSetCache& cache) { cache.onNodeInserted(node); });
+
 	// Call the onInsert event on the node
     assert(_root);
 	node->onInsertIntoScene(*_root);
@@ -141,6 +228,8 @@ void SceneGraph::erase(const INodePtr& node)
 
 	_spacePartition->unlink(node);
 
+	foreachVisibleSetCache([&](VisibleSetCache& cache) { cache.onNodeErased(node); });
+
 	// Fire the onRemove event on the Node
     assert(_root);
     node->onRemoveFromScene(*_root);
@@ -166,6 +255,8 @@ void SceneGraph::nodeBoundsChanged(const INodePtr& node)
 	{
 		// unlink returned true, so the given node was linked before => re-link it
 		_spacePartition->link(node);
+
+		foreachVisibleSetCache([&](VisibleSetCache& cache) { cache.onNodeBoundsChanged(node); });
 	}
 }
 
@@ -225,7 +316,14 @@ void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::Visi
 
         _visitedSPNodes = _skippedSPNodes = 0;
 
-        foreachNodeInVolume_r(*root, volume, functor, visitHidden);
+        if (_parallelTraversal)
+        {
+            foreachNodeInVolumeParallel(*root, volume, functor, visitHidden);
+        }
+        else
+        {
+            foreachNodeInVolume_r(*root, volume, functor, visitHidden);
+        }
 
         _visitedSPNodes = _skippedSPNodes = 0;
     }
@@ -234,6 +332,66 @@ void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::Visi
     flushActionBuffer();
 }
 
+IVisibleSetCachePtr SceneGraph::createVisibleSetCache()
+{
+	VisibleSetCachePtr cache = std::make_shared<VisibleSetCache>();
+
+	_visibleSetCaches.push_back(cache);
+
+	return cache;
+}
+
+void SceneGraph::foreachVisibleNodeInVolume(const VolumeTest& volume, IVisibleSetCache& cache,
+	const INode::VisitorFunc& functor)
+{
+    // Evaluate the root bounds first, this might re-link some nodes (see above)
+    if (_root != nullptr) _root->worldAABB();
+
+    VisibleSetCache& visibleSet = static_cast<VisibleSetCache&>(cache);
+
+    if (visibleSet.isValidFor(volume))
+    {
+        // Same view as last time, only consider the nodes which changed since
+        visibleSet.update(*_spacePartition, volume);
+    }
+    else
+    {
+        visibleSet.rebuild(*_spacePartition, volume);
+    }
+
+    {
+        // Buffer any calls that might happen in between
+        util::ScopedBoolLock traversal(_traversalOngoing);
+
+        for (const INodePtr& node : visibleSet.getNodes())
+        {
+            if (!node->visible()) continue;
+
+            if (!functor(node)) break;
+        }
+    }
+
+    flushActionBuffer();
+}
+
+void SceneGraph::foreachVisibleSetCache(const std::function<void(VisibleSetCache&)>& func)
+{
+	for (auto i = _visibleSetCaches.begin(); i != _visibleSetCaches.end(); /* in-loop */)
+	{
+		VisibleSetCachePtr cache = i->lock();
+
+		if (!cache)
+		{
+			// The view discarded this cache, forget about it
+			i = _visibleSetCaches.erase(i);
+			continue;
+		}
+
+		func(*cache);
+		++i;
+	}
+}
+
 void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, Walker& walker)
 {
 	// Use a small adaptor lambda to dispatch calls to the walker
@@ -298,11 +456,51 @@ bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& vo
 	return true; // continue traversal
 }
 
+void SceneGraph::foreachNodeInVolumeParallel(const ISPNode& root, const VolumeTest& volume,
+											 const INode::VisitorFunc& functor, bool visitHidden)
+{
+	std::vector<TraversalWorkItem> items;
+	createWorkItems(root, volume, items, 0);
+
+	// Phase 1: cull the octants below the split depth, each work item
+	// gets its own result buffer, so no synchronisation is needed
+	GlobalThreadManager().parallelForEach(items.size(), [&](std::size_t i)
+	{
+		TraversalWorkItem& item = items[i];
+		collectVisibleMembers(*item.node, volume, item.members, item.includeChildren, visitHidden);
+	}, ThreadManager::Priority::High);
+
+	// Phase 2: hand the members to the functor, in traversal order
+	for (const TraversalWorkItem& item : items)
+	{
+		for (const INodePtr* member : item.members)
+		{
+			if (!functor(*member))
+			{
+				return;
+			}
+		}
+	}
+}
+
 ISpacePartitionSystemPtr SceneGraph::getSpacePartition()
 {
 	return _spacePartition;
 }
 
+ISpacePartitionSystemPtr SceneGraph::createSpacePartition()
+{
+	// The registry is not yet available when the main scenegraph is constructed,
+	// the type is only evaluated when a new root is assigned
+	if (module::GlobalModuleRegistry().moduleExists(MODULE_XMLREGISTRY) &&
+		GlobalRegistry().get(RKEY_SPACE_PARTITION_TYPE) == "flatoctree")
+	{
+		return std::make_shared<FlatOctree>();
+	}
+
+	return std::make_shared<Octree>();
+}
+
 void SceneGraph::flushActionBuffer()
 {
     // Do any actions now, in the same order they came in
@@ -334,7 +532,14 @@ const std::string& SceneGraphModule::getName() const
 
 const StringSet& SceneGraphModule::getDependencies() const
 {
-	static StringSet _dependencies; // no deps
+	static StringSet _dependencies;
+
+	if (_dependencies.empty())
+	{
+		_dependencies.insert(MODULE_XMLREGISTRY);
+		_dependencies.insert(MODULE_THREADMANAGER);
+	}
+
 	return _dependencies;
 }
 
@@ -343,6 +548,12 @@ void SceneGraphModule::initialiseModule(const ApplicationContext& ctx)
 	rMessage() << getName() << "::initialiseModule called" << std::endl;
 }
 
+bool SceneGraphModule::isInitialisationThreadSafe() const
+{
+	// Nothing but our own state is touched during initialisation
+	return true;
+}
+
 // Static module instances
 module::StaticModule<SceneGraphModule> sceneGraphModule;
 module::StaticModule<SceneGraphFactory> sceneGraphFactory;
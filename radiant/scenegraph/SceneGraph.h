@@ -9,6 +9,8 @@
 #include "ispacepartition.h"
 #include "imap.h"
 
+#include "VisibleSetCache.h"
+
 namespace scene
 {
 
@@ -51,6 +53,12 @@ private:
 
     bool _traversalOngoing;
 
+    // Whether foreachNodeInVolume culls the space partition on worker threads
+    bool _parallelTraversal;
+
+    // The visible set caches handed out to the views, to be kept up to date
+    std::vector<std::weak_ptr<VisibleSetCache>> _visibleSetCaches;
+
 public:
 	SceneGraph();
 
@@ -91,6 +99,10 @@ public:
     void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
     void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
 
+    IVisibleSetCachePtr createVisibleSetCache() override;
+    void foreachVisibleNodeInVolume(const VolumeTest& volume, IVisibleSetCache& cache,
+        const INode::VisitorFunc& functor) override;
+
     ISpacePartitionSystemPtr getSpacePartition() override;
 private:
 	void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor, bool visitHidden);
@@ -99,7 +111,19 @@ private:
 	bool foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume, 
 							   const INode::VisitorFunc& functor, bool visitHidden);
 
+	// Two-phase variant: the partition is culled on worker threads first, the
+	// collected members are passed to the functor afterwards, in the same order
+	// foreachNodeInVolume_r would visit them.
+	void foreachNodeInVolumeParallel(const ISPNode& root, const VolumeTest& volume,
+									 const INode::VisitorFunc& functor, bool visitHidden);
+
     void flushActionBuffer();
+
+	// Instantiates the space partition type as configured in the registry
+	ISpacePartitionSystemPtr createSpacePartition();
+
+	// Invokes the given function on each of the visible set caches still in use
+	void foreachVisibleSetCache(const std::function<void(VisibleSetCache&)>& func);
 };
 typedef std::shared_ptr<SceneGraph> SceneGraphPtr;
 
@@ -113,6 +137,7 @@ public:
 	const std::string& getName() const;
 	const StringSet& getDependencies() const;
 	void initialiseModule(const ApplicationContext& ctx);
+	bool isInitialisationThreadSafe() const;
 };
 typedef std::shared_ptr<SceneGraphModule> SceneGraphModulePtr;
 
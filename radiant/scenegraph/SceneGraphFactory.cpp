@@ -28,4 +28,10 @@ void SceneGraphFactory::initialiseModule(const ApplicationContext& ctx)
 	rMessage() << getName() << "::initialiseModule called." << std::endl;
 }
 
+bool SceneGraphFactory::isInitialisationThreadSafe() const
+{
+	// Nothing but our own state is touched during initialisation
+	return true;
+}
+
 } // namespace
@@ -15,6 +15,7 @@ public:
 	const std::string& getName() const;
 	const StringSet& getDependencies() const;
 	void initialiseModule(const ApplicationContext& ctx);
+	bool isInitialisationThreadSafe() const;
 };
 typedef std::shared_ptr<SceneGraphFactory> SceneGraphFactoryPtr;
 
@@ -0,0 +1,149 @@
+#include "VisibleSetCache.h"
+
+#include "ivolumetest.h"
+
+namespace scene
+{
+
+VisibleSetCache::VisibleSetCache() :
+	_valid(false)
+{}
+
+void VisibleSetCache::invalidate()
+{
+	_valid = false;
+
+	_nodes.clear();
+	_nodeIndices.clear();
+	_changedNodes.clear();
+}
+
+bool VisibleSetCache::isValidFor(const VolumeTest& volume) const
+{
+	return _valid &&
+		_modelview == volume.GetModelview() &&
+		_projection == volume.GetProjection() &&
+		_viewport == volume.GetViewport();
+}
+
+void VisibleSetCache::rebuild(const ISpacePartitionSystem& spacePartition, const VolumeTest& volume)
+{
+	invalidate();
+
+	_modelview = volume.GetModelview();
+	_projection = volume.GetProjection();
+	_viewport = volume.GetViewport();
+
+	collectNodes_r(*spacePartition.getRoot(), volume);
+
+	_valid = true;
+}
+
+void VisibleSetCache::update(const ISpacePartitionSystem& spacePartition, const VolumeTest& volume)
+{
+	for (const INodePtr& node : _changedNodes)
+	{
+		if (isInVolume(spacePartition, node, volume))
+		{
+			addNode(node);
+		}
+		else
+		{
+			removeNode(node);
+		}
+	}
+
+	_changedNodes.clear();
+}
+
+void VisibleSetCache::onNodeInserted(const INodePtr& node)
+{
+	if (_valid)
+	{
+		_changedNodes.insert(node);
+	}
+}
+
+void VisibleSetCache::onNodeErased(const INodePtr& node)
+{
+	if (_valid)
+	{
+		_changedNodes.erase(node);
+		removeNode(node);
+	}
+}
+
+void VisibleSetCache::onNodeBoundsChanged(const INodePtr& node)
+{
+	if (_valid)
+	{
+		_changedNodes.insert(node);
+	}
+}
+
+void VisibleSetCache::addNode(const INodePtr& node)
+{
+	if (_nodeIndices.emplace(node.get(), _nodes.size()).second)
+	{
+		_nodes.push_back(node);
+	}
+}
+
+void VisibleSetCache::removeNode(const INodePtr& node)
+{
+	auto found = _nodeIndices.find(node.get());
+
+	if (found == _nodeIndices.end()) return;
+
+	std::size_t index = found->second;
+	_nodeIndices.erase(found);
+
+	// Move the last node into the gap
+	if (index + 1 < _nodes.size())
+	{
+		_nodes[index] = std::move(_nodes.back());
+		_nodeIndices[_nodes[index].get()] = index;
+	}
+
+	_nodes.pop_back();
+}
+
+void VisibleSetCache::collectNodes_r(const ISPNode& node, const VolumeTest& volume)
+{
+	for (const INodePtr& member : node.getMembers())
+	{
+		addNode(member);
+	}
+
+	for (const ISPNodePtr& child : node.getChildNodes())
+	{
+		if (volume.TestAABB(child->getBounds()) != VOLUME_OUTSIDE)
+		{
+			collectNodes_r(*child, volume);
+		}
+	}
+}
+
+bool VisibleSetCache::isInVolume(const ISpacePartitionSystem& spacePartition, const INodePtr& node,
+								 const VolumeTest& volume)
+{
+	ISPNodePtr spNode = spacePartition.getLinkedNode(node);
+
+	if (!spNode)
+	{
+		return false; // not linked at all
+	}
+
+	// Walk up the tree, the root node itself is never tested during traversal
+	for (ISPNodePtr parent = spNode->getParent(); parent; spNode = parent, parent = parent->getParent())
+	{
+		if (volume.TestAABB(spNode->getBounds()) == VOLUME_OUTSIDE)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+} // namespace scene
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "iscenegraph.h"
+#include "ispacepartition.h"
+#include "math/Matrix4.h"
+
+namespace scene
+{
+
+/**
+ * Implementation of the IVisibleSetCache. It holds the nodes
+ * the space partition traversal found in a given view volume, along
+ * with the matrices of that volume.
+ *
+ * The owning SceneGraph notifies each of its caches about inserted,
+ * erased and moved nodes. Erased nodes are dropped right away, inserted
+ * and moved ones are queued and tested against the volume on the next
+ * traversal. A node is considered to be in the volume if all the octants
+ * the space partition traversal would have to pass are intersecting it.
+ *
+ * Nodes leaving the volume as a side effect of a re-organisation of the
+ * space partition might stay in the cached set until the view changes.
+ * This is harmless as the renderables are culling themselves anyway.
+ *
+ * The set is limited by the view volume only, there is no occlusion test:
+ * nodes hidden behind others are part of the set and get rendered.
+ */
+class VisibleSetCache :
+	public IVisibleSetCache
+{
+private:
+	// The matrices of the volume the set has been built for
+	Matrix4 _modelview;
+	Matrix4 _projection;
+	Matrix4 _viewport;
+
+	bool _valid;
+
+	// The nodes found in the volume, visible or not
+	std::vector<INodePtr> _nodes;
+
+	// The position of each node in the above vector, for constant time removal
+	std::unordered_map<INode*, std::size_t> _nodeIndices;
+
+	// Nodes which have to be re-evaluated before the set can be used
+	std::unordered_set<INodePtr> _changedNodes;
+
+public:
+	VisibleSetCache();
+
+	void invalidate() override;
+
+	// Returns true if this cache has been built for the given volume
+	bool isValidFor(const VolumeTest& volume) const;
+
+	// Rebuilds the set from scratch by traversing the given space partition
+	void rebuild(const ISpacePartitionSystem& spacePartition, const VolumeTest& volume);
+
+	// Evaluates all the nodes which changed since the last call
+	void update(const ISpacePartitionSystem& spacePartition, const VolumeTest& volume);
+
+	// Notifications sent by the SceneGraph
+	void onNodeInserted(const INodePtr& node);
+	void onNodeErased(const INodePtr& node);
+	void onNodeBoundsChanged(const INodePtr& node);
+
+	const std::vector<INodePtr>& getNodes() const
+	{
+		return _nodes;
+	}
+
+private:
+	void addNode(const INodePtr& node);
+	void removeNode(const INodePtr& node);
+
+	void collectNodes_r(const ISPNode& node, const VolumeTest& volume);
+
+	// Checks whether the traversal would reach the given node
+	static bool isInVolume(const ISpacePartitionSystem& spacePartition, const INodePtr& node,
+						   const VolumeTest& volume);
+};
+typedef std::shared_ptr<VisibleSetCache> VisibleSetCachePtr;
+
+} // namespace scene
@@ -5,6 +5,7 @@
 #include "itextstream.h"
 #include "ifilesystem.h"
 #include "ipreferencesystem.h"
+#include "iprofiler.h"
 #include "ui/prefdialog/GameSetupDialog.h"
 
 #include "os/file.h"
@@ -25,6 +26,7 @@
 #include <sigc++/bind.h>
 
 #include <iostream>
+#include <algorithm>
 
 namespace game
 {
@@ -33,6 +35,7 @@ namespace
 {
 	const char* const GKEY_PREFAB_FOLDER = "/mapFormat/prefabFolder";
 	const char* const GKEY_MAPS_FOLDER = "/mapFormat/mapFolder";
+	const char* const RKEY_ARCHIVE_READ_BUFFER_SIZE = "user/ui/vfs/archiveReadBufferSize";
 }
 
 Manager::Manager()
@@ -347,7 +350,12 @@ void Manager::initialiseVfs()
 	// Update map and prefab paths
 	setMapAndPrefabPaths(userBasePath);
 
+	// The buffer size is stored in kB
+	GlobalFileSystem().setArchiveReadBufferSize(
+		static_cast<std::size_t>(std::max(registry::getValue<int>(RKEY_ARCHIVE_READ_BUFFER_SIZE), 0)) * 1024);
+
 	// Initialise the filesystem, if we were initialised before
+	profile::ScopedSpan span("VFS initialisation", "startup");
 	GlobalFileSystem().initialise(vfsSearchPaths, extensions);
 }
 
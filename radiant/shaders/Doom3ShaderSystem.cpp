@@ -47,7 +47,7 @@ namespace shaders
 
 // Constructor
 Doom3ShaderSystem::Doom3ShaderSystem() :
-    _defLoader(std::bind(&Doom3ShaderSystem::loadMaterialFiles, this)),
+    _defLoader(std::bind(&Doom3ShaderSystem::loadMaterialFiles, this), "Materials"),
     _enableActiveUpdates(true),
     _realised(false)
 {}
@@ -102,7 +102,10 @@ ShaderLibraryPtr Doom3ShaderSystem::loadMaterialFiles()
     {
         ScopedDebugTimer timer("ShaderFiles parsed: ");
         ShaderFileLoader<ShaderLibrary> loader(GlobalFileSystem(), *library,
-                                               sPath, extension);
+            sPath, extension, [](std::size_t count, const std::function<void(std::size_t)>& func)
+        {
+            GlobalThreadManager().parallelForEach(count, func);
+        });
         loader.parseFiles();
     }
 
@@ -336,6 +339,7 @@ const StringSet& Doom3ShaderSystem::getDependencies() const
         _dependencies.insert(MODULE_XMLREGISTRY);
         _dependencies.insert(MODULE_GAMEMANAGER);
         _dependencies.insert(MODULE_PREFERENCESYSTEM);
+        _dependencies.insert(MODULE_THREADMANAGER);
     }
 
     return _dependencies;
@@ -10,6 +10,9 @@
 #include "parser/DefBlockTokeniser.h"
 #include "string/replace.h"
 
+#include <functional>
+#include <stdexcept>
+
 namespace shaders
 {
 
@@ -24,10 +27,29 @@ template<typename ShaderLibrary_T> class ShaderFileLoader
     // List of shader definition files to parse
     std::vector<vfs::FileInfo> _files;
 
+public:
+    // Invokes the given function for the indices 0..count-1 and returns when
+    // all of them are done, passing on the first exception thrown
+    typedef std::function<void(std::size_t, const std::function<void(std::size_t)>&)> ParallelForEach;
+
 private:
+    ParallelForEach _parallelForEach;
 
-    // Parse a shader file with the given contents and filename
-    void parseShaderFile(std::istream& inStr, const vfs::FileInfo& fileInfo)
+private:
+    // A definition found in a shader file, these are collected by the
+    // worker threads and added to the library in VFS order afterwards
+    struct ParsedBlock
+    {
+        std::string name;
+
+        // Exactly one of these is set, or none for a table without name
+        TableDefinitionPtr table;
+        ShaderTemplatePtr shaderTemplate;
+    };
+    typedef std::vector<ParsedBlock> ParsedBlocks;
+
+    // Parse a shader file with the given contents, this doesn't touch the library
+    static void parseShaderFile(std::istream& inStr, ParsedBlocks& blocks)
     {
         // Parse the file with a blocktokeniser, the actual block contents
         // will be parsed separately.
@@ -41,22 +63,15 @@ private:
             // Skip tables
             if (block.name.substr(0, 5) == "table")
             {
-                std::string tableName = block.name.substr(6);
-
-                if (tableName.empty())
-                {
-                    rError() << "[shaders] " << fileInfo.name << ": Missing table name." << std::endl;
-                    continue;
-                }
-
-                TableDefinitionPtr table(new TableDefinition(tableName, block.contents));
+                ParsedBlock parsed;
+                parsed.name = block.name.substr(6);
 
-                if (!_library.addTableDefinition(table))
+                if (!parsed.name.empty())
                 {
-                    rError() << "[shaders] " << fileInfo.name
-                        << ": table " << tableName << " already defined." << std::endl;
+                    parsed.table.reset(new TableDefinition(parsed.name, block.contents));
                 }
 
+                blocks.emplace_back(std::move(parsed));
                 continue;
             }
             else if (block.name.substr(0, 5) == "skin ")
@@ -70,27 +85,60 @@ private:
 
             string::replace_all(block.name, "\\", "/"); // use forward slashes
 
-            ShaderTemplatePtr shaderTemplate(new ShaderTemplate(block.name, block.contents));
+            ParsedBlock parsed;
+            parsed.name = block.name;
+            parsed.shaderTemplate.reset(new ShaderTemplate(block.name, block.contents));
 
-            // Construct the ShaderDefinition wrapper class
-            ShaderDefinition def(shaderTemplate, fileInfo);
+            blocks.emplace_back(std::move(parsed));
+        }
+    }
 
-            // Insert into the definitions map, if not already present
-            if (!_library.addDefinition(block.name, def))
+    static void forEachSequentially(std::size_t count, const std::function<void(std::size_t)>& func)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            func(i);
+        }
+    }
+
+    // Adds the definitions of the given file to the library, the first one wins
+    void addToLibrary(const ParsedBlocks& blocks, const vfs::FileInfo& fileInfo)
+    {
+        for (const ParsedBlock& block : blocks)
+        {
+            if (block.shaderTemplate)
+            {
+                // Construct the ShaderDefinition wrapper class
+                ShaderDefinition def(block.shaderTemplate, fileInfo);
+
+                // Insert into the definitions map, if not already present
+                if (!_library.addDefinition(block.name, def))
+                {
+                    rError() << "[shaders] " << fileInfo.name
+                        << ": shader " << block.name << " already defined." << std::endl;
+                }
+            }
+            else if (!block.table)
+            {
+                rError() << "[shaders] " << fileInfo.name << ": Missing table name." << std::endl;
+            }
+            else if (!_library.addTableDefinition(block.table))
             {
                 rError() << "[shaders] " << fileInfo.name
-                    << ": shader " << block.name << " already defined." << std::endl;
+                    << ": table " << block.name << " already defined." << std::endl;
             }
         }
     }
 
 public:
 
-    /// Construct and initialise the ShaderFileLoader
+    /// Construct and initialise the ShaderFileLoader. The files are parsed
+    /// one after the other unless a parallel-for is passed in.
     ShaderFileLoader(vfs::VirtualFileSystem& fs, ShaderLibrary_T& library,
                      const std::string& basedir,
-                     const std::string& extension = "mtr")
-    : _vfs(fs), _library(library)
+                     const std::string& extension = "mtr",
+                     const ParallelForEach& parallelForEach = forEachSequentially)
+    : _vfs(fs), _library(library), _parallelForEach(parallelForEach)
     {
         _files.reserve(200);
 
@@ -102,22 +150,29 @@ public:
         );
     }
 
+    // Parses the files using the parallel-for passed to the constructor, the
+    // definitions are then added to the library in the order of the file list
     void parseFiles()
     {
-        for (const vfs::FileInfo& fileInfo: _files)
+        std::vector<ParsedBlocks> results(_files.size());
+
+        _parallelForEach(_files.size(), [&](std::size_t i)
         {
             // Open the file
-            ArchiveTextFilePtr file = _vfs.openTextFile(fileInfo.fullPath());
+            ArchiveTextFilePtr file = _vfs.openTextFile(_files[i].fullPath());
 
-            if (file != nullptr)
-            {
-                std::istream is(&(file->getInputStream()));
-                parseShaderFile(is, fileInfo);
-            }
-            else
+            if (file == nullptr)
             {
-                throw std::runtime_error("Unable to read shaderfile: " + fileInfo.name);
+                throw std::runtime_error("Unable to read shaderfile: " + _files[i].name);
             }
+
+            std::istream is(&(file->getInputStream()));
+            parseShaderFile(is, results[i]);
+        });
+
+        for (std::size_t i = 0; i < _files.size(); ++i)
+        {
+            addToLibrary(results[i], _files[i]);
         }
     }
 };
@@ -1146,7 +1146,7 @@ bool ShaderTemplate::saveLayer()
 void ShaderTemplate::parseDefinition()
 {
     // Construct a local deftokeniser to parse the unparsed block
-    parser::BasicDefTokeniser<std::string> tokeniser(
+    parser::BasicDefTokeniser<std::string_view> tokeniser(
         _blockContents,
 		parser::WHITESPACE, // delimiters (whitespace)
         "{}(),"  // add the comma character to the kept delimiters
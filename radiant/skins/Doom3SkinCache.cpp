@@ -17,7 +17,7 @@ namespace
 }
 
 Doom3SkinCache::Doom3SkinCache() :
-    _defLoader(std::bind(&Doom3SkinCache::loadSkinFiles, this)),
+    _defLoader(std::bind(&Doom3SkinCache::loadSkinFiles, this), "Skins"),
     _nullSkin("")
 {}
 
@@ -102,8 +102,9 @@ void Doom3SkinCache::loadSkinFiles()
 // Parse the contents of a .skin file
 void Doom3SkinCache::parseFile(std::istream& contents, const std::string& filename)
 {
-    // Construct a DefTokeniser to parse the file
-	parser::BasicDefTokeniser<std::istream> tok(contents);
+    // Construct a DefTokeniser to parse the file, working on an in-memory copy
+	std::string buffer((std::istreambuf_iterator<char>(contents)), std::istreambuf_iterator<char>());
+	parser::BasicDefTokeniser<std::string_view> tok(buffer);
 
 	// Call the parseSkin() function for each skin decl
 	while (tok.hasMoreTokens())
@@ -207,6 +208,7 @@ const StringSet& Doom3SkinCache::getDependencies() const
 	if (_dependencies.empty())
     {
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
+		_dependencies.insert(MODULE_THREADMANAGER);
 	}
 
 	return _dependencies;
@@ -231,6 +233,12 @@ void Doom3SkinCache::initialiseModule(const ApplicationContext& ctx)
     refresh();
 }
 
+bool Doom3SkinCache::isInitialisationThreadSafe() const
+{
+	// Nothing but our own state is touched during initialisation
+	return true;
+}
+
 // Module instance
 module::StaticModule<Doom3SkinCache> skinCacheModule;
 
@@ -71,6 +71,7 @@ public:
 	const std::string& getName() const override;
     const StringSet& getDependencies() const override;
     void initialiseModule(const ApplicationContext& ctx) override;
+    bool isInitialisationThreadSafe() const override;
 
 private:
     // Load and parse the skin files, populating internal data structures.
@@ -0,0 +1,268 @@
+#define BOOST_TEST_MODULE archiveManifestTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "radiant/vfs/ArchiveManifest.h"
+#include "itextstream.h"
+#include "os/fs.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const char* const PAK_FILE = "tdm_example_mtrs.pk4";
+    const char* const OTHER_PAK_FILE = "test_models.pk4";
+
+    bool isSameFileList(const archive::ZipArchive::FileList& a, const archive::ZipArchive::FileList& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+            [](const archive::ZipArchive::FileEntry& x, const archive::ZipArchive::FileEntry& y)
+        {
+            return x.path == y.path && x.position == y.position && x.compressedSize == y.compressedSize &&
+                x.uncompressedSize == y.uncompressedSize && x.type == y.type;
+        });
+    }
+
+    // Returns the contents of the given file in the archive
+    std::string readArchiveFile(archive::ZipArchive& archive, const std::string& name)
+    {
+        ArchiveFilePtr file = archive.openFile(name);
+        BOOST_REQUIRE(file);
+
+        std::string contents(file->size(), '\0');
+        file->getInputStream().read(reinterpret_cast<InputStream::byte_type*>(&contents[0]), contents.size());
+
+        return contents;
+    }
+}
+
+// Fixture providing a search path with copies of the test pak files and an empty manifest folder
+struct ArchiveManifestFixture
+{
+    fs::path folder;
+
+    std::string searchPath;
+    std::string manifestFolder;
+
+    std::string pakFilename;
+    std::string otherPakFilename;
+
+    // Get the srcdir environment variable (set by Automake)
+    std::string srcdir() const
+    {
+        const char* envVal = getenv("srcdir");
+        if (envVal)
+            return std::string(envVal);
+        else
+            throw std::runtime_error("srcdir not set");
+    }
+
+    ArchiveManifestFixture() :
+        folder(fs::temp_directory_path() / "archiveManifestTest")
+    {
+        GlobalOutputStream().setStream(std::cout);
+
+        fs::remove_all(folder);
+        fs::create_directories(folder / "paks");
+
+        searchPath = (folder / "paks").string() + "/";
+        manifestFolder = (folder / "manifests").string() + "/";
+
+        pakFilename = searchPath + PAK_FILE;
+        otherPakFilename = searchPath + OTHER_PAK_FILE;
+
+        fs::copy_file(srcdir() + "/test/data/vfs_root/" + PAK_FILE, pakFilename);
+        fs::copy_file(srcdir() + "/test/data/vfs_root/" + OTHER_PAK_FILE, otherPakFilename);
+    }
+
+    ~ArchiveManifestFixture()
+    {
+        fs::remove_all(folder);
+    }
+
+    // Reads the central directory of the given pak and stores it in the manifest,
+    // the same way the Doom3FileSystem does
+    archive::ZipArchive::FileList addPakFile(vfs::ArchiveManifest& manifest, const std::string& filename)
+    {
+        std::uint64_t size = 0;
+        std::int64_t modificationTime = 0;
+
+        BOOST_CHECK(manifest.findFileList(filename, size, modificationTime) == nullptr);
+        BOOST_CHECK_EQUAL(size, fs::file_size(filename));
+
+        archive::ZipArchive::FileList files = archive::ZipArchive(filename).getFileList();
+        BOOST_REQUIRE(!files.empty());
+
+        manifest.setFileList(filename, size, modificationTime, archive::ZipArchive::FileList(files));
+
+        return files;
+    }
+
+    const archive::ZipArchive::FileList* findFileList(vfs::ArchiveManifest& manifest, const std::string& filename)
+    {
+        std::uint64_t size = 0;
+        std::int64_t modificationTime = 0;
+
+        return manifest.findFileList(filename, size, modificationTime);
+    }
+
+    // The manifest written for the search path
+    std::string getManifestFilename()
+    {
+        std::vector<fs::path> files;
+
+        for (fs::directory_iterator i(manifestFolder); i != fs::directory_iterator(); ++i)
+        {
+            files.push_back(i->path());
+        }
+
+        BOOST_REQUIRE_EQUAL(files.size(), 1);
+
+        return files.front().string();
+    }
+
+    std::string readFile(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& filename, const std::string& contents)
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file << contents;
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(missingManifest, ArchiveManifestFixture)
+{
+    vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+
+    BOOST_CHECK(findFileList(manifest, pakFilename) == nullptr);
+
+    // Nothing has changed, nothing is written
+    manifest.save();
+    BOOST_CHECK(!fs::exists(manifestFolder));
+}
+
+BOOST_FIXTURE_TEST_CASE(saveAndLoad, ArchiveManifestFixture)
+{
+    archive::ZipArchive::FileList files;
+
+    {
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        files = addPakFile(manifest, pakFilename);
+        manifest.save();
+    }
+
+    vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+    const archive::ZipArchive::FileList* cached = findFileList(manifest, pakFilename);
+
+    BOOST_REQUIRE(cached != nullptr);
+    BOOST_CHECK(isSameFileList(*cached, files));
+
+    // The archive constructed from the cached list provides the same contents
+    archive::ZipArchive cachedArchive(pakFilename, *cached);
+    archive::ZipArchive archive(pakFilename);
+
+    BOOST_CHECK(cachedArchive.containsFile("materials/tdm_bloom_afx.mtr"));
+    BOOST_CHECK(!cachedArchive.containsFile("materials/nothere.mtr"));
+    BOOST_CHECK_EQUAL(readArchiveFile(cachedArchive, "materials/tdm_bloom_afx.mtr"),
+                      readArchiveFile(archive, "materials/tdm_bloom_afx.mtr"));
+
+    // The manifest of another search path is a different one
+    vfs::ArchiveManifest otherManifest(manifestFolder, searchPath + "other/");
+    BOOST_CHECK(findFileList(otherManifest, pakFilename) == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(stalePakFile, ArchiveManifestFixture)
+{
+    {
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        addPakFile(manifest, pakFilename);
+        manifest.save();
+    }
+
+    // Replacing the pak file changes its size
+    fs::remove(pakFilename);
+    fs::copy_file(otherPakFilename, pakFilename);
+
+    vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+    BOOST_CHECK(findFileList(manifest, pakFilename) == nullptr);
+
+    // A missing pak file is no match either
+    fs::remove(pakFilename);
+    BOOST_CHECK(findFileList(manifest, pakFilename) == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(unusedPakFilesAreRemoved, ArchiveManifestFixture)
+{
+    {
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        addPakFile(manifest, pakFilename);
+        addPakFile(manifest, otherPakFilename);
+        manifest.save();
+    }
+
+    {
+        // Only the first pak is looked up this time
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        BOOST_CHECK(findFileList(manifest, pakFilename) != nullptr);
+        manifest.save();
+    }
+
+    vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+    BOOST_CHECK(findFileList(manifest, pakFilename) != nullptr);
+    BOOST_CHECK(findFileList(manifest, otherPakFilename) == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(corruptManifest, ArchiveManifestFixture)
+{
+    {
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        addPakFile(manifest, pakFilename);
+        manifest.save();
+    }
+
+    std::string manifestFilename = getManifestFilename();
+    std::string contents = readFile(manifestFilename);
+
+    // Wrong magic
+    std::string damaged = contents;
+    damaged[0] = 'X';
+    writeFile(manifestFilename, damaged);
+    {
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        BOOST_CHECK(findFileList(manifest, pakFilename) == nullptr);
+    }
+
+    // Invalid type of the last entry
+    damaged = contents;
+    damaged.back() = 0x7f;
+    writeFile(manifestFilename, damaged);
+    {
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        BOOST_CHECK(findFileList(manifest, pakFilename) == nullptr);
+    }
+
+    // Truncated anywhere
+    for (std::size_t length = 0; length < contents.size(); ++length)
+    {
+        writeFile(manifestFilename, contents.substr(0, length));
+
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        BOOST_CHECK_MESSAGE(findFileList(manifest, pakFilename) == nullptr,
+            "Manifest truncated to " << length << " bytes is accepted");
+    }
+
+    // A damaged manifest is replaced on the next save
+    {
+        vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+        addPakFile(manifest, pakFilename);
+        manifest.save();
+    }
+
+    vfs::ArchiveManifest manifest(manifestFolder, searchPath);
+    BOOST_CHECK(findFileList(manifest, pakFilename) != nullptr);
+}
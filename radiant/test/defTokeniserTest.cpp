@@ -0,0 +1,179 @@
+#define BOOST_TEST_MODULE defTokeniserTest
+#include <boost/test/included/unit_test.hpp>
+
+#define SPECIALISE_STR_TO_FLOAT
+
+#include "parser/DefTokeniser.h"
+#include "string/convert.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Returns all tokens of the given tokeniser
+    std::vector<std::string> getTokens(parser::DefTokeniser& tok)
+    {
+        std::vector<std::string> tokens;
+
+        while (tok.hasMoreTokens())
+        {
+            tokens.push_back(tok.nextToken());
+        }
+
+        return tokens;
+    }
+
+    // The string_view tokeniser has to return the same tokens as the std::string one
+    void checkSameTokens(const std::string& input,
+                         const char* delims = parser::WHITESPACE,
+                         const char* keptDelims = "{}()")
+    {
+        parser::BasicDefTokeniser<std::string> reference(input, delims, keptDelims);
+        parser::BasicDefTokeniser<std::string_view> tokeniser(input, delims, keptDelims);
+
+        std::vector<std::string> expected = getTokens(reference);
+        std::vector<std::string> tokens = getTokens(tokeniser);
+
+        BOOST_CHECK_EQUAL_COLLECTIONS(tokens.begin(), tokens.end(),
+                                      expected.begin(), expected.end());
+    }
+
+    // Compares bits, which also covers signed zeros and NaN
+    bool isSameDouble(double a, double b)
+    {
+        return std::memcmp(&a, &b, sizeof(double)) == 0;
+    }
+
+    // The fast conversion has to return the same value as the C library
+    void checkConvertDecimal(const std::string& str)
+    {
+        double result;
+
+        if (string::detail::convertDecimalFast(str.data(), str.size(), result))
+        {
+            double expected = std::strtod(str.c_str(), nullptr);
+
+            BOOST_CHECK_MESSAGE(isSameDouble(result, expected),
+                "convertDecimalFast(" << str << ") returned " << result << ", expected " << expected);
+        }
+
+        double expected = std::atof(str.c_str());
+
+        BOOST_CHECK_MESSAGE(isSameDouble(string::to_float(str), expected),
+            "to_float(" << str << ") differs from atof");
+        BOOST_CHECK_MESSAGE(isSameDouble(string::to_float(std::string_view(str)), expected),
+            "to_float(string_view " << str << ") differs from atof");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(tokeniseSimple)
+{
+    checkSameTokens("");
+    checkSameTokens("   \t\n  ");
+    checkSameTokens("one two\tthree\r\nfour");
+    checkSameTokens("entityDef atdm:ai { \"inherit\" \"atdm:base\" }");
+    checkSameTokens("( 0 0 1 -64 ) ( ( 0.0078125 0 0 ) ( 0 0.0078125 0 ) )");
+    checkSameTokens("a{b}c(d)e");
+}
+
+BOOST_AUTO_TEST_CASE(tokeniseComments)
+{
+    checkSameTokens("one // comment\ntwo");
+    checkSameTokens("one /* block\n comment */ two");
+    checkSameTokens("one/* adjacent */two");
+    checkSameTokens("// comment at the end");
+    checkSameTokens("one /* unterminated");
+    checkSameTokens("a / b");
+    checkSameTokens("textures/common/caulk");
+    checkSameTokens("trailing/");
+    checkSameTokens("\"quoted // not a comment\" next");
+}
+
+BOOST_AUTO_TEST_CASE(tokeniseQuotes)
+{
+    checkSameTokens("\"\" \"empty before\"");
+    checkSameTokens("\"with spaces { and } delims\"");
+    checkSameTokens("\"escaped \\\"quote\\\" and \\n newline\"");
+    checkSameTokens("\"continued\" \\ \"string\" after");
+    checkSameTokens("\"continued\"\\\n\"string\"");
+    checkSameTokens("\"unterminated");
+    checkSameTokens("word\"quote\"");
+}
+
+BOOST_AUTO_TEST_CASE(tokeniseCustomDelims)
+{
+    checkSameTokens("a,b;c d", " ,", ";");
+    checkSameTokens("key=value\nkey2 = value2", " \t\n=", "");
+}
+
+BOOST_AUTO_TEST_CASE(tokenViewStaysValid)
+{
+    std::string input("\"first \\\"escaped\\\"\" \"second \\\"escaped\\\"\" plain");
+    parser::BasicDefTokeniser<std::string_view> tok(input);
+
+    // The assembled token must survive reading the next one
+    std::string_view first = tok.nextTokenView();
+    std::string_view second = tok.nextTokenView();
+
+    BOOST_CHECK_EQUAL(std::string(first), "first \"escaped\"");
+    BOOST_CHECK_EQUAL(std::string(second), "second \"escaped\"");
+
+    BOOST_CHECK_EQUAL(tok.peek(), "plain");
+    tok.assertNextToken("plain");
+    BOOST_CHECK(!tok.hasMoreTokens());
+    BOOST_CHECK_THROW(tok.nextToken(), parser::ParseException);
+}
+
+BOOST_AUTO_TEST_CASE(convertDecimal)
+{
+    const char* values[] =
+    {
+        "0", "-0", "+0", "0.0", "-0.0", "1", "-1", "+1", "10", "0.5", "-12.5",
+        "0.015625", "0.0078125", "0.1", "0.2", "0.3", "123.456", "-64", "1024.125",
+        "3.14159265358979", "0.333333333333333", "1e3", "1E-3", "-2.5e+2", "1e22",
+        "1e23", "1e-22", "1e-23", "123456789012345678", "1234567890123456789",
+        "9007199254740993", "0.000000000000000000000000001", "5.", ".5", "-.5",
+        "00012.5000", "1.7976931348623157e308", "4.9e-324", "1e", "1e+", "--1",
+        "1.2.3", "abc", "12abc", "", "-", ".", "nan", "inf", "0x10"
+    };
+
+    for (const char* value : values)
+    {
+        checkConvertDecimal(value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(convertDecimalRandom)
+{
+    std::mt19937 generator(4711);
+    std::uniform_real_distribution<double> distribution(-65536.0, 65536.0);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        std::ostringstream stream;
+        stream.precision(1 + i % 17);
+        stream << distribution(generator);
+
+        checkConvertDecimal(stream.str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(convertDecimalRejects)
+{
+    double result;
+
+    const char* invalid[] = { "", "-", ".", "e5", "1e", "1x", "1.2.3", " 1", "1 " };
+
+    for (const char* value : invalid)
+    {
+        BOOST_CHECK_MESSAGE(!string::detail::convertDecimalFast(value, std::strlen(value), result),
+            "convertDecimalFast should reject \"" << value << "\"");
+    }
+
+    // Too many significant digits are left to atof
+    std::string digits("1234567890123456789");
+    BOOST_CHECK(!string::detail::convertDecimalFast(digits.data(), digits.size(), result));
+}
@@ -0,0 +1,96 @@
+#define BOOST_TEST_MODULE exportUtilTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "map/format/primitivewriters/ExportUtil.h"
+
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace
+{
+    // The output of writeDoubleSafe, using the given stream precision
+    std::string writeSafe(double d, std::streamsize precision)
+    {
+        std::ostringstream stream;
+        stream.precision(precision);
+        map::writeDoubleSafe(d, stream);
+        return stream.str();
+    }
+
+    // The output of the plain stream operator
+    std::string writeStream(double d, std::streamsize precision)
+    {
+        std::ostringstream stream;
+        stream.precision(precision);
+        stream << d;
+        return stream.str();
+    }
+
+    void checkSameOutput(double d, std::streamsize precision)
+    {
+        BOOST_CHECK_EQUAL(writeSafe(d, precision), writeStream(d, precision));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(writeInvalidValues)
+{
+    BOOST_CHECK_EQUAL(writeSafe(0.0, 6), "0");
+    BOOST_CHECK_EQUAL(writeSafe(-0.0, 6), "0");
+    BOOST_CHECK_EQUAL(writeSafe(std::numeric_limits<double>::quiet_NaN(), 6), "0");
+    BOOST_CHECK_EQUAL(writeSafe(std::numeric_limits<double>::infinity(), 6), "0");
+    BOOST_CHECK_EQUAL(writeSafe(-std::numeric_limits<double>::infinity(), 6), "0");
+}
+
+BOOST_AUTO_TEST_CASE(writeExactValues)
+{
+    // Values covered by the exact formatting
+    const double values[] =
+    {
+        1, -1, 2, 10, 64, -64, 128, 1024, 65536, 131072, 999999, 0.5, -0.5, 0.25,
+        0.125, 0.015625, 0.0078125, 0.0001220703125, 12.5, -12.5, 1024.125, 4096.75
+    };
+
+    for (std::streamsize precision : { 1, 3, 6, 9, 12, 15, 17 })
+    {
+        for (double value : values)
+        {
+            checkSameOutput(value, precision);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(writeOtherValues)
+{
+    // Values needing rounding or the exponential notation
+    const double values[] =
+    {
+        0.1, -0.3, 1.0 / 3, 3.14159265358979, 1e7, 1234567, 1e-5, 0.0000152587890625,
+        123456789012345678.0, 1e300, -1e-300, 9223372036854775808.0, 0.99999999
+    };
+
+    for (std::streamsize precision : { 1, 6, 9, 17 })
+    {
+        for (double value : values)
+        {
+            checkSameOutput(value, precision);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(writeRandomValues)
+{
+    std::mt19937 generator(4711);
+    std::uniform_real_distribution<double> distribution(-65536.0, 65536.0);
+    std::uniform_int_distribution<int> powers(-12, 16);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        double value = distribution(generator);
+
+        checkSameOutput(value, 6 + i % 12);
+
+        // Grid-aligned values, which are written by the exact formatting
+        checkSameOutput(std::ldexp(std::round(value), powers(generator)), 6 + i % 12);
+    }
+}
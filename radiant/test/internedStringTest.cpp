@@ -0,0 +1,92 @@
+#define BOOST_TEST_MODULE internedStringTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "string/InternedString.h"
+#include "string/string.h"
+
+#include <algorithm>
+#include <vector>
+
+using string::InternedString;
+
+BOOST_AUTO_TEST_CASE(internSameString)
+{
+    InternedString first("textures/common/caulk");
+    InternedString second(std::string("textures/common/caulk"));
+
+    BOOST_CHECK(first == second);
+    BOOST_CHECK_EQUAL(first.c_str(), second.c_str());
+    BOOST_CHECK_EQUAL(first.str(), "textures/common/caulk");
+    BOOST_CHECK_EQUAL(first.hash(), second.hash());
+}
+
+BOOST_AUTO_TEST_CASE(internMixedCase)
+{
+    InternedString mixed("Textures/Common/Nodraw");
+    InternedString lower("textures/common/nodraw");
+
+    // Different strings, but equal when ignoring the case
+    BOOST_CHECK(mixed != lower);
+    BOOST_CHECK_EQUAL(mixed.str(), "Textures/Common/Nodraw");
+    BOOST_CHECK(mixed.equalsNoCase(lower));
+    BOOST_CHECK(lower.equalsNoCase(mixed));
+
+    BOOST_CHECK(!mixed.equalsNoCase(InternedString("textures/common/caulk")));
+}
+
+BOOST_AUTO_TEST_CASE(emptyString)
+{
+    InternedString empty;
+
+    BOOST_CHECK(empty.empty());
+    BOOST_CHECK(empty == InternedString(""));
+    BOOST_CHECK(!InternedString("a").empty());
+}
+
+BOOST_AUTO_TEST_CASE(findInterned)
+{
+    InternedString handle;
+
+    BOOST_CHECK(!InternedString::Find("never_interned_Find_test", handle));
+    BOOST_CHECK(handle.empty());
+
+    InternedString interned("Find_Test_MixedCase");
+
+    BOOST_CHECK(InternedString::Find("Find_Test_MixedCase", handle));
+    BOOST_CHECK(handle == interned);
+
+    // Other case variants are found through the lowercase entry
+    BOOST_CHECK(InternedString::Find("FIND_TEST_MIXEDCASE", handle));
+    BOOST_CHECK(handle.equalsNoCase(interned));
+
+    // Find doesn't add anything to the pool
+    BOOST_CHECK(!InternedString::Find("never_interned_Find_test", handle));
+}
+
+BOOST_AUTO_TEST_CASE(lessNoCaseOrdering)
+{
+    std::vector<std::string> strings = {
+        "func_static", "Func_Static", "light", "LIGHT_Ambient", "a", "B", "b",
+        "worldspawn", "info_player_start", "Info_Player_Deathmatch", "_underscore", ""
+    };
+
+    for (const auto& a : strings)
+    {
+        for (const auto& b : strings)
+        {
+            bool expected = string_compare_nocase(a.c_str(), b.c_str()) < 0;
+
+            BOOST_CHECK_MESSAGE(InternedString(a).lessNoCase(InternedString(b)) == expected,
+                "lessNoCase(" << a << ", " << b << ") should be " << expected);
+        }
+    }
+
+    // Case variants are equivalent keys in an ordered container
+    std::vector<InternedString> sorted(strings.begin(), strings.end());
+    std::sort(sorted.begin(), sorted.end(), string::InternedStringLessNoCase());
+
+    for (std::size_t i = 1; i < sorted.size(); ++i)
+    {
+        BOOST_CHECK(string_compare_nocase(sorted[i - 1].c_str(), sorted[i].c_str()) <= 0);
+    }
+}
@@ -0,0 +1,227 @@
+#define BOOST_TEST_MODULE mapCacheTest
+#include <boost/test/included/unit_test.hpp>
+
+#include "radiant/map/MapCache.h"
+#include "itextstream.h"
+#include "os/fs.h"
+
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    const std::string MAP_CONTENTS =
+        "Version 2\n// entity 0\n{\n\"classname\" \"worldspawn\"\n}\n";
+    const std::string INFO_CONTENTS =
+        "DarkRadiant Map Information File Version 2\n{\n}\n";
+
+    // Counts the nodes created from the cache
+    class CountingImportFilter :
+        public map::IMapImportFilter
+    {
+    public:
+        std::size_t numEntities = 0;
+        std::size_t numPrimitives = 0;
+
+        bool addEntity(const scene::INodePtr& entity) override
+        {
+            ++numEntities;
+            return true;
+        }
+
+        bool addPrimitiveToEntity(const scene::INodePtr& primitive, const scene::INodePtr& entity) override
+        {
+            ++numPrimitives;
+            return true;
+        }
+    };
+}
+
+// Fixture providing a map and an info file in a temporary folder
+struct MapCacheFixture
+{
+    fs::path folder;
+
+    std::string mapFilename;
+    std::string infoFilename;
+    std::string cacheFilename;
+
+    MapCacheFixture() :
+        folder(fs::temp_directory_path() / "mapCacheTest")
+    {
+        GlobalOutputStream().setStream(std::cout);
+
+        fs::remove_all(folder);
+        fs::create_directories(folder);
+
+        mapFilename = (folder / "test.map").string();
+        infoFilename = (folder / "test.darkradiant").string();
+        cacheFilename = map::MapCache::getCacheFilename(mapFilename);
+
+        writeFile(mapFilename, MAP_CONTENTS);
+        writeFile(infoFilename, INFO_CONTENTS);
+    }
+
+    ~MapCacheFixture()
+    {
+        fs::remove_all(folder);
+    }
+
+    void writeFile(const std::string& filename, const std::string& contents)
+    {
+        std::ofstream file(filename, std::ios::binary);
+        file << contents;
+    }
+
+    std::string readFile(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // Reads the map and info file and saves their cache, as done after parsing the map
+    void saveCache(bool withInfoFile = true)
+    {
+        map::MapCache cache;
+
+        std::string contents;
+        BOOST_REQUIRE(cache.readMapFile(mapFilename, contents));
+        BOOST_CHECK_EQUAL(contents, MAP_CONTENTS);
+
+        if (withInfoFile)
+        {
+            BOOST_REQUIRE(cache.readInfoFile(infoFilename));
+        }
+
+        cache.save(mapFilename);
+
+        BOOST_REQUIRE(fs::exists(cacheFilename));
+    }
+
+    bool loadCache()
+    {
+        map::MapCache cache;
+        return cache.load(mapFilename, infoFilename);
+    }
+};
+
+BOOST_FIXTURE_TEST_CASE(fileStamp, MapCacheFixture)
+{
+    map::MapCache::FileStamp first;
+    map::MapCache::FileStamp second;
+    std::string contents;
+
+    BOOST_REQUIRE(map::MapCache::getFileStamp(mapFilename, first, contents));
+    BOOST_CHECK_EQUAL(contents, MAP_CONTENTS);
+    BOOST_CHECK_EQUAL(first.size, MAP_CONTENTS.size());
+
+    BOOST_REQUIRE(map::MapCache::getFileStamp(infoFilename, second, contents));
+    BOOST_CHECK(first.hash != second.hash);
+
+    BOOST_CHECK(!map::MapCache::getFileStamp((folder / "missing.map").string(), second, contents));
+}
+
+BOOST_FIXTURE_TEST_CASE(roundTrip, MapCacheFixture)
+{
+    saveCache();
+
+    map::MapCache cache;
+    BOOST_REQUIRE(cache.load(mapFilename, infoFilename));
+
+    BOOST_CHECK(cache.hasInfoFile());
+    BOOST_CHECK_EQUAL(cache.getInfoFileContents(), INFO_CONTENTS);
+
+    // Nothing has been captured, so there are no nodes to create
+    CountingImportFilter filter;
+    cache.createNodes(filter);
+
+    BOOST_CHECK_EQUAL(filter.numEntities, 0);
+    BOOST_CHECK_EQUAL(filter.numPrimitives, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(roundTripWithoutInfoFile, MapCacheFixture)
+{
+    fs::remove(infoFilename);
+    saveCache(false);
+
+    map::MapCache cache;
+    BOOST_REQUIRE(cache.load(mapFilename, infoFilename));
+    BOOST_CHECK(!cache.hasInfoFile());
+
+    // An info file showing up later on invalidates the cache
+    writeFile(infoFilename, INFO_CONTENTS);
+    BOOST_CHECK(!loadCache());
+}
+
+BOOST_FIXTURE_TEST_CASE(missingCache, MapCacheFixture)
+{
+    BOOST_CHECK(!loadCache());
+}
+
+BOOST_FIXTURE_TEST_CASE(staleMapFile, MapCacheFixture)
+{
+    saveCache();
+
+    writeFile(mapFilename, MAP_CONTENTS + "// entity 1\n");
+    BOOST_CHECK(!loadCache());
+}
+
+BOOST_FIXTURE_TEST_CASE(staleContentsWithSameStamp, MapCacheFixture)
+{
+    saveCache();
+
+    // Same size and modification time, the content hash has to catch this
+    auto modificationTime = fs::last_write_time(mapFilename);
+
+    std::string changed = MAP_CONTENTS;
+    changed[changed.find("worldspawn")] = 'W';
+
+    writeFile(mapFilename, changed);
+    fs::last_write_time(mapFilename, modificationTime);
+
+    BOOST_CHECK(!loadCache());
+}
+
+BOOST_FIXTURE_TEST_CASE(staleInfoFile, MapCacheFixture)
+{
+    saveCache();
+
+    writeFile(infoFilename, INFO_CONTENTS + "\n");
+    BOOST_CHECK(!loadCache());
+
+    fs::remove(infoFilename);
+    BOOST_CHECK(!loadCache());
+}
+
+BOOST_FIXTURE_TEST_CASE(corruptCache, MapCacheFixture)
+{
+    saveCache();
+
+    std::string cache = readFile(cacheFilename);
+    BOOST_REQUIRE(loadCache());
+
+    // Wrong magic
+    std::string damaged = cache;
+    damaged[0] = 'X';
+    writeFile(cacheFilename, damaged);
+    BOOST_CHECK(!loadCache());
+
+    // Unknown version
+    damaged = cache;
+    damaged[4] = static_cast<char>(0xff);
+    writeFile(cacheFilename, damaged);
+    BOOST_CHECK(!loadCache());
+
+    // Truncated at every possible position
+    for (std::size_t length = 0; length < cache.size(); ++length)
+    {
+        writeFile(cacheFilename, cache.substr(0, length));
+        BOOST_CHECK_MESSAGE(!loadCache(), "Cache truncated to " << length << " bytes is accepted");
+    }
+
+    // Huge string count at the end of the header
+    damaged = cache;
+    damaged.replace(damaged.size() - 8, 4, "\xff\xff\xff\xff");
+    writeFile(cacheFilename, damaged);
+    BOOST_CHECK(!loadCache());
+}
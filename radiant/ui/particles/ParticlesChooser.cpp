@@ -142,7 +142,7 @@ void ParticlesChooser::populateParticleList()
 	row[COLUMNS().name] = "Loading...";
 	row.SendItemAdded();
 	
-	GlobalRadiant().getThreadManager().execute(
+	GlobalThreadManager().execute(
 		std::bind(&ThreadedParticlesLoader::run, _particlesLoader.get())
     );
 }
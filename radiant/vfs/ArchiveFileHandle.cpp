@@ -0,0 +1,295 @@
+#include "ArchiveFileHandle.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#ifdef WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#endif
+
+namespace archive
+{
+
+#ifdef WIN32
+
+ArchiveFileHandle::ArchiveFileHandle(const std::string& path) :
+	_handle(CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)),
+	_mapping(nullptr),
+	_mappedData(nullptr),
+	_mappedSize(0)
+{}
+
+ArchiveFileHandle::~ArchiveFileHandle()
+{
+	unmapFile();
+
+	if (!failed())
+	{
+		CloseHandle(_handle);
+	}
+}
+
+bool ArchiveFileHandle::failed() const
+{
+	return _handle == INVALID_HANDLE_VALUE;
+}
+
+ArchiveFileHandle::size_type ArchiveFileHandle::read(position_type position, byte_type* buffer, size_type length) const
+{
+	size_type total = 0;
+
+	while (total < length)
+	{
+		// The offset in the OVERLAPPED structure makes this a positional read
+		OVERLAPPED overlapped;
+		std::memset(&overlapped, 0, sizeof(overlapped));
+
+		ULARGE_INTEGER offset;
+		offset.QuadPart = position + total;
+		overlapped.Offset = offset.LowPart;
+		overlapped.OffsetHigh = offset.HighPart;
+
+		DWORD bytesRead = 0;
+		DWORD bytesToRead = static_cast<DWORD>(std::min<size_type>(length - total, 1 << 30));
+
+		if (!ReadFile(_handle, buffer + total, bytesToRead, &bytesRead, &overlapped) || bytesRead == 0)
+		{
+			break;
+		}
+
+		total += bytesRead;
+	}
+
+	return total;
+}
+
+void ArchiveFileHandle::mapFile()
+{
+	LARGE_INTEGER fileSize;
+
+	if (failed() || !GetFileSizeEx(_handle, &fileSize) || fileSize.QuadPart == 0 ||
+		static_cast<unsigned long long>(fileSize.QuadPart) > SIZE_MAX)
+	{
+		return;
+	}
+
+	_mapping = CreateFileMappingA(_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (_mapping == nullptr)
+	{
+		return;
+	}
+
+	void* data = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (data == nullptr)
+	{
+		CloseHandle(_mapping);
+		_mapping = nullptr;
+		return;
+	}
+
+	_mappedData = static_cast<const unsigned char*>(data);
+	_mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+}
+
+void ArchiveFileHandle::unmapFile()
+{
+	if (_mappedData != nullptr)
+	{
+		UnmapViewOfFile(_mappedData);
+		_mappedData = nullptr;
+		_mappedSize = 0;
+	}
+
+	if (_mapping != nullptr)
+	{
+		CloseHandle(_mapping);
+		_mapping = nullptr;
+	}
+}
+
+#else
+
+ArchiveFileHandle::ArchiveFileHandle(const std::string& path) :
+	_fd(open(path.c_str(), O_RDONLY)),
+	_mappedData(nullptr),
+	_mappedSize(0)
+{}
+
+ArchiveFileHandle::~ArchiveFileHandle()
+{
+	unmapFile();
+
+	if (!failed())
+	{
+		close(_fd);
+	}
+}
+
+bool ArchiveFileHandle::failed() const
+{
+	return _fd == -1;
+}
+
+ArchiveFileHandle::size_type ArchiveFileHandle::read(position_type position, byte_type* buffer, size_type length) const
+{
+	size_type total = 0;
+
+	while (total < length)
+	{
+		ssize_t bytesRead = pread(_fd, buffer + total, length - total, static_cast<off_t>(position + total));
+
+		if (bytesRead < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		if (bytesRead <= 0)
+		{
+			break;
+		}
+
+		total += static_cast<size_type>(bytesRead);
+	}
+
+	return total;
+}
+
+void ArchiveFileHandle::mapFile()
+{
+	struct stat info;
+
+	if (failed() || fstat(_fd, &info) != 0 || info.st_size == 0 ||
+		static_cast<unsigned long long>(info.st_size) > SIZE_MAX)
+	{
+		return;
+	}
+
+	void* data = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, _fd, 0);
+
+	if (data == MAP_FAILED)
+	{
+		return;
+	}
+
+	_mappedData = static_cast<const unsigned char*>(data);
+	_mappedSize = static_cast<std::size_t>(info.st_size);
+}
+
+void ArchiveFileHandle::unmapFile()
+{
+	if (_mappedData != nullptr)
+	{
+		munmap(const_cast<unsigned char*>(_mappedData), _mappedSize);
+		_mappedData = nullptr;
+		_mappedSize = 0;
+	}
+}
+
+#endif
+
+const ArchiveFileHandle::byte_type* ArchiveFileHandle::getMappedData()
+{
+	std::call_once(_mapFlag, [this]() { mapFile(); });
+	return _mappedData;
+}
+
+ArchiveFileHandle::size_type ArchiveFileHandle::getMappedSize()
+{
+	std::call_once(_mapFlag, [this]() { mapFile(); });
+	return _mappedSize;
+}
+
+ArchiveFileStream::ArchiveFileStream(const ArchiveFileHandlePtr& handle, position_type offset,
+	size_type size, size_type bufferSize) :
+	_handle(handle),
+	_start(offset),
+	_end(offset + size),
+	_position(offset),
+	_buffer(std::min(bufferSize, size)),
+	_bufferStart(offset),
+	_bufferLength(0)
+{}
+
+ArchiveFileStream::size_type ArchiveFileStream::read(byte_type* buffer, size_type length)
+{
+	length = std::min(length, _end - _position);
+
+	size_type total = 0;
+
+	while (total < length)
+	{
+		if (_position >= _bufferStart && _position < _bufferStart + _bufferLength)
+		{
+			// Serve what we can from the buffer
+			size_type available = std::min(length - total, _bufferStart + _bufferLength - _position);
+			std::memcpy(buffer + total, _buffer.data() + (_position - _bufferStart), available);
+
+			total += available;
+			_position += available;
+			continue;
+		}
+
+		size_type remaining = length - total;
+
+		if (remaining >= _buffer.size())
+		{
+			// Large reads go straight into the target buffer
+			size_type bytesRead = _handle->read(_position, buffer + total, remaining);
+
+			total += bytesRead;
+			_position += bytesRead;
+			break;
+		}
+
+		// Refill the buffer
+		_bufferStart = _position;
+		_bufferLength = _handle->read(_position, _buffer.data(), std::min(_buffer.size(), _end - _position));
+
+		if (_bufferLength == 0)
+		{
+			break;
+		}
+	}
+
+	return total;
+}
+
+ArchiveFileStream::position_type ArchiveFileStream::seek(position_type position)
+{
+	_position = std::min(_start + position, _end);
+	return 0;
+}
+
+ArchiveFileStream::position_type ArchiveFileStream::seek(offset_type offset, seekdir direction)
+{
+	position_type base = direction == cur ? _position : direction == end ? _end : _start;
+
+	if (offset < 0 && static_cast<position_type>(-offset) > base - _start)
+	{
+		_position = _start;
+	}
+	else
+	{
+		_position = std::min(base + offset, _end);
+	}
+
+	return 0;
+}
+
+ArchiveFileStream::position_type ArchiveFileStream::tell() const
+{
+	return _position - _start;
+}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "idatastream.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+namespace archive
+{
+
+/**
+ * A read-only handle to an archive file on disk, which is opened
+ * once and shared by all the files opened from that archive.
+ *
+ * All reads are positional (pread), they don't touch any file pointer,
+ * so any number of threads can read through the same handle at once
+ * without seeking or locking.
+ *
+ * The whole file can additionally be mapped into memory, which allows
+ * the uncompressed entries to be accessed in place.
+ */
+class ArchiveFileHandle
+{
+private:
+#ifdef WIN32
+	void* _handle;
+	void* _mapping;
+#else
+	int _fd;
+#endif
+
+	// Mapped on first request, unmapped on destruction
+	std::once_flag _mapFlag;
+	const unsigned char* _mappedData;
+	std::size_t _mappedSize;
+
+public:
+	typedef InputStream::byte_type byte_type;
+	typedef InputStream::size_type size_type;
+	typedef SeekableStream::position_type position_type;
+
+	ArchiveFileHandle(const std::string& path);
+	~ArchiveFileHandle();
+
+	ArchiveFileHandle(const ArchiveFileHandle& other) = delete;
+	ArchiveFileHandle& operator=(const ArchiveFileHandle& other) = delete;
+
+	bool failed() const;
+
+	// Reads up to <length> bytes starting at the given absolute position.
+	// Returns the number of bytes read, which is less than the requested
+	// length only at the end of the file or on error.
+	size_type read(position_type position, byte_type* buffer, size_type length) const;
+
+	// Returns the contents of the whole file mapped into memory, or nullptr
+	// if the file can't be mapped. The mapping is valid for the lifetime of
+	// this handle.
+	const byte_type* getMappedData();
+
+	// The size of the mapped data (0 if not mapped)
+	size_type getMappedSize();
+
+private:
+	void mapFile();
+	void unmapFile();
+};
+typedef std::shared_ptr<ArchiveFileHandle> ArchiveFileHandlePtr;
+
+/**
+ * A stream reading the given range of an archive file through its shared handle.
+ * Positions passed to seek() and returned by tell() are relative to the start
+ * of the range.
+ *
+ * With a non-zero buffer size, small reads are served from a read-ahead buffer
+ * which is refilled with a single read of that size.
+ */
+class ArchiveFileStream :
+	public SeekableInputStream
+{
+private:
+	ArchiveFileHandlePtr _handle;
+
+	// Absolute positions in the archive file
+	position_type _start;
+	position_type _end;
+	position_type _position;
+
+	std::vector<byte_type> _buffer;
+	position_type _bufferStart;	// absolute position of the buffer contents
+	size_type _bufferLength;
+
+public:
+	ArchiveFileStream(const ArchiveFileHandlePtr& handle, position_type offset,
+		size_type size, size_type bufferSize = 0);
+
+	size_type read(byte_type* buffer, size_type length) override;
+
+	position_type seek(position_type position) override;
+	position_type seek(offset_type offset, seekdir direction) override;
+	position_type tell() const override;
+};
+
+}
@@ -0,0 +1,212 @@
+#include "ArchiveManifest.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include "itextstream.h"
+
+#include "os/fs.h"
+#include "stream/BinaryFile.h"
+
+namespace vfs
+{
+
+using namespace stream::binary;
+
+namespace
+{
+	const char MANIFEST_MAGIC[4] = { 'D', 'R', 'V', 'M' };
+
+	// Increase this whenever the layout below changes
+	const std::uint32_t MANIFEST_VERSION = 1;
+
+	// Sanity limit to avoid huge allocations when reading a damaged file
+	const std::uint32_t MAX_ELEMENTS = 1 << 24;
+
+	// The manifest filename is derived from a hash of the search path (FNV-1a)
+	std::string getManifestFilename(const std::string& manifestFolder, const std::string& searchPath)
+	{
+		std::uint64_t hash = 14695981039346656037ull;
+
+		for (char c : searchPath)
+		{
+			hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		}
+
+		std::ostringstream filename;
+		filename << manifestFolder << std::hex << std::setw(16) << std::setfill('0') << hash << ".manifest";
+
+		return filename.str();
+	}
+}
+
+ArchiveManifest::ArchiveManifest(const std::string& manifestFolder, const std::string& searchPath) :
+	_filename(getManifestFilename(manifestFolder, searchPath)),
+	_changed(false)
+{
+	std::ifstream stream(_filename, std::ios::binary);
+
+	if (!stream)
+	{
+		return;
+	}
+
+	try
+	{
+		char magic[sizeof(MANIFEST_MAGIC)];
+		stream.read(magic, sizeof(magic));
+
+		if (!stream || std::memcmp(magic, MANIFEST_MAGIC, sizeof(magic)) != 0 ||
+			readValue<std::uint32_t>(stream) != MANIFEST_VERSION)
+		{
+			return;
+		}
+
+		std::uint32_t numPakFiles = readCount(stream, MAX_ELEMENTS);
+
+		for (std::uint32_t i = 0; i < numPakFiles; ++i)
+		{
+			std::string pakFilename = readString(stream, MAX_ELEMENTS);
+			PakFileInfo& info = _pakFiles[pakFilename];
+
+			info.size = readValue<std::uint64_t>(stream);
+			info.modificationTime = readValue<std::int64_t>(stream);
+			info.used = false;
+
+			info.files.resize(readCount(stream, MAX_ELEMENTS));
+
+			for (archive::ZipArchive::FileEntry& entry : info.files)
+			{
+				entry.path = readString(stream, MAX_ELEMENTS);
+				entry.position = readValue<std::uint32_t>(stream);
+				entry.compressedSize = readValue<std::uint32_t>(stream);
+				entry.uncompressedSize = readValue<std::uint32_t>(stream);
+
+				std::uint8_t type = readValue<std::uint8_t>(stream);
+
+				if (type > archive::ZipArchive::FileEntry::Directory)
+				{
+					throw std::runtime_error("Invalid entry type");
+				}
+
+				entry.type = static_cast<archive::ZipArchive::FileEntry::Type>(type);
+			}
+		}
+	}
+	catch (std::runtime_error& ex)
+	{
+		rWarning() << "[vfs] Discarding archive manifest " << _filename << ": " << ex.what() << std::endl;
+		_pakFiles.clear();
+	}
+}
+
+const archive::ZipArchive::FileList* ArchiveManifest::findFileList(const std::string& pakFilename,
+	std::uint64_t& size, std::int64_t& modificationTime)
+{
+	try
+	{
+		size = static_cast<std::uint64_t>(fs::file_size(pakFilename));
+	}
+	catch (fs::filesystem_error&)
+	{
+		size = 0;
+	}
+
+	modificationTime = os::getFileModificationTime(pakFilename);
+
+	auto found = _pakFiles.find(pakFilename);
+
+	if (found == _pakFiles.end() || found->second.size != size ||
+		found->second.modificationTime != modificationTime || modificationTime == 0)
+	{
+		return nullptr;
+	}
+
+	found->second.used = true;
+
+	return &found->second.files;
+}
+
+void ArchiveManifest::setFileList(const std::string& pakFilename, std::uint64_t size,
+	std::int64_t modificationTime, archive::ZipArchive::FileList&& files)
+{
+	PakFileInfo& info = _pakFiles[pakFilename];
+
+	info.size = size;
+	info.modificationTime = modificationTime;
+	info.files = std::move(files);
+	info.used = true;
+
+	_changed = true;
+}
+
+void ArchiveManifest::save()
+{
+	// Forget about the pak files which are gone
+	for (auto i = _pakFiles.begin(); i != _pakFiles.end();)
+	{
+		if (!i->second.used)
+		{
+			_pakFiles.erase(i++);
+			_changed = true;
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	if (!_changed)
+	{
+		return;
+	}
+
+	try
+	{
+		fs::create_directories(fs::path(_filename).parent_path());
+	}
+	catch (fs::filesystem_error& ex)
+	{
+		rWarning() << "[vfs] Cannot create folder for archive manifest: " << ex.what() << std::endl;
+		return;
+	}
+
+	try
+	{
+		stream::writeFileAtomically(_filename, [&](std::ostream& stream)
+		{
+			stream.write(MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC));
+			writeValue(stream, MANIFEST_VERSION);
+
+			writeValue(stream, static_cast<std::uint32_t>(_pakFiles.size()));
+
+			for (const auto& pair : _pakFiles)
+			{
+				writeString(stream, pair.first);
+				writeValue(stream, pair.second.size);
+				writeValue(stream, pair.second.modificationTime);
+
+				writeValue(stream, static_cast<std::uint32_t>(pair.second.files.size()));
+
+				for (const archive::ZipArchive::FileEntry& entry : pair.second.files)
+				{
+					writeString(stream, entry.path);
+					writeValue(stream, entry.position);
+					writeValue(stream, entry.compressedSize);
+					writeValue(stream, entry.uncompressedSize);
+					writeValue(stream, static_cast<std::uint8_t>(entry.type));
+				}
+			}
+		});
+
+		_changed = false;
+	}
+	catch (std::runtime_error& ex)
+	{
+		rWarning() << "[vfs] Failed to write archive manifest " << _filename << ": " << ex.what() << std::endl;
+	}
+}
+
+} // namespace
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <cstdint>
+#include "ZipArchive.h"
+
+namespace vfs
+{
+
+/**
+ * The cached table of contents of the pak files in a single VFS
+ * search path, stored as binary file in the user's settings folder.
+ *
+ * Each pak file is keyed on its full path, file size and modification time.
+ * If these match, the ZipArchive can be constructed from the cached file list
+ * without opening the pak file, saving the central directory scan on startup.
+ */
+class ArchiveManifest
+{
+private:
+	struct PakFileInfo
+	{
+		std::uint64_t size;
+		std::int64_t modificationTime;
+		archive::ZipArchive::FileList files;
+		bool used;
+	};
+
+	std::string _filename;
+
+	// Pak file path => info
+	std::map<std::string, PakFileInfo> _pakFiles;
+
+	bool _changed;
+
+public:
+	// Loads the manifest of the given search path from the given folder (if it exists)
+	ArchiveManifest(const std::string& manifestFolder, const std::string& searchPath);
+
+	// Returns the cached file list of the given pak file, or nullptr if it is
+	// missing or outdated. Size and modification time are returned in any case.
+	const archive::ZipArchive::FileList* findFileList(const std::string& pakFilename,
+		std::uint64_t& size, std::int64_t& modificationTime);
+
+	// Stores the file list of the given pak file, as read from its central directory
+	void setFileList(const std::string& pakFilename, std::uint64_t size,
+		std::int64_t modificationTime, archive::ZipArchive::FileList&& files);
+
+	// Writes the manifest to disk if it has changed. Pak files which haven't been
+	// looked up since loading the manifest are removed from it.
+	void save();
+};
+
+} // namespace
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "iarchive.h"
-#include "stream/FileInputStream.h"
+#include "ArchiveFileHandle.h"
 #include "DeflatedInputStream.h"
 
 namespace archive
@@ -12,24 +12,23 @@ class DeflatedArchiveFile :
 {
 private:
 	std::string _name;
-	stream::FileInputStream _istream;
-	stream::SubFileInputStream _substream;	// provides a subset of _istream
+	ArchiveFileStream _substream;	// provides the compressed data from the archive
 	DeflatedInputStream _zipstream; // inflates data from _subStream
-	stream::FileInputStream::size_type _size;
+	ArchiveFileStream::size_type _size;
 
 public:
-	typedef stream::FileInputStream::size_type size_type;
-	typedef stream::FileInputStream::position_type position_type;
+	typedef ArchiveFileStream::size_type size_type;
+	typedef ArchiveFileStream::position_type position_type;
 
 	DeflatedArchiveFile(const std::string& name,
-						const std::string& archiveName, // path to the ZIP file
+						const ArchiveFileHandlePtr& archiveFile, // the shared handle of the ZIP file
 						position_type position,
 						size_type stream_size,
-						size_type file_size) :
+						size_type file_size,
+						size_type bufferSize) :
 		_name(name),
-		_istream(archiveName),
-		_substream(_istream, position, stream_size),
-		_zipstream(_substream), 
+		_substream(archiveFile, position, stream_size),
+		_zipstream(_substream, stream_size, file_size, bufferSize),
 		_size(file_size)
 	{}
 
@@ -3,6 +3,8 @@
 #include "iarchive.h"
 #include "iregistry.h"
 #include "stream/BinaryToTextInputStream.h"
+#include "ArchiveFileHandle.h"
+#include "DeflatedInputStream.h"
 
 namespace archive
 {
@@ -15,8 +17,7 @@ class DeflatedArchiveTextFile :
 {
 private:
 	std::string _name;
-	stream::FileInputStream _istream;
-	stream::SubFileInputStream _substream;	// reads subset of _istream
+	ArchiveFileStream _substream;	// provides the compressed data from the archive
 	DeflatedInputStream _zipstream;	// inflates data from _substream
 	stream::BinaryToTextInputStream<DeflatedInputStream> _textStream; // converts data from _zipstream
 
@@ -24,8 +25,8 @@ private:
     const std::string _modRoot;
 
 public:
-	typedef stream::FileInputStream::size_type size_type;
-	typedef stream::FileInputStream::position_type position_type;
+	typedef ArchiveFileStream::size_type size_type;
+	typedef ArchiveFileStream::position_type position_type;
 
     /**
      * Constructor.
@@ -34,14 +35,15 @@ public:
      * The name of the mod directory this file's archive is located in.
      */
     DeflatedArchiveTextFile(const std::string& name,
-                            const std::string& archiveName, // full path to ZIP file
+                            const ArchiveFileHandlePtr& archiveFile, // shared handle of the ZIP file
                             const std::string& modRoot,
                             position_type position,
-                            size_type stream_size) : 
+                            size_type stream_size,
+                            size_type file_size,
+                            size_type bufferSize) : 
 		_name(name),
-		_istream(archiveName),
-		_substream(_istream, position, stream_size),
-		_zipstream(_substream),
+		_substream(archiveFile, position, stream_size),
+		_zipstream(_substream, stream_size, file_size, bufferSize),
 		_textStream(_zipstream),
 		_modRoot(modRoot)
     {}
@@ -1,13 +1,18 @@
 #include "DeflatedInputStream.h"
 
+#include <algorithm>
 #include <zlib.h>
 
 namespace archive
 {
 
-DeflatedInputStream::DeflatedInputStream(InputStream& istream) :
+DeflatedInputStream::DeflatedInputStream(InputStream& istream, size_type compressedSize,
+	size_type uncompressedSize, size_type bufferSize) :
 	_istream(istream),
-	_zipStream(new z_stream)
+	_zipStream(new z_stream),
+	_buffer(std::max<size_type>(std::min(bufferSize, compressedSize), 1)),
+	_compressedSize(compressedSize),
+	_uncompressedSize(uncompressedSize)
 {
 	_zipStream->zalloc = 0;
 	_zipStream->zfree = 0;
@@ -28,13 +33,25 @@ DeflatedInputStream::size_type DeflatedInputStream::read(byte_type* buffer, size
 	_zipStream->next_out = buffer;
 	_zipStream->avail_out = static_cast<uInt>(length);
 
+	if (_zipStream->total_in == 0 && _zipStream->avail_in == 0 &&
+		length >= _uncompressedSize && _compressedSize <= _buffer.size())
+	{
+		// Fast path: load the whole entry and inflate it at once
+		_zipStream->next_in = _buffer.data();
+		_zipStream->avail_in = static_cast<uInt>(_istream.read(_buffer.data(), _compressedSize));
+
+		inflate(_zipStream.get(), Z_FINISH);
+
+		return length - _zipStream->avail_out;
+	}
+
 	while (_zipStream->avail_out != 0)
 	{
 		if (_zipStream->avail_in == 0)
 		{
 			// Load some data from the wrapped buffer and point z_stream to it
-			_zipStream->next_in = _buffer;
-			_zipStream->avail_in = static_cast<uInt>(_istream.read(_buffer, sizeof(_buffer)));
+			_zipStream->next_in = _buffer.data();
+			_zipStream->avail_in = static_cast<uInt>(_istream.read(_buffer.data(), _buffer.size()));
 		}
 
 		if (inflate(_zipStream.get(), Z_SYNC_FLUSH) != Z_OK)
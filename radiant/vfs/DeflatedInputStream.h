@@ -2,6 +2,7 @@
 
 #include "idatastream.h"
 #include <memory>
+#include <vector>
 
 // Forward decl.
 struct z_stream_s;
@@ -14,16 +15,26 @@ namespace archive
 ///
 /// - Uses z_stream to decompress the data stream on the fly.
 /// - Uses a buffer to reduce the number of times the wrapped stream must be read.
+/// - If the whole entry is requested in one go and its compressed data fits into
+///   the buffer, it is read and inflated with a single call each.
 class DeflatedInputStream :
 	public InputStream
 {
 private:
 	InputStream& _istream;
 	std::unique_ptr<z_stream> _zipStream;
-	unsigned char _buffer[1024];
+	std::vector<unsigned char> _buffer;
+
+	size_type _compressedSize;
+	size_type _uncompressedSize;
 
 public:
-	DeflatedInputStream(InputStream& istream);
+	static const size_type DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+	// The wrapped stream provides <compressedSize> bytes, inflating to <uncompressedSize>.
+	// The buffer won't be larger than the compressed data.
+	DeflatedInputStream(InputStream& istream, size_type compressedSize,
+		size_type uncompressedSize, size_type bufferSize = DEFAULT_BUFFER_SIZE);
 
 	virtual ~DeflatedInputStream();
 
@@ -37,6 +37,7 @@
 #include "DirectoryArchiveTextFile.h"
 #include "SortedFilenames.h"
 #include "ZipArchive.h"
+#include "ArchiveManifest.h"
 #include "modulesystem/StaticModule.h"
 
 namespace vfs
@@ -235,6 +236,36 @@ public:
 
 }
 
+ArchivePtr Doom3FileSystem::createPakArchive(const std::string& filename, ArchiveManifest* manifest)
+{
+    if (!manifest)
+    {
+        return std::make_shared<archive::ZipArchive>(filename, _archiveReadBufferSize);
+    }
+
+    std::uint64_t size = 0;
+    std::int64_t modificationTime = 0;
+
+    const archive::ZipArchive::FileList* files = manifest->findFileList(filename, size, modificationTime);
+
+    if (files)
+    {
+        // Unchanged since the last run, the pak file will be opened on first access
+        return std::make_shared<archive::ZipArchive>(filename, *files, _archiveReadBufferSize);
+    }
+
+    auto archive = std::make_shared<archive::ZipArchive>(filename, _archiveReadBufferSize);
+    archive::ZipArchive::FileList fileList = archive->getFileList();
+
+    // Don't remember anything about pak files which couldn't be read
+    if (!fileList.empty())
+    {
+        manifest->setFileList(filename, size, modificationTime, std::move(fileList));
+    }
+
+    return archive;
+}
+
 void Doom3FileSystem::initDirectory(const std::string& inputPath)
 {
     // greebo: Normalise path: Replace backslashes and ensure trailing slash
@@ -276,11 +307,24 @@ void Doom3FileSystem::initDirectory(const std::string& inputPath)
 
     rMessage() << "[vfs] Searched directory: " << path << std::endl;
 
+    // The table of contents of the pak files in this path, as found on the last run
+    std::unique_ptr<ArchiveManifest> manifest;
+
+    if (!_manifestFolder.empty())
+    {
+        manifest.reset(new ArchiveManifest(_manifestFolder, path));
+    }
+
     // add the entries to the vfs
     for (const std::string& filename : filenameList)
     {
         // Assemble the filename and try to load the archive
-        initPakFile(path + filename);
+        initPakFile(path + filename, manifest.get());
+    }
+
+    if (manifest)
+    {
+        manifest->save();
     }
 }
 
@@ -319,6 +363,8 @@ void Doom3FileSystem::initialise(const SearchPaths& vfsSearchPaths, const Extens
         initDirectory(path);
     }
 
+    buildFileIndex();
+
     for (Observer* observer : _observers)
     {
         observer->onFileSystemInitialise();
@@ -333,6 +379,7 @@ void Doom3FileSystem::shutdown()
     }
 
     _archives.clear();
+    _fileIndex.clear();
     _directories.clear();
     _vfsSearchPaths.clear();
     _allowedExtensions.clear();
@@ -351,14 +398,92 @@ void Doom3FileSystem::removeObserver(Observer& observer)
     _observers.erase(&observer);
 }
 
+void Doom3FileSystem::buildFileIndex()
+{
+    ScopedDebugTimer timer("[vfs] Building file index");
+
+    // Collects the files of a single pak file
+    class IndexBuilder :
+        public Archive::Visitor
+    {
+    private:
+        FileIndex& _index;
+        std::size_t _archiveIndex;
+
+    public:
+        IndexBuilder(FileIndex& index, std::size_t archiveIndex) :
+            _index(index),
+            _archiveIndex(archiveIndex)
+        {}
+
+        void visitFile(const std::string& name) override
+        {
+            auto result = _index.emplace(string::to_lower_copy(name), IndexEntry{ _archiveIndex, 0 });
+
+            // Earlier pak files take precedence, just count this one,
+            // unless the same name appears more than once in this archive
+            if (result.second || result.first->second.archiveIndex != _archiveIndex)
+            {
+                result.first->second.pakFileCount++;
+            }
+        }
+
+        bool visitDirectory(const std::string& name, std::size_t depth) override
+        {
+            return false; // traverse everything
+        }
+    };
+
+    for (std::size_t i = 0; i < _archives.size(); ++i)
+    {
+        if (_archives[i].is_pakfile)
+        {
+            IndexBuilder builder(_fileIndex, i);
+            _archives[i].archive->traverse(builder, "");
+        }
+    }
+
+    rMessage() << "[vfs] Indexed " << _fileIndex.size() << " files in pak files." << std::endl;
+}
+
+void Doom3FileSystem::foreachCandidateArchive(const std::string& filename,
+    const std::function<bool(const ArchiveDescriptor&)>& func)
+{
+    auto found = _fileIndex.find(string::to_lower_copy(filename));
+
+    // Without a pak file holding this file, only the directories need to be checked
+    std::size_t start = found != _fileIndex.end() ? found->second.archiveIndex : _archives.size();
+
+    for (std::size_t i = 0; i < start; ++i)
+    {
+        if (!_archives[i].is_pakfile && func(_archives[i]))
+        {
+            return;
+        }
+    }
+
+    // The pak file might fail to provide the file (a damaged entry or an unsupported
+    // compression method), fall back to the archives of lower precedence then
+    for (std::size_t i = start; i < _archives.size(); ++i)
+    {
+        if (func(_archives[i]))
+        {
+            return;
+        }
+    }
+}
+
 int Doom3FileSystem::getFileCount(const std::string& filename)
 {
-    int count = 0;
     std::string fixedFilename(os::standardPath(filename));
 
+    auto found = _fileIndex.find(string::to_lower_copy(fixedFilename));
+    int count = found != _fileIndex.end() ? static_cast<int>(found->second.pakFileCount) : 0;
+
+    // Physical directories are not indexed
     for (const ArchiveDescriptor& descriptor : _archives)
     {
-        if (descriptor.archive->containsFile(fixedFilename))
+        if (!descriptor.is_pakfile && descriptor.archive->containsFile(fixedFilename))
         {
             ++count;
         }
@@ -375,18 +500,15 @@ ArchiveFilePtr Doom3FileSystem::openFile(const std::string& filename)
         return ArchiveFilePtr();
     }
 
-    for (const ArchiveDescriptor& descriptor : _archives)
-    {
-        ArchiveFilePtr file = descriptor.archive->openFile(filename);
+    ArchiveFilePtr file;
 
-        if (file)
-        {
-            return file;
-        }
-    }
+    foreachCandidateArchive(filename, [&](const ArchiveDescriptor& descriptor)
+    {
+        file = descriptor.archive->openFile(filename);
+        return file != nullptr;
+    });
 
-    // not found
-    return ArchiveFilePtr();
+    return file;
 }
 
 ArchiveFilePtr Doom3FileSystem::openFileInAbsolutePath(const std::string& filename)
@@ -404,17 +526,15 @@ ArchiveFilePtr Doom3FileSystem::openFileInAbsolutePath(const std::string& filena
 
 ArchiveTextFilePtr Doom3FileSystem::openTextFile(const std::string& filename)
 {
-    for (const ArchiveDescriptor& descriptor : _archives)
-    {
-        ArchiveTextFilePtr file = descriptor.archive->openTextFile(filename);
+    ArchiveTextFilePtr file;
 
-        if (file)
-        {
-            return file;
-        }
-    }
+    foreachCandidateArchive(filename, [&](const ArchiveDescriptor& descriptor)
+    {
+        file = descriptor.archive->openTextFile(filename);
+        return file != nullptr;
+    });
 
-    return ArchiveTextFilePtr();
+    return file;
 }
 
 ArchiveTextFilePtr Doom3FileSystem::openTextFileInAbsolutePath(const std::string& filename)
@@ -494,7 +614,7 @@ std::string Doom3FileSystem::findRoot(const std::string& name)
     return std::string();
 }
 
-void Doom3FileSystem::initPakFile(const std::string& filename)
+void Doom3FileSystem::initPakFile(const std::string& filename, ArchiveManifest* manifest)
 {
     std::string fileExt = string::to_lower_copy(os::getExtension(filename));
 
@@ -504,7 +624,7 @@ void Doom3FileSystem::initPakFile(const std::string& filename)
         ArchiveDescriptor entry;
 
         entry.name = filename;
-        entry.archive = std::make_shared<archive::ZipArchive>(filename);
+        entry.archive = createPakArchive(filename, manifest);
         entry.is_pakfile = true;
         _archives.push_back(entry);
 
@@ -525,6 +645,14 @@ void Doom3FileSystem::initPakFile(const std::string& filename)
     }
 }
 
+void Doom3FileSystem::setArchiveReadBufferSize(std::size_t size)
+{
+    if (size > 0)
+    {
+        _archiveReadBufferSize = size;
+    }
+}
+
 const SearchPaths& Doom3FileSystem::getVfsSearchPaths()
 {
     // Should not be called before the list is initialised
@@ -552,6 +680,8 @@ const StringSet& Doom3FileSystem::getDependencies() const
 void Doom3FileSystem::initialiseModule(const ApplicationContext& ctx)
 {
     rMessage() << getName() << "::initialiseModule called" << std::endl;
+
+    _manifestFolder = ctx.getSettingsPath() + "vfs/";
 }
 
 void Doom3FileSystem::shutdownModule()
@@ -559,4 +689,10 @@ void Doom3FileSystem::shutdownModule()
     shutdown();
 }
 
+bool Doom3FileSystem::isInitialisationThreadSafe() const
+{
+    // Nothing but our own state is touched during initialisation
+    return true;
+}
+
 }
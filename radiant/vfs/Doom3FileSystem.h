@@ -1,11 +1,17 @@
 #pragma once
 
 #include "Archive.h"
+#include "ZipArchive.h"
 #include "ifilesystem.h"
+#include <vector>
+#include <functional>
+#include <unordered_map>
 
 namespace vfs
 {
 
+class ArchiveManifest;
+
 class Doom3FileSystem :
 	public VirtualFileSystem
 {
@@ -24,12 +30,31 @@ private:
 		bool is_pakfile;
 	};
 
-	typedef std::list<ArchiveDescriptor> ArchiveList;
+	typedef std::vector<ArchiveDescriptor> ArchiveList;
 	ArchiveList _archives;
 
+	// The files found in the pak files, with the first (winning) pak file holding them
+	struct IndexEntry
+	{
+		std::size_t archiveIndex;	// position in _archives
+		std::size_t pakFileCount;	// the number of pak files holding this file
+	};
+
+	// Maps the lowercase VFS path to the entry. The pak files don't change
+	// while the VFS is running, so this is built once on initialisation.
+	// Physical directories are not indexed, they are checked on demand.
+	typedef std::unordered_map<std::string, IndexEntry> FileIndex;
+	FileIndex _fileIndex;
+
 	typedef std::set<Observer*> ObserverList;
 	ObserverList _observers;
 
+	// Folder holding the cached pak file contents, empty to disable the cache
+	std::string _manifestFolder;
+
+	// Read-ahead buffer size of the files opened from pak files
+	std::size_t _archiveReadBufferSize = archive::ZipArchive::DEFAULT_READ_BUFFER_SIZE;
+
 public:
 	void initialise(const SearchPaths& vfsSearchPaths, const ExtensionSet& allowedExtensions) override;
 	void shutdown() override;
@@ -59,15 +84,31 @@ public:
 
 	const SearchPaths& getVfsSearchPaths() override;
 
+	void setArchiveReadBufferSize(std::size_t size) override;
+
 	// RegisterableModule implementation
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
 	void initialiseModule(const ApplicationContext& ctx) override;
 	void shutdownModule() override;
+	bool isInitialisationThreadSafe() const override;
 
 private:
 	void initDirectory(const std::string& path);
-	void initPakFile(const std::string& filename);
+	void initPakFile(const std::string& filename, ArchiveManifest* manifest);
+
+	// Creates the archive of the given pak file, using or updating the cached
+	// table of contents in the given manifest (which may be null)
+	ArchivePtr createPakArchive(const std::string& filename, ArchiveManifest* manifest);
+
+	void buildFileIndex();
+
+	// Invokes the given function for each archive possibly containing the given file,
+	// in order of precedence, until the function returns true. These are the directories
+	// in front of the winning pak file (according to the index), the pak file itself,
+	// and all archives after it, in case the file can't be opened from the pak file.
+	void foreachCandidateArchive(const std::string& filename,
+		const std::function<bool(const ArchiveDescriptor&)>& func);
 };
 
 }
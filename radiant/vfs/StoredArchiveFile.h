@@ -1,6 +1,7 @@
 #pragma once
 
 #include "iarchive.h"
+#include "ArchiveFileHandle.h"
 
 namespace archive
 {
@@ -11,22 +12,25 @@ class StoredArchiveFile :
 {
 private:
 	std::string _name;
-	stream::FileInputStream _filestream;
-	stream::SubFileInputStream _substream;	// provides a subset of _filestream
-	stream::FileInputStream::size_type _size;
+	ArchiveFileHandlePtr _archiveFile;
+	ArchiveFileStream::position_type _position;
+	ArchiveFileStream _substream;	// provides the data from the archive
+	ArchiveFileStream::size_type _size;
 
 public:
-	typedef stream::FileInputStream::size_type size_type;
-	typedef stream::FileInputStream::position_type position_type;
+	typedef ArchiveFileStream::size_type size_type;
+	typedef ArchiveFileStream::position_type position_type;
 
 	StoredArchiveFile(const std::string& name,
-					  const std::string& archiveName, // full path to the archive file
+					  const ArchiveFileHandlePtr& archiveFile, // shared handle of the archive file
 					  position_type position,
 					  size_type stream_size,
-					  size_type file_size) : 
+					  size_type file_size,
+					  size_type bufferSize) : 
 		_name(name),
-		_filestream(archiveName),
-		_substream(_filestream, position, stream_size),
+		_archiveFile(archiveFile),
+		_position(position),
+		_substream(archiveFile, position, stream_size, bufferSize),
 		_size(file_size)
 	{}
 
@@ -44,6 +48,19 @@ public:
 	{
 		return _substream;
 	}
+
+	// The data is viewed in place if the archive can be memory-mapped
+	const unsigned char* getData() override
+	{
+		const unsigned char* data = _archiveFile->getMappedData();
+
+		if (data == nullptr || _position + _size > _archiveFile->getMappedSize())
+		{
+			return nullptr;
+		}
+
+		return data + _position;
+	}
 };
 
 }
@@ -2,6 +2,7 @@
 
 #include "iarchive.h"
 #include "stream/BinaryToTextInputStream.h"
+#include "ArchiveFileHandle.h"
 
 namespace archive
 {
@@ -12,15 +13,14 @@ class StoredArchiveTextFile :
 {
 private:
 	std::string _name;
-	stream::FileInputStream _filestream;
-	stream::SubFileInputStream _substream; // provides a subset of _filestream
-	stream::BinaryToTextInputStream<stream::SubFileInputStream> _textStream; // converts data from _substream
+	ArchiveFileStream _substream; // provides the data from the archive
+	stream::BinaryToTextInputStream<ArchiveFileStream> _textStream; // converts data from _substream
 
 	// Mod root
 	std::string _modRoot;
 public:
-	typedef stream::FileInputStream::size_type size_type;
-	typedef stream::FileInputStream::position_type position_type;
+	typedef ArchiveFileStream::size_type size_type;
+	typedef ArchiveFileStream::position_type position_type;
 
 	/**
 	* Constructor.
@@ -29,13 +29,13 @@ public:
 	* Name of the mod directory containing this file.
 	*/
 	StoredArchiveTextFile(const std::string& name,
-						  const std::string& archiveName,
+						  const ArchiveFileHandlePtr& archiveFile,
 						  const std::string& modRoot,
 						  position_type position,
-						  size_type stream_size) : 
+						  size_type stream_size,
+						  size_type bufferSize) : 
 		_name(name),
-		_filestream(archiveName),
-		_substream(_filestream, position, stream_size),
+		_substream(archiveFile, position, stream_size, bufferSize),
 		_textStream(_substream),
 		_modRoot(modRoot)
 	{}
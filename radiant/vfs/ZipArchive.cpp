@@ -29,12 +29,14 @@ public:
 };
 
 
-ZipArchive::ZipArchive(const std::string& fullPath) :
+ZipArchive::ZipArchive(const std::string& fullPath, std::size_t readBufferSize) :
 	_fullPath(fullPath),
 	_containingFolder(os::standardPathWithSlash(fs::path(_fullPath).remove_filename())),
-	_istream(_fullPath)
+	_readBufferSize(readBufferSize)
 {
-	if (_istream.failed())
+	stream::FileInputStream istream(_fullPath);
+
+	if (istream.failed())
 	{
 		rError() << "Cannot open Zip file stream: " << _fullPath << std::endl;
 		return;
@@ -43,7 +45,7 @@ ZipArchive::ZipArchive(const std::string& fullPath) :
 	try
 	{
 		// Try loading the zip file, this will throw exceptoions on any problem
-		loadZipFile();
+		loadZipFile(istream);
 	}
 	catch (ZipFailureException& ex)
 	{
@@ -51,11 +53,86 @@ ZipArchive::ZipArchive(const std::string& fullPath) :
 	}
 }
 
+ZipArchive::ZipArchive(const std::string& fullPath, const FileList& fileList, std::size_t readBufferSize) :
+	_fullPath(fullPath),
+	_containingFolder(os::standardPathWithSlash(fs::path(_fullPath).remove_filename())),
+	_readBufferSize(readBufferSize)
+{
+	for (const FileEntry& entry : fileList)
+	{
+		if (entry.type == FileEntry::Directory)
+		{
+			_filesystem[entry.path].getRecord().reset();
+		}
+		else
+		{
+			_filesystem[entry.path].getRecord().reset(new ZipRecord(entry.position,
+				entry.compressedSize,
+				entry.uncompressedSize,
+				entry.type == FileEntry::Deflated ? ZipRecord::eDeflated : ZipRecord::eStored));
+		}
+	}
+}
+
 ZipArchive::~ZipArchive()
 {
 	_filesystem.clear();
 }
 
+ZipArchive::FileList ZipArchive::getFileList()
+{
+	FileList list;
+
+	for (ZipFileSystem::value_type& pair : _filesystem)
+	{
+		const std::shared_ptr<ZipRecord>& record = pair.second.getRecord();
+
+		if (record)
+		{
+			list.emplace_back(FileEntry{ pair.first.string(), record->position, record->stream_size, record->file_size,
+				record->mode == ZipRecord::eDeflated ? FileEntry::Deflated : FileEntry::Stored });
+		}
+		else
+		{
+			list.emplace_back(FileEntry{ pair.first.string(), 0, 0, 0, FileEntry::Directory });
+		}
+	}
+
+	return list;
+}
+
+ArchiveFileHandlePtr ZipArchive::getFileHandle()
+{
+	std::lock_guard<std::mutex> lock(_fileLock);
+
+	if (!_file)
+	{
+		_file = std::make_shared<ArchiveFileHandle>(_fullPath);
+	}
+
+	return _file;
+}
+
+bool ZipArchive::getDataPosition(const ArchiveFileHandlePtr& file, const ZipRecord& record,
+	ArchiveFileStream::position_type& position)
+{
+	// The header is followed by the filename and the extra field, up to 64k each.
+	// Buffer the fixed part, so that it's loaded with a single read.
+	ArchiveFileStream headerStream(file, record.position,
+		ZIP_FILE_HEADER_LENGTH + 2 * 0xffff, ZIP_FILE_HEADER_LENGTH);
+
+	ZipFileHeader header;
+	stream::readZipFileHeader(headerStream, header);
+
+	if (header.magic != ZIP_MAGIC_FILE_HEADER)
+	{
+		return false;
+	}
+
+	position = record.position + headerStream.tell();
+	return true;
+}
+
 ArchiveFilePtr ZipArchive::openFile(const std::string& name)
 {
 	ZipFileSystem::iterator i = _filesystem.find(name);
@@ -64,32 +141,30 @@ ArchiveFilePtr ZipArchive::openFile(const std::string& name)
 	{
 		const std::shared_ptr<ZipRecord>& file = i->second.getRecord();
 
-		stream::FileInputStream::size_type position = 0;
+		ArchiveFileHandlePtr archiveFile = getFileHandle();
 
+		if (archiveFile->failed())
 		{
-			// Guard against concurrent access
-			std::lock_guard<std::mutex> lock(_streamLock);
-
-			_istream.seek(file->position);
-
-			ZipFileHeader header;
-			stream::readZipFileHeader(_istream, header);
+			rError() << "Cannot open Zip file stream: " << _fullPath << std::endl;
+			return ArchiveFilePtr();
+		}
 
-			position = _istream.tell();
+		ArchiveFileStream::position_type position = 0;
 
-			if (header.magic != ZIP_MAGIC_FILE_HEADER)
-			{
-				rError() << "Error reading zip file " << _fullPath << std::endl;
-				return ArchiveFilePtr();
-			}
+		if (!getDataPosition(archiveFile, *file, position))
+		{
+			rError() << "Error reading zip file " << _fullPath << std::endl;
+			return ArchiveFilePtr();
 		}
 
 		switch (file->mode)
 		{
 		case ZipRecord::eStored:
-			return std::make_shared<StoredArchiveFile>(name, _fullPath, position, file->stream_size, file->file_size);
+			return std::make_shared<StoredArchiveFile>(name, archiveFile, position,
+				file->stream_size, file->file_size, _readBufferSize);
 		case ZipRecord::eDeflated:
-			return std::make_shared<DeflatedArchiveFile>(name, _fullPath, position, file->stream_size, file->file_size);
+			return std::make_shared<DeflatedArchiveFile>(name, archiveFile, position,
+				file->stream_size, file->file_size, _readBufferSize);
 		}
 	}
 
@@ -104,15 +179,17 @@ ArchiveTextFilePtr ZipArchive::openTextFile(const std::string& name)
 	{
 		const std::shared_ptr<ZipRecord>& file = i->second.getRecord();
 
-		// Guard against concurrent access
-		std::lock_guard<std::mutex> lock(_streamLock);
+		ArchiveFileHandlePtr archiveFile = getFileHandle();
 
-		_istream.seek(file->position);
+		if (archiveFile->failed())
+		{
+			rError() << "Cannot open Zip file stream: " << _fullPath << std::endl;
+			return ArchiveTextFilePtr();
+		}
 
-		ZipFileHeader header;
-		stream::readZipFileHeader(_istream, header);
+		ArchiveFileStream::position_type position = 0;
 
-		if (header.magic != ZIP_MAGIC_FILE_HEADER)
+		if (!getDataPosition(archiveFile, *file, position))
 		{
 			rError() << "Error reading zip file " << _fullPath << std::endl;
 			return ArchiveTextFilePtr();
@@ -122,12 +199,12 @@ ArchiveTextFilePtr ZipArchive::openTextFile(const std::string& name)
 		{
 		case ZipRecord::eStored:
 			return std::make_shared<StoredArchiveTextFile>(
-                name, _fullPath, _containingFolder, _istream.tell(), file->stream_size
+                name, archiveFile, _containingFolder, position, file->stream_size, _readBufferSize
             );
 
 		case ZipRecord::eDeflated:
 			return std::make_shared<DeflatedArchiveTextFile>(
-                name, _fullPath, _containingFolder, _istream.tell(), file->stream_size
+                name, archiveFile, _containingFolder, position, file->stream_size, file->file_size, _readBufferSize
             );
 		}
 	}
@@ -146,10 +223,10 @@ void ZipArchive::traverse(Visitor& visitor, const std::string& root)
 	_filesystem.traverse(visitor, root);
 }
 
-void ZipArchive::readZipRecord()
+void ZipArchive::readZipRecord(stream::FileInputStream& istream)
 {
 	ZipMagic magic;
-	stream::readZipMagic(_istream, magic);
+	stream::readZipMagic(istream, magic);
 
 	if (magic != ZIP_MAGIC_ROOT_DIR_ENTRY)
 	{
@@ -157,14 +234,14 @@ void ZipArchive::readZipRecord()
 	}
 
 	ZipVersion version_encoder;
-	stream::readZipVersion(_istream, version_encoder);
+	stream::readZipVersion(istream, version_encoder);
 	ZipVersion version_extract;
-	stream::readZipVersion(_istream, version_extract);
+	stream::readZipVersion(istream, version_extract);
 
 	//unsigned short flags =
-	stream::readLittleEndian<int16_t>(_istream);
+	stream::readLittleEndian<int16_t>(istream);
 	
-	uint16_t compression_mode = stream::readLittleEndian<uint16_t>(_istream);
+	uint16_t compression_mode = stream::readLittleEndian<uint16_t>(istream);
 
 	if (compression_mode != Z_DEFLATED && compression_mode != 0)
 	{
@@ -172,25 +249,25 @@ void ZipArchive::readZipRecord()
 	}
 
 	ZipDosTime dostime;
-	stream::readZipDosTime(_istream, dostime);
+	stream::readZipDosTime(istream, dostime);
 
 	//unsigned int crc32 =
-	stream::readLittleEndian<uint32_t>(_istream);
+	stream::readLittleEndian<uint32_t>(istream);
 	
-	uint32_t compressed_size = stream::readLittleEndian<uint32_t>(_istream);
-	uint32_t uncompressed_size = stream::readLittleEndian<uint32_t>(_istream);
-	uint16_t namelength = stream::readLittleEndian<uint16_t>(_istream);
-	uint16_t extras = stream::readLittleEndian<uint16_t>(_istream);
-	uint16_t comment = stream::readLittleEndian<uint16_t>(_istream);
+	uint32_t compressed_size = stream::readLittleEndian<uint32_t>(istream);
+	uint32_t uncompressed_size = stream::readLittleEndian<uint32_t>(istream);
+	uint16_t namelength = stream::readLittleEndian<uint16_t>(istream);
+	uint16_t extras = stream::readLittleEndian<uint16_t>(istream);
+	uint16_t comment = stream::readLittleEndian<uint16_t>(istream);
 
 	//unsigned short diskstart =
-	stream::readLittleEndian<uint16_t>(_istream);
+	stream::readLittleEndian<uint16_t>(istream);
 	//unsigned short filetype =
-	stream::readLittleEndian<uint16_t>(_istream);
+	stream::readLittleEndian<uint16_t>(istream);
 	//unsigned int filemode =
-	stream::readLittleEndian<uint32_t>(_istream);
+	stream::readLittleEndian<uint32_t>(istream);
 
-	uint32_t position = stream::readLittleEndian<uint32_t>(_istream);
+	uint32_t position = stream::readLittleEndian<uint32_t>(istream);
 
 	// greebo: Read the filename directly into a newly constructed std::string.
 
@@ -201,11 +278,11 @@ void ZipArchive::readZipRecord()
 
 	std::string path(namelength, '\0');
 
-	_istream.read(
+	istream.read(
 		reinterpret_cast<stream::FileInputStream::byte_type*>(const_cast<char*>(path.data())),
 		namelength);
 
-	_istream.seek(extras + comment, stream::FileInputStream::cur);
+	istream.seek(extras + comment, stream::FileInputStream::cur);
 
 	if (os::isDirectory(path))
 	{
@@ -229,30 +306,30 @@ void ZipArchive::readZipRecord()
 	}
 }
 
-void ZipArchive::loadZipFile()
+void ZipArchive::loadZipFile(stream::FileInputStream& istream)
 {
-	SeekableStream::position_type pos = findZipDiskTrailerPosition(_istream);
+	SeekableStream::position_type pos = findZipDiskTrailerPosition(istream);
 
 	if (pos == 0)
 	{
 		throw ZipFailureException("Unable to locate Zip disk trailer");
 	}
 
-	_istream.seek(pos);
+	istream.seek(pos);
 
 	ZipDiskTrailer trailer;
-	stream::readZipDiskTrailer(_istream, trailer);
+	stream::readZipDiskTrailer(istream, trailer);
 
 	if (trailer.magic != ZIP_MAGIC_DISK_TRAILER)
 	{
 		throw ZipFailureException("Invalid Zip Magic, maybe this is not a zip file?");
 	}
 
-	_istream.seek(trailer.rootseek);
+	istream.seek(trailer.rootseek);
 
 	for (unsigned short i = 0; i < trailer.entries; ++i)
 	{
-		readZipRecord();
+		readZipRecord(istream);
 	}
 }
 
@@ -3,7 +3,10 @@
 #include "iarchive.h"
 #include "GenericFileSystem.h"
 #include "stream/FileInputStream.h"
+#include "ArchiveFileHandle.h"
 #include <mutex>
+#include <memory>
+#include <vector>
 
 namespace archive
 {
@@ -20,6 +23,26 @@ namespace archive
 class ZipArchive :
 	public Archive
 {
+public:
+	// A file or directory entry of the archive's central directory,
+	// in a form that can be cached by the file system
+	struct FileEntry
+	{
+		enum Type
+		{
+			Stored = 0,
+			Deflated = 1,
+			Directory = 2,
+		};
+
+		std::string path;
+		uint32_t position;
+		uint32_t compressedSize;
+		uint32_t uncompressedSize;
+		Type type;
+	};
+	typedef std::vector<FileEntry> FileList;
+
 private:
 	class ZipRecord
 	{
@@ -51,13 +74,28 @@ private:
 	std::string _fullPath;			// the full path to the Zip file
 	std::string _containingFolder;  // the folder this Zip is located in
 	mutable std::string _modName;	// mod name, calculated based on the containing folder
-	stream::FileInputStream _istream;
-    std::mutex _streamLock;
+	// The handle shared by all files opened from this archive, created on first use
+	ArchiveFileHandlePtr _file;
+	std::mutex _fileLock;
+
+	// Read-ahead buffer size of the opened files
+	std::size_t _readBufferSize;
 
 public:
-	ZipArchive(const std::string& fullPath);
+	static const std::size_t DEFAULT_READ_BUFFER_SIZE = 64 * 1024;
+
+	// Opens the given file and reads its central directory
+	ZipArchive(const std::string& fullPath, std::size_t readBufferSize = DEFAULT_READ_BUFFER_SIZE);
+
+	// Constructs the archive from a previously read list of entries, this doesn't access the file
+	ZipArchive(const std::string& fullPath, const FileList& fileList,
+		std::size_t readBufferSize = DEFAULT_READ_BUFFER_SIZE);
+
 	virtual ~ZipArchive();
 
+	// Returns all entries of this archive, this list can be passed to the constructor above
+	FileList getFileList();
+
 	// Archive implementation
 	virtual ArchiveFilePtr openFile(const std::string& name) override;
 	virtual ArchiveTextFilePtr openTextFile(const std::string& name) override;
@@ -65,8 +103,16 @@ public:
 	void traverse(Visitor& visitor, const std::string& root) override;
 
 private:
-	void readZipRecord();
-	void loadZipFile();
+	// Returns the shared handle of the Zip file, opening it if necessary
+	ArchiveFileHandlePtr getFileHandle();
+
+	// Reads the local header of the given entry, returning the position of its data.
+	// Returns false if the header is invalid.
+	bool getDataPosition(const ArchiveFileHandlePtr& file, const ZipRecord& record,
+		ArchiveFileStream::position_type& position);
+
+	void readZipRecord(stream::FileInputStream& istream);
+	void loadZipFile(stream::FileInputStream& istream);
 };
 
 }
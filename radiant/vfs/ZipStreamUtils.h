@@ -72,6 +72,8 @@ struct ZipFileHeader
 								/* followed by extra field (of variable size) */
 };
 
+const std::size_t ZIP_FILE_HEADER_LENGTH = 30;
+
 /* B. data descriptor
 * the data descriptor exists only if bit 3 of z_flags is set. It is byte aligned
 * and immediately follows the last byte of compressed data. It is only used if
@@ -8,6 +8,7 @@
 #include "ientity.h"
 #include "igrid.h"
 #include "iuimanager.h"
+#include "iprofiler.h"
 
 #include "wxutil/MouseButton.h"
 #include "wxutil/GLWidget.h"
@@ -1545,6 +1546,7 @@ void XYWnd::onRender()
 	if (GlobalMainFrame().screenUpdatesEnabled())
 	{
         util::ScopedBoolLock drawLock(_drawing);
+		profile::ScopedSpan span("Ortho view frame", "render");
 
 		draw();
 	}